@@ -0,0 +1,123 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package compress
+
+import (
+	"bufio"
+	"bytes"
+	"go/ast"
+	"go/parser"
+	"go/token"
+	"os/exec"
+	"path/filepath"
+	"regexp"
+	"strconv"
+	"testing"
+)
+
+// hotBoundsChecks is the number of bounds checks that the compiler is expected
+// to leave in each of the hot decoding functions. The remaining checks are
+// either on data-dependent indexes (e.g., second-level prefix tables and the
+// tree selected by a context map) or on paths taken once per block. If a
+// change to the code or the compiler causes more checks to appear,
+// TestBoundsChecks fails so that they can be looked at.
+var hotBoundsChecks = map[string]map[string]int{
+	"internal/prefix": {
+		"(*Reader).TryReadSymbol": 0,
+		"(*Reader).ReadSymbol":    2,
+	},
+	"flate": {
+		"(*Reader).readBlock": 2,
+	},
+	"brotli": {
+		"(*Reader).readCommands":      16,
+		"(*bitReader).TryReadSymbol":  0,
+		"(*bitReader).TryReadCommand": 0,
+		"(*bitReader).ReadSymbol":     2,
+		"getLitContextID":             0,
+	},
+	"bzip2": {
+		"(*Reader).decodePrefix":            6,
+		"(*moveToFront).Decode":             0,
+		"(*burrowsWheelerTransform).Decode": 4,
+	},
+}
+
+var reBoundsCheck = regexp.MustCompile(`^(?:\./)?([^:\s]+\.go):(\d+):\d+: Found Is(?:Slice)?InBounds$`)
+
+// TestBoundsChecks compiles the decoders with bounds check diagnostics
+// enabled and verifies that no new checks appear in the hot loops.
+func TestBoundsChecks(t *testing.T) {
+	if testing.Short() {
+		t.Skip("skipping compilation of packages in short mode")
+	}
+	goBin, err := exec.LookPath("go")
+	if err != nil {
+		t.Skip("go tool not available")
+	}
+
+	for pkg, want := range hotBoundsChecks {
+		cmd := exec.Command(goBin, "build", "-gcflags=-d=ssa/check_bce/debug=1", "./"+pkg)
+		out, err := cmd.CombinedOutput()
+		if err != nil {
+			t.Errorf("%s: build error: %v\n%s", pkg, err, out)
+			continue
+		}
+
+		// Map each reported line to the function that encloses it.
+		got := make(map[string]int)
+		funcs := make(map[string][]*ast.FuncDecl)
+		fset := token.NewFileSet()
+		s := bufio.NewScanner(bytes.NewReader(out))
+		for s.Scan() {
+			m := reBoundsCheck.FindStringSubmatch(s.Text())
+			if m == nil {
+				continue
+			}
+			file := filepath.ToSlash(m[1])
+			line, _ := strconv.Atoi(m[2])
+			if _, ok := funcs[file]; !ok {
+				f, err := parser.ParseFile(fset, file, nil, 0)
+				if err != nil {
+					t.Fatalf("%s: parse error: %v", file, err)
+				}
+				for _, d := range f.Decls {
+					if fd, ok := d.(*ast.FuncDecl); ok {
+						funcs[file] = append(funcs[file], fd)
+					}
+				}
+			}
+			for _, fd := range funcs[file] {
+				if fset.Position(fd.Pos()).Line <= line && line <= fset.Position(fd.End()).Line {
+					got[funcName(fd)]++
+				}
+			}
+		}
+
+		for name, n := range want {
+			if got[name] > n {
+				t.Errorf("%s: %s has %d bounds checks, want at most %d", pkg, name, got[name], n)
+			} else if got[name] < n {
+				t.Logf("%s: %s has %d bounds checks, fewer than %d; consider lowering the limit", pkg, name, got[name], n)
+			}
+		}
+	}
+}
+
+// funcName returns the name of fd in the form "(*T).Method" or "Func".
+func funcName(fd *ast.FuncDecl) string {
+	if fd.Recv == nil || len(fd.Recv.List) == 0 {
+		return fd.Name.Name
+	}
+	switch t := fd.Recv.List[0].Type.(type) {
+	case *ast.StarExpr:
+		if id, ok := t.X.(*ast.Ident); ok {
+			return "(*" + id.Name + ")." + fd.Name.Name
+		}
+	case *ast.Ident:
+		return "(" + t.Name + ")." + fd.Name.Name
+	}
+	return fd.Name.Name
+}
@@ -0,0 +1,249 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package bgzf
+
+import (
+	"bytes"
+	"compress/gzip"
+	"io"
+	"io/ioutil"
+	"reflect"
+	"testing"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+func mustCompress(t *testing.T, input []byte, conf *WriterConfig) ([]byte, *Index) {
+	var bb bytes.Buffer
+	zw, err := NewWriter(&bb, conf)
+	if err != nil {
+		t.Fatalf("unexpected NewWriter error: %v", err)
+	}
+	for i := 0; i < len(input); i += 1 << 17 {
+		j := i + 1<<17
+		if j > len(input) {
+			j = len(input)
+		}
+		if _, err := zw.Write(input[i:j]); err != nil {
+			t.Fatalf("unexpected Write error: %v", err)
+		}
+	}
+	if err := zw.Close(); err != nil {
+		t.Fatalf("unexpected Close error: %v", err)
+	}
+	if zw.InputOffset != int64(len(input)) || zw.OutputOffset != int64(bb.Len()) {
+		t.Errorf("offsets = (%d, %d), want (%d, %d)", zw.InputOffset, zw.OutputOffset, len(input), bb.Len())
+	}
+	return bb.Bytes(), zw.Index()
+}
+
+func TestRoundTrip(t *testing.T) {
+	twain := testutil.MustLoadFile("../testdata/twain.txt")
+	random := testutil.MustLoadFile("../testdata/random.bin")
+	vectors := []struct {
+		name  string
+		input []byte
+	}{
+		{"Empty", nil},
+		{"Short", []byte("hello, world")},
+		{"Boundary", twain[:maxDataSize]},
+		{"Twain", twain},
+		{"Random", random},
+	}
+
+	for _, v := range vectors {
+		var want []byte
+		for _, conc := range []int{1, 3, 8} {
+			for _, lvl := range []int{NoCompression, BestSpeed, 0, BestCompression} {
+				output, _ := mustCompress(t, v.input, &WriterConfig{Level: lvl, Concurrency: conc})
+				if !bytes.HasSuffix(output, eofBlock) {
+					t.Errorf("%s: missing end-of-file block", v.name)
+				}
+				if lvl == 0 {
+					if want == nil {
+						want = output
+					} else if !bytes.Equal(output, want) {
+						t.Errorf("%s: output depends on concurrency %d", v.name, conc)
+					}
+				}
+
+				// Every block must fit within the maximum size.
+				r := bytes.NewReader(output)
+				for {
+					blk, _, err := readBlock(r, nil)
+					if err == io.EOF {
+						break
+					}
+					if err != nil {
+						t.Fatalf("%s: unexpected readBlock error: %v", v.name, err)
+					}
+					if len(blk) > MaxBlockSize {
+						t.Errorf("%s: block size %d exceeds maximum", v.name, len(blk))
+					}
+				}
+
+				// BGZF files are valid multi-member gzip files.
+				gr, err := gzip.NewReader(bytes.NewReader(output))
+				if err != nil {
+					t.Fatalf("%s: unexpected gzip.NewReader error: %v", v.name, err)
+				}
+				if got, err := ioutil.ReadAll(gr); err != nil || !bytes.Equal(got, v.input) {
+					t.Errorf("%s: gzip.Reader mismatch: %v", v.name, err)
+				}
+
+				zr, err := NewReader(bytes.NewReader(output), &ReaderConfig{Concurrency: 4 - conc%4})
+				if err != nil {
+					t.Fatalf("%s: unexpected NewReader error: %v", v.name, err)
+				}
+				got, err := ioutil.ReadAll(zr)
+				if err != nil || !bytes.Equal(got, v.input) {
+					t.Errorf("%s: Reader mismatch: %v", v.name, err)
+				}
+				if zr.InputOffset != int64(len(output)) || zr.OutputOffset != int64(len(v.input)) {
+					t.Errorf("%s: offsets = (%d, %d), want (%d, %d)",
+						v.name, zr.InputOffset, zr.OutputOffset, len(output), len(v.input))
+				}
+				if err := zr.Close(); err != nil {
+					t.Errorf("%s: unexpected Close error: %v", v.name, err)
+				}
+			}
+		}
+	}
+}
+
+func TestWriterZero(t *testing.T) {
+	// A zero-value Writer uses the default level without concurrency.
+	twain := testutil.MustLoadFile("../testdata/twain.txt")
+	want, _ := mustCompress(t, twain, &WriterConfig{Concurrency: 1})
+	var bb bytes.Buffer
+	var zw Writer
+	zw.Reset(&bb)
+	if _, err := zw.Write(twain); err != nil {
+		t.Fatalf("unexpected Write error: %v", err)
+	}
+	if err := zw.Close(); err != nil {
+		t.Fatalf("unexpected Close error: %v", err)
+	}
+	if !bytes.Equal(bb.Bytes(), want) {
+		t.Errorf("output mismatch: got %d bytes, want %d bytes", bb.Len(), len(want))
+	}
+}
+
+func TestReaderCorrupted(t *testing.T) {
+	input := testutil.MustLoadFile("../testdata/twain.txt")
+	output, _ := mustCompress(t, input, nil)
+
+	vectors := []struct {
+		name string
+		edit func([]byte) []byte
+	}{
+		{"Magic", func(b []byte) []byte { b[1] ^= 0xff; return b }},
+		{"BlockSize", func(b []byte) []byte { b[16] = 0; b[17] = 0; return b }},
+		{"Payload", func(b []byte) []byte { b[100] ^= 0x55; return b }},
+		{"Checksum", func(b []byte) []byte {
+			blk, _, _ := readBlock(bytes.NewReader(b), nil)
+			b[len(blk)-8] ^= 0x01
+			return b
+		}},
+		{"Truncated", func(b []byte) []byte { return b[:len(b)/2] }},
+	}
+	for _, v := range vectors {
+		for _, conc := range []int{1, 4} {
+			data := v.edit(append([]byte(nil), output...))
+			zr, _ := NewReader(bytes.NewReader(data), &ReaderConfig{Concurrency: conc})
+			if _, err := ioutil.ReadAll(zr); err == nil {
+				t.Errorf("%s: ReadAll() = nil, want error", v.name)
+			}
+			if err := zr.Close(); err == nil {
+				t.Errorf("%s: Close() = nil, want error", v.name)
+			}
+		}
+	}
+}
+
+func TestSeek(t *testing.T) {
+	input := testutil.MustLoadFile("../testdata/twain.txt")
+	output, idx := mustCompress(t, input, &WriterConfig{Concurrency: 2})
+
+	// The index built from the headers must match the one from the Writer.
+	idx2, err := BuildIndex(bytes.NewReader(output))
+	if err != nil {
+		t.Fatalf("unexpected BuildIndex error: %v", err)
+	}
+	if !reflect.DeepEqual(idx, idx2) {
+		t.Fatalf("BuildIndex mismatch:\ngot  %v\nwant %v", idx2.Entries, idx.Entries)
+	}
+	if n := len(idx.Entries); n < 2 || idx.Entries[n-1].RawOffset != int64(len(input)) {
+		t.Fatalf("index does not cover the input: %v", idx.Entries)
+	}
+
+	// The index must survive a round-trip through the .gzi format.
+	var bb bytes.Buffer
+	if n, err := idx.WriteTo(&bb); err != nil || n != int64(bb.Len()) {
+		t.Fatalf("WriteTo() = (%d, %v), want (%d, nil)", n, err, bb.Len())
+	}
+	idx3 := new(Index)
+	if n, err := idx3.ReadFrom(&bb); err != nil || n != int64(8+16*len(idx.Entries)) {
+		t.Fatalf("ReadFrom() = (%d, %v)", n, err)
+	}
+	if !reflect.DeepEqual(idx, idx3) {
+		t.Fatalf("ReadFrom mismatch:\ngot  %v\nwant %v", idx3.Entries, idx.Entries)
+	}
+	if _, err := new(Index).ReadFrom(bytes.NewReader(make([]byte, 7))); err == nil {
+		t.Errorf("ReadFrom(truncated) = nil, want error")
+	}
+
+	zr, _ := NewReader(bytes.NewReader(output), &ReaderConfig{Index: idx3, Concurrency: 3})
+	rand := testutil.NewRand(0)
+	buf := make([]byte, 1000)
+	for i := 0; i < 100; i++ {
+		var pos int64
+		switch i % 3 {
+		case 0:
+			pos = int64(rand.Intn(len(input)))
+			if _, err := zr.Seek(pos, io.SeekStart); err != nil {
+				t.Fatalf("Seek(%d, SeekStart) = %v", pos, err)
+			}
+		case 1:
+			cur, _ := zr.Seek(0, io.SeekCurrent)
+			pos = int64(rand.Intn(len(input)))
+			if got, err := zr.Seek(pos-cur, io.SeekCurrent); err != nil || got != pos {
+				t.Fatalf("Seek(%d, SeekCurrent) = (%d, %v), want %d", pos-cur, got, err, pos)
+			}
+		case 2:
+			pos = int64(len(input) - rand.Intn(len(input)))
+			if _, err := zr.Seek(pos-int64(len(input)), io.SeekEnd); err != nil {
+				t.Fatalf("Seek(%d, SeekEnd) = %v", pos-int64(len(input)), err)
+			}
+		}
+
+		// Record the virtual offset, read, and then seek back to it.
+		vo := zr.VirtualOffset()
+		want := input[pos:]
+		if len(want) > len(buf) {
+			want = want[:len(buf)]
+		}
+		for j := 0; j < 2; j++ {
+			n, err := io.ReadFull(zr, buf[:len(want)])
+			if err != nil || !bytes.Equal(buf[:n], want) {
+				t.Fatalf("read at %d (%v) mismatch: %v", pos, vo, err)
+			}
+			if err := zr.SeekVirtual(vo); err != nil {
+				t.Fatalf("SeekVirtual(%v) = %v", vo, err)
+			}
+		}
+	}
+
+	// Seeking to the end reports EOF.
+	if _, err := zr.Seek(0, io.SeekEnd); err != nil {
+		t.Fatalf("Seek(0, SeekEnd) = %v", err)
+	}
+	if n, err := zr.Read(buf); n != 0 || err != io.EOF {
+		t.Errorf("Read() = (%d, %v), want (0, EOF)", n, err)
+	}
+	if err := zr.SeekVirtual(MakeVirtualOffset(0, maxDataSize+1)); err == nil {
+		t.Errorf("SeekVirtual(beyond block) = nil, want error")
+	}
+}
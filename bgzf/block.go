@@ -0,0 +1,173 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package bgzf
+
+import (
+	"bufio"
+	"bytes"
+	"compress/flate"
+	"encoding/binary"
+	"hash/crc32"
+	"io"
+
+	dsflate "github.com/dsnet/compress/flate"
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// readBlock reads the next block from r into buf, which is reused if it has
+// enough capacity. It returns the block along with the offset of the DEFLATE
+// payload within it. It returns io.EOF only if r is empty.
+func readBlock(r io.Reader, buf []byte) (blk []byte, start int, err error) {
+	if cap(buf) < MaxBlockSize {
+		buf = make([]byte, MaxBlockSize)
+	}
+	blk = buf[:12]
+	if _, err := io.ReadFull(r, blk); err != nil {
+		return nil, 0, err
+	}
+	if blk[0] != 0x1f || blk[1] != 0x8b || blk[2] != 0x08 || blk[3] != 0x04 {
+		return nil, 0, errorf(errors.Corrupted, "invalid block header")
+	}
+
+	// Search the extra field for the BC subfield, which holds the block size.
+	xlen := int(binary.LittleEndian.Uint16(blk[10:]))
+	blk = blk[:12+xlen]
+	if _, err := io.ReadFull(r, blk[12:]); err != nil {
+		return nil, 0, unexpectedEOF(err)
+	}
+	bsize := -1
+	for extra := blk[12:]; len(extra) > 0; {
+		if len(extra) < 4 {
+			return nil, 0, errorf(errors.Corrupted, "invalid extra field")
+		}
+		slen := int(binary.LittleEndian.Uint16(extra[2:]))
+		if len(extra) < 4+slen {
+			return nil, 0, errorf(errors.Corrupted, "invalid extra field")
+		}
+		if extra[0] == 'B' && extra[1] == 'C' && slen == 2 {
+			bsize = int(binary.LittleEndian.Uint16(extra[4:])) + 1
+		}
+		extra = extra[4+slen:]
+	}
+	if bsize < 0 {
+		return nil, 0, errorf(errors.Corrupted, "missing block size")
+	}
+	if bsize < len(blk)+footerSize {
+		return nil, 0, errorf(errors.Corrupted, "invalid block size: %d", bsize)
+	}
+
+	start, blk = len(blk), blk[:bsize]
+	if _, err := io.ReadFull(r, blk[start:]); err != nil {
+		return nil, 0, unexpectedEOF(err)
+	}
+	return blk, start, nil
+}
+
+func unexpectedEOF(err error) error {
+	if err == io.EOF {
+		return io.ErrUnexpectedEOF
+	}
+	return err
+}
+
+// blockDecoder decompresses individual blocks.
+type blockDecoder struct {
+	zr *dsflate.Reader
+	br *bufio.Reader
+	rd bytes.Reader
+}
+
+// Decode decompresses blk, whose DEFLATE payload starts at start, and appends
+// the uncompressed data to buf[:0]. The checksum and size are verified.
+func (bd *blockDecoder) Decode(blk []byte, start int, buf []byte) ([]byte, error) {
+	payload, footer := blk[start:len(blk)-footerSize], blk[len(blk)-footerSize:]
+	crc := binary.LittleEndian.Uint32(footer[0:])
+	size := binary.LittleEndian.Uint32(footer[4:])
+	if size > MaxBlockSize {
+		return nil, errorf(errors.Corrupted, "invalid data size: %d", size)
+	}
+
+	bd.rd.Reset(payload)
+	if bd.zr == nil {
+		bd.br = bufio.NewReader(&bd.rd)
+		bd.zr, _ = dsflate.NewReader(bd.br, nil)
+	} else {
+		bd.br.Reset(&bd.rd)
+		bd.zr.Reset(bd.br)
+	}
+	if cap(buf) < int(size) {
+		buf = make([]byte, size)
+	}
+	buf = buf[:size]
+	if _, err := io.ReadFull(bd.zr, buf); err != nil {
+		if err == io.EOF || err == io.ErrUnexpectedEOF {
+			return nil, errorf(errors.Corrupted, "data size mismatch")
+		}
+		return nil, errWrap(err, errors.Corrupted)
+	}
+	var b [1]byte
+	if n, err := bd.zr.Read(b[:]); n > 0 || err != io.EOF {
+		if err == nil || err == io.EOF {
+			return nil, errorf(errors.Corrupted, "data size mismatch")
+		}
+		return nil, errWrap(err, errors.Corrupted)
+	}
+	if bd.zr.InputOffset != int64(len(payload)) {
+		return nil, errorf(errors.Corrupted, "trailing data after compressed stream")
+	}
+	if crc32.ChecksumIEEE(buf) != crc {
+		return nil, errorf(errors.Corrupted, "mismatching checksum")
+	}
+	return buf, nil
+}
+
+// blockEncoder compresses data into individual blocks.
+type blockEncoder struct {
+	zw  *flate.Writer
+	lvl int
+	buf bytes.Buffer
+}
+
+// Encode compresses data, which must be no longer than maxDataSize, as a
+// complete block and returns it. The result is only valid until the next call
+// to Encode.
+func (be *blockEncoder) Encode(data []byte, lvl int) ([]byte, error) {
+	var hdr [headerSize]byte
+	be.buf.Reset()
+	be.buf.Write(hdr[:])
+	if be.zw == nil || be.lvl != lvl {
+		zw, err := flate.NewWriter(&be.buf, lvl)
+		if err != nil {
+			return nil, errWrap(err, errors.Internal)
+		}
+		be.zw, be.lvl = zw, lvl
+	} else {
+		be.zw.Reset(&be.buf)
+	}
+	if _, err := be.zw.Write(data); err != nil {
+		return nil, errWrap(err, errors.Internal)
+	}
+	if err := be.zw.Close(); err != nil {
+		return nil, errWrap(err, errors.Internal)
+	}
+
+	// Fall back to a single stored block if the data is incompressible.
+	if be.buf.Len()+footerSize > MaxBlockSize {
+		be.buf.Truncate(headerSize)
+		n := uint16(len(data))
+		be.buf.Write([]byte{0x01, byte(n), byte(n >> 8), byte(^n), byte(^n >> 8)})
+		be.buf.Write(data)
+	}
+
+	var ftr [footerSize]byte
+	binary.LittleEndian.PutUint32(ftr[0:], crc32.ChecksumIEEE(data))
+	binary.LittleEndian.PutUint32(ftr[4:], uint32(len(data)))
+	be.buf.Write(ftr[:])
+
+	blk := be.buf.Bytes()
+	copy(blk, eofBlock[:16]) // Same header, except for the block size
+	binary.LittleEndian.PutUint16(blk[16:], uint16(len(blk)-1))
+	return blk, nil
+}
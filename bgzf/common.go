@@ -0,0 +1,100 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+// Package bgzf implements the Blocked GNU Zip Format (BGZF).
+//
+// A BGZF file is a series of concatenated gzip members (RFC 1952), called
+// blocks, each of which is at most 64KiB when compressed. Every block carries
+// its own compressed size in a "BC" extra field, so that blocks can be located
+// without decompressing them. Since every block is compressed independently,
+// a BGZF file can be decompressed in parallel and supports random access via
+// virtual offsets. Any gzip decoder can read a BGZF file.
+//
+// Format specification (section 4.1):
+//
+//	https://samtools.github.io/hts-specs/SAMv1.pdf
+package bgzf
+
+import (
+	"fmt"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// Writer configuration constants. The values can be set in WriterConfig and
+// passed to NewWriter to provide finer granularity control.
+const (
+	// Compression levels to be used with the underlying DEFLATE compressor.
+	NoCompression      = -1
+	BestSpeed          = 1
+	DefaultCompression = 6
+	BestCompression    = 9
+)
+
+const (
+	// MaxBlockSize is the maximum size of a compressed block.
+	MaxBlockSize = 1 << 16
+
+	// maxDataSize is the amount of uncompressed data stored in each block.
+	// This is chosen to match other implementations, and ensures that the
+	// block still fits within MaxBlockSize if the data is incompressible.
+	maxDataSize = 0xff00
+
+	headerSize = 18 // Size of the gzip header with only the BC extra field
+	footerSize = 8  // Size of the CRC-32 and ISIZE fields
+)
+
+// eofBlock is an empty block that marks the end of a BGZF file.
+var eofBlock = []byte{
+	0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x06, 0x00,
+	'B', 'C', 0x02, 0x00, 0x1b, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00,
+}
+
+// A VirtualOffset identifies a position in the uncompressed data of a BGZF
+// file. The upper 48 bits hold the offset of the start of a block in the
+// compressed file, and the lower 16 bits hold the offset within the
+// uncompressed data of that block.
+type VirtualOffset uint64
+
+// MakeVirtualOffset returns the virtual offset for the byte at dataOffset
+// within the uncompressed data of the block starting at blockOffset.
+func MakeVirtualOffset(blockOffset int64, dataOffset int) VirtualOffset {
+	return VirtualOffset(blockOffset)<<16 | VirtualOffset(uint16(dataOffset))
+}
+
+// BlockOffset reports the offset of the block in the compressed file.
+func (vo VirtualOffset) BlockOffset() int64 { return int64(vo >> 16) }
+
+// DataOffset reports the offset within the uncompressed data of the block.
+func (vo VirtualOffset) DataOffset() int { return int(vo & 0xffff) }
+
+func (vo VirtualOffset) String() string {
+	return fmt.Sprintf("%d:%d", vo.BlockOffset(), vo.DataOffset())
+}
+
+func errorf(c int, f string, a ...interface{}) error {
+	return errors.Error{Code: c, Pkg: "bgzf", Msg: fmt.Sprintf(f, a...)}
+}
+
+// errWrap converts a lower-level errors.Error to be one from this package.
+// The replaceCode passed in will be used to replace the code for any errors
+// with the errors.Invalid code.
+//
+// For the Reader, set this to errors.Corrupted.
+// For the Writer, set this to errors.Internal.
+func errWrap(err error, replaceCode int) error {
+	if cerr, ok := err.(errors.Error); ok {
+		if errors.IsInvalid(cerr) {
+			cerr.Code = replaceCode
+		}
+		err = errorf(cerr.Code, "%s", cerr.Msg)
+	}
+	return err
+}
+
+var (
+	errCorrupted = errorf(errors.Corrupted, "")
+	errClosed    = errorf(errors.Closed, "")
+)
@@ -0,0 +1,133 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package bgzf
+
+import (
+	"bufio"
+	"encoding/binary"
+	"io"
+	"sort"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// An Index maps uncompressed offsets to the blocks that contain them.
+// Its binary form is the .gzi file format used by other BGZF implementations.
+type Index struct {
+	// Entries holds the offsets of the start of every block that follows a
+	// block with data, in increasing order. The starting entry {0, 0} is not
+	// included since it is implied. When the index covers a whole file, the
+	// last entry holds the total uncompressed size.
+	Entries []IndexEntry
+}
+
+// IndexEntry records where a block starts.
+type IndexEntry struct {
+	CompOffset int64 // Offset of the block in the compressed file
+	RawOffset  int64 // Offset of the block's data in the uncompressed data
+}
+
+// BuildIndex creates an index for the BGZF file read from r. Only the block
+// headers and footers are inspected; no data is decompressed.
+func BuildIndex(r io.Reader) (*Index, error) {
+	var idx Index
+	var buf []byte
+	var last IndexEntry
+	for {
+		blk, _, err := readBlock(r, buf)
+		if err == io.EOF {
+			return &idx, nil
+		}
+		if err != nil {
+			return nil, errWrap(err, errors.Corrupted)
+		}
+		buf = blk
+		size := binary.LittleEndian.Uint32(blk[len(blk)-4:])
+		last.CompOffset += int64(len(blk))
+		last.RawOffset += int64(size)
+		if size > 0 {
+			idx.Entries = append(idx.Entries, last)
+		}
+	}
+}
+
+// Search returns the entry for the block that contains the byte at the given
+// uncompressed offset. If offset is at or beyond the end of the data that the
+// index covers, then the last entry is returned.
+func (idx *Index) Search(offset int64) IndexEntry {
+	i := sort.Search(len(idx.Entries), func(i int) bool {
+		return idx.Entries[i].RawOffset > offset
+	})
+	if i == 0 {
+		return IndexEntry{}
+	}
+	return idx.Entries[i-1]
+}
+
+// rawOffset reports the uncompressed offset of the block that starts at the
+// given compressed offset, and whether the index has an entry for it.
+func (idx *Index) rawOffset(compOffset int64) (int64, bool) {
+	if compOffset == 0 {
+		return 0, true
+	}
+	i := sort.Search(len(idx.Entries), func(i int) bool {
+		return idx.Entries[i].CompOffset >= compOffset
+	})
+	if i < len(idx.Entries) && idx.Entries[i].CompOffset == compOffset {
+		return idx.Entries[i].RawOffset, true
+	}
+	return 0, false
+}
+
+// WriteTo writes the index in the .gzi format, which is the number of entries
+// followed by the compressed and uncompressed offset of each entry, all as
+// little-endian 64-bit integers.
+func (idx *Index) WriteTo(w io.Writer) (int64, error) {
+	bw := bufio.NewWriter(w)
+	var b [8]byte
+	binary.LittleEndian.PutUint64(b[:], uint64(len(idx.Entries)))
+	bw.Write(b[:])
+	for _, e := range idx.Entries {
+		binary.LittleEndian.PutUint64(b[:], uint64(e.CompOffset))
+		bw.Write(b[:])
+		binary.LittleEndian.PutUint64(b[:], uint64(e.RawOffset))
+		bw.Write(b[:])
+	}
+	n := int64(8 + 16*len(idx.Entries))
+	if err := bw.Flush(); err != nil {
+		return 0, err
+	}
+	return n, nil
+}
+
+// ReadFrom replaces the contents of the index with one read in the .gzi format.
+func (idx *Index) ReadFrom(r io.Reader) (int64, error) {
+	var b [16]byte
+	if _, err := io.ReadFull(r, b[:8]); err != nil {
+		return 0, unexpectedEOF(err)
+	}
+	cnt := binary.LittleEndian.Uint64(b[:8])
+	n := int64(8)
+
+	// The count is untrusted, so grow the entries as they are read.
+	entries := idx.Entries[:0]
+	var last IndexEntry
+	for i := uint64(0); i < cnt; i++ {
+		if _, err := io.ReadFull(r, b[:]); err != nil {
+			return n, unexpectedEOF(err)
+		}
+		n += 16
+		e := IndexEntry{
+			CompOffset: int64(binary.LittleEndian.Uint64(b[0:])),
+			RawOffset:  int64(binary.LittleEndian.Uint64(b[8:])),
+		}
+		if e.CompOffset <= last.CompOffset || e.RawOffset <= last.RawOffset {
+			return n, errorf(errors.Corrupted, "index entries out of order")
+		}
+		entries, last = append(entries, e), e
+	}
+	idx.Entries = entries
+	return n, nil
+}
@@ -0,0 +1,285 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package bgzf
+
+import (
+	"io"
+	"runtime"
+	"sync"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// A Reader is an io.Reader that decompresses a BGZF file. Blocks are read
+// ahead in batches and decompressed concurrently.
+//
+// If the underlying io.Reader is also an io.Seeker, then the Reader can seek to
+// virtual offsets with SeekVirtual. If an Index is also provided, then the
+// Reader is an io.ReadSeeker over the uncompressed data.
+type Reader struct {
+	InputOffset  int64 // Total number of bytes read from underlying io.Reader
+	OutputOffset int64 // Total number of bytes emitted from Read
+
+	rd   io.Reader
+	idx  *Index // Optional index for Seek
+	conc int    // Number of blocks to decompress concurrently
+	err  error  // Persistent error
+
+	blks   []readBlockState // Blocks of the current batch
+	nblk   int              // Number of blocks in the current batch
+	bi     int              // Index of the next block to emit in blks
+	blkOff int64            // Offset of the current block
+	blkEnd int64            // Offset of the block after the current block
+	blkLen int              // Uncompressed size of the current block
+	toRead []byte           // Uncompressed data ready to be emitted from Read
+}
+
+// readBlockState holds a single block of a batch.
+type readBlockState struct {
+	bd    blockDecoder
+	off   int64  // Offset of the block in the compressed file
+	raw   []byte // The compressed block
+	start int    // Offset of the DEFLATE payload within raw
+	data  []byte // The uncompressed data
+	err   error  // Error from decompressing this block
+}
+
+// ReaderConfig configures the Reader.
+// The zero value for any field uses the default value for that field type.
+type ReaderConfig struct {
+	// Concurrency is the maximum number of blocks to decompress in parallel.
+	// If zero, then runtime.GOMAXPROCS(0) is used.
+	Concurrency int
+
+	// Index is used by Seek to locate uncompressed offsets.
+	// The Reader does not modify the Index.
+	Index *Index
+
+	_ struct{} // Blank field to prevent unkeyed struct literals
+}
+
+// NewReader creates a new Reader reading the given reader.
+//
+// If conf is nil, then default configuration values are used. Reader copies
+// all configuration values as necessary and does not store conf.
+func NewReader(r io.Reader, conf *ReaderConfig) (*Reader, error) {
+	zr := new(Reader)
+	if conf != nil {
+		if conf.Concurrency < 0 {
+			return nil, errorf(errors.Invalid, "invalid concurrency: %d", conf.Concurrency)
+		}
+		zr.conc = conf.Concurrency
+		zr.idx = conf.Index
+	}
+	if zr.conc == 0 {
+		zr.conc = runtime.GOMAXPROCS(0)
+	}
+	zr.Reset(r)
+	return zr, nil
+}
+
+// Reset discards the Reader's state and makes it equivalent to the result
+// of a call to NewReader, but reading from r instead. Any configurations from
+// a prior call to NewReader will be preserved.
+//
+// This is used to reduce memory allocations.
+func (zr *Reader) Reset(r io.Reader) error {
+	*zr = Reader{
+		rd:   r,
+		idx:  zr.idx,
+		conc: zr.conc,
+		blks: zr.blks,
+	}
+	if zr.conc == 0 {
+		zr.conc = 1
+	}
+	if len(zr.blks) != zr.conc {
+		zr.blks = make([]readBlockState, zr.conc)
+	}
+	return nil
+}
+
+func (zr *Reader) Read(buf []byte) (int, error) {
+	for len(zr.toRead) == 0 {
+		if !zr.nextBlock() {
+			return 0, zr.err
+		}
+	}
+	cnt := copy(buf, zr.toRead)
+	zr.toRead = zr.toRead[cnt:]
+	zr.OutputOffset += int64(cnt)
+	return cnt, nil
+}
+
+// nextBlock advances to the next block in the batch, reading another batch if
+// necessary. It reports false if there are no more blocks, in which case the
+// persistent error is set.
+func (zr *Reader) nextBlock() bool {
+	if zr.bi == zr.nblk {
+		if zr.err != nil {
+			return false
+		}
+		zr.readBatch()
+		if zr.nblk == 0 {
+			return false
+		}
+	}
+	b := &zr.blks[zr.bi]
+	if b.err != nil {
+		zr.err = b.err
+		zr.nblk, zr.bi = 0, 0
+		return false
+	}
+	zr.bi++
+	zr.blkOff, zr.blkEnd, zr.blkLen = b.off, b.off+int64(len(b.raw)), len(b.data)
+	zr.toRead = b.data
+	return true
+}
+
+// readBatch reads up to conc blocks and decompresses them concurrently.
+// Any error reading the blocks is stored as the persistent error, which is
+// only reported after all of the blocks read before it have been emitted.
+func (zr *Reader) readBatch() {
+	zr.nblk, zr.bi = 0, 0
+	for zr.nblk < len(zr.blks) {
+		b := &zr.blks[zr.nblk]
+		raw, start, err := readBlock(zr.rd, b.raw)
+		if err != nil {
+			zr.err = errWrap(err, errors.Corrupted)
+			break
+		}
+		b.off, b.raw, b.start = zr.InputOffset, raw, start
+		zr.InputOffset += int64(len(raw))
+		zr.nblk++
+	}
+
+	if zr.nblk == 1 {
+		b := &zr.blks[0]
+		b.data, b.err = b.bd.Decode(b.raw, b.start, b.data)
+		return
+	}
+	var wg sync.WaitGroup
+	for i := range zr.blks[:zr.nblk] {
+		b := &zr.blks[i]
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			b.data, b.err = b.bd.Decode(b.raw, b.start, b.data)
+		}()
+	}
+	wg.Wait()
+}
+
+// VirtualOffset reports the virtual offset of the next byte to be read.
+func (zr *Reader) VirtualOffset() VirtualOffset {
+	if len(zr.toRead) == 0 {
+		return MakeVirtualOffset(zr.blkEnd, 0)
+	}
+	return MakeVirtualOffset(zr.blkOff, zr.blkLen-len(zr.toRead))
+}
+
+// SeekVirtual moves to the given virtual offset, such that the next Read
+// starts at that position. The underlying io.Reader must be an io.Seeker.
+func (zr *Reader) SeekVirtual(vo VirtualOffset) error {
+	if zr.err != nil && zr.err != io.EOF {
+		return zr.err
+	}
+	off, pos := vo.BlockOffset(), vo.DataOffset()
+
+	// As an optimization, use the current batch if it contains the block.
+	var ok bool
+	for i, b := range zr.blks[:zr.nblk] {
+		if b.off == off {
+			zr.bi = i
+			ok = zr.nextBlock()
+			break
+		}
+	}
+	if !ok {
+		rs, isSeeker := zr.rd.(io.Seeker)
+		if !isSeeker {
+			return errorf(errors.Invalid, "underlying reader is not an io.Seeker")
+		}
+		if _, err := rs.Seek(off, io.SeekStart); err != nil {
+			zr.err = err
+			return err
+		}
+		zr.InputOffset, zr.blkOff, zr.blkEnd, zr.blkLen = off, off, off, 0
+		zr.nblk, zr.bi, zr.toRead, zr.err = 0, 0, nil, nil
+		if !zr.nextBlock() && (zr.err != io.EOF || pos > 0) {
+			return unexpectedEOF(zr.err)
+		}
+	}
+	if pos > len(zr.toRead) {
+		zr.err = errorf(errors.Invalid, "virtual offset %v beyond end of block", vo)
+		return zr.err
+	}
+	zr.toRead = zr.toRead[pos:]
+	return nil
+}
+
+// Seek implements io.Seeker over the uncompressed data. It requires that an
+// Index was provided in ReaderConfig. When seeking relative to the end, the
+// index is assumed to cover the entire file.
+func (zr *Reader) Seek(offset int64, whence int) (int64, error) {
+	if zr.idx == nil {
+		return 0, errorf(errors.Invalid, "seeking requires an index")
+	}
+
+	var pos int64
+	switch whence {
+	case io.SeekStart:
+		pos = offset
+	case io.SeekCurrent:
+		vo := zr.VirtualOffset()
+		raw, ok := zr.idx.rawOffset(vo.BlockOffset())
+		if !ok {
+			return 0, errorf(errors.Invalid, "current block is missing from index")
+		}
+		pos = raw + int64(vo.DataOffset()) + offset
+	case io.SeekEnd:
+		var end int64
+		if n := len(zr.idx.Entries); n > 0 {
+			end = zr.idx.Entries[n-1].RawOffset
+		}
+		pos = end + offset
+	default:
+		return 0, errorf(errors.Invalid, "invalid whence: %d", whence)
+	}
+	if pos < 0 {
+		return 0, errorf(errors.Invalid, "negative position: %d", pos)
+	}
+
+	e := zr.idx.Search(pos)
+	if err := zr.SeekVirtual(MakeVirtualOffset(e.CompOffset, 0)); err != nil {
+		return 0, err
+	}
+	for discard := pos - e.RawOffset; discard > 0; {
+		if len(zr.toRead) == 0 {
+			if !zr.nextBlock() {
+				return 0, unexpectedEOF(zr.err)
+			}
+			continue
+		}
+		n := len(zr.toRead)
+		if int64(n) > discard {
+			n = int(discard)
+		}
+		zr.toRead = zr.toRead[n:]
+		discard -= int64(n)
+	}
+	return pos, nil
+}
+
+// Close ends the decompression stream.
+func (zr *Reader) Close() error {
+	zr.toRead = nil // Make sure future reads fail
+	zr.nblk, zr.bi = 0, 0
+	if zr.err == io.EOF || zr.err == errClosed {
+		zr.err = errClosed
+		return nil
+	}
+	return zr.err // Return the persistent error
+}
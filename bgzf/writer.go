@@ -0,0 +1,222 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package bgzf
+
+import (
+	"compress/flate"
+	"io"
+	"runtime"
+	"sync"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// A Writer is an io.Writer that compresses data as a BGZF file. The input is
+// split into blocks, which are compressed concurrently in batches and then
+// written out in order. Since block boundaries only depend on the input and
+// calls to Flush, the output is identical regardless of the concurrency used.
+type Writer struct {
+	InputOffset  int64 // Total number of bytes issued to Write
+	OutputOffset int64 // Total number of bytes written to underlying io.Writer
+
+	wr    io.Writer
+	level int   // The compression level (NoCompression or BestSpeed..BestCompression)
+	conc  int   // Number of blocks to compress concurrently
+	err   error // Persistent error
+
+	buf  []byte            // Pending input for the next batch
+	encs []writeBlockState // Encoder for each concurrent block
+	idx  Index             // Index of all blocks written so far
+}
+
+// writeBlockState holds a single block of a batch.
+type writeBlockState struct {
+	be  blockEncoder
+	blk []byte // The compressed block
+	err error  // Error from compressing this block
+}
+
+// WriterConfig configures the Writer.
+// The zero value for any field uses the default value for that field type.
+type WriterConfig struct {
+	// Underlying DEFLATE compression level.
+	Level int
+
+	// Concurrency is the maximum number of blocks to compress in parallel.
+	// If zero, then runtime.GOMAXPROCS(0) is used.
+	Concurrency int
+
+	_ struct{} // Blank field to prevent unkeyed struct literals
+}
+
+// NewWriter creates a new Writer writing to the given writer.
+// It is the caller's responsibility to call Close to complete the stream.
+//
+// If conf is nil, then default configuration values are used. Writer copies
+// all configuration values as necessary and does not store conf.
+func NewWriter(w io.Writer, conf *WriterConfig) (*Writer, error) {
+	var lvl, conc int
+	if conf != nil {
+		lvl = conf.Level
+		conc = conf.Concurrency
+	}
+	if lvl == 0 {
+		lvl = DefaultCompression
+	}
+	if lvl != NoCompression && (lvl < BestSpeed || lvl > BestCompression) {
+		return nil, errorf(errors.Invalid, "compression level: %d", lvl)
+	}
+	if conc == 0 {
+		conc = runtime.GOMAXPROCS(0)
+	}
+	if conc < 0 {
+		return nil, errorf(errors.Invalid, "concurrency: %d", conc)
+	}
+	zw := new(Writer)
+	zw.level = lvl
+	zw.conc = conc
+	zw.Reset(w)
+	return zw, nil
+}
+
+func (zw *Writer) Write(buf []byte) (int, error) {
+	if zw.err != nil {
+		return 0, zw.err
+	}
+
+	cnt := len(buf)
+	for len(buf) > 0 {
+		bufSize := zw.conc * maxDataSize
+		n := bufSize - len(zw.buf)
+		if n > len(buf) {
+			n = len(buf)
+		}
+		zw.buf = append(zw.buf, buf[:n]...)
+		buf = buf[n:]
+		if len(zw.buf) == bufSize {
+			if zw.err = zw.flush(); zw.err != nil {
+				return 0, zw.err
+			}
+		}
+	}
+	zw.InputOffset += int64(cnt)
+	return cnt, nil
+}
+
+// Flush compresses all pending data and writes it to the underlying writer.
+// Any partial block is written as a smaller block.
+func (zw *Writer) Flush() error {
+	if zw.err != nil {
+		return zw.err
+	}
+	zw.err = zw.flush()
+	return zw.err
+}
+
+// flush compresses the pending input as a batch of blocks, where only the
+// last block may be partial.
+func (zw *Writer) flush() error {
+	numBlks := (len(zw.buf) + maxDataSize - 1) / maxDataSize
+	if numBlks == 0 {
+		return nil
+	}
+
+	lvl := zw.level
+	if lvl == NoCompression {
+		lvl = flate.NoCompression
+	}
+	var wg sync.WaitGroup
+	for i := 0; i < numBlks; i++ {
+		data := zw.buf[i*maxDataSize:]
+		if len(data) > maxDataSize {
+			data = data[:maxDataSize]
+		}
+		ws := &zw.encs[i]
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			ws.blk, ws.err = ws.be.Encode(data, lvl)
+		}()
+	}
+	wg.Wait()
+
+	// Write out all blocks in order.
+	var rawOffset int64
+	if n := len(zw.idx.Entries); n > 0 {
+		rawOffset = zw.idx.Entries[n-1].RawOffset
+	}
+	for i := range zw.encs[:numBlks] {
+		ws := &zw.encs[i]
+		if ws.err != nil {
+			return ws.err
+		}
+		n, err := zw.wr.Write(ws.blk)
+		zw.OutputOffset += int64(n)
+		if err != nil {
+			return err
+		}
+		if i < numBlks-1 {
+			rawOffset += maxDataSize
+		} else {
+			rawOffset += int64(len(zw.buf) - i*maxDataSize)
+		}
+		zw.idx.Entries = append(zw.idx.Entries, IndexEntry{zw.OutputOffset, rawOffset})
+	}
+	zw.buf = zw.buf[:0]
+	return nil
+}
+
+// Index returns an index of the blocks written so far. After Close, it covers
+// the entire file and may be written out as a .gzi file.
+func (zw *Writer) Index() *Index {
+	return &Index{Entries: append([]IndexEntry(nil), zw.idx.Entries...)}
+}
+
+// Close compresses any pending data and writes the end-of-file marker block.
+func (zw *Writer) Close() error {
+	if zw.err == errClosed {
+		return nil
+	}
+	if zw.err != nil {
+		return zw.err
+	}
+	if zw.err = zw.flush(); zw.err != nil {
+		return zw.err
+	}
+	n, err := zw.wr.Write(eofBlock)
+	zw.OutputOffset += int64(n)
+	if err != nil {
+		zw.err = err
+		return err
+	}
+	zw.err = errClosed
+	return nil
+}
+
+// Reset discards the Writer's state and makes it equivalent to the result
+// of a call to NewWriter, but writes to w instead. Any configurations from
+// a prior call to NewWriter will be preserved.
+//
+// This is used to reduce memory allocations.
+func (zw *Writer) Reset(w io.Writer) error {
+	*zw = Writer{
+		wr:    w,
+		level: zw.level,
+		conc:  zw.conc,
+
+		buf:  zw.buf[:0],
+		encs: zw.encs,
+	}
+	if zw.level == 0 {
+		zw.level = DefaultCompression
+	}
+	if zw.conc == 0 {
+		zw.conc = 1
+	}
+	if len(zw.encs) != zw.conc {
+		zw.encs = make([]writeBlockState, zw.conc)
+	}
+	return nil
+}
@@ -8,6 +8,8 @@ import (
 	"bufio"
 	"io"
 
+	"github.com/dsnet/compress"
+	"github.com/dsnet/compress/internal"
 	"github.com/dsnet/compress/internal/errors"
 )
 
@@ -17,7 +19,8 @@ import (
 // Furthermore, the decoding of variable length codes in ReadSymbol, often
 // requires multiple passes before it knows the exact bit-length of the code.
 //
-// Thus, to improve performance, if the underlying byteReader is a bufio.Reader,
+// Thus, to improve performance, if the underlying byteReader is also a
+// compress.BufferedReader (such as bufio.Reader or compress.MappedReader),
 // then the bitReader will use the Peek and Discard methods to fill the internal
 // bit buffer with as many bits as possible, allowing the TryReadBits and
 // TryReadSymbol methods to often succeed on the first try.
@@ -33,10 +36,10 @@ type bitReader struct {
 	numBits uint   // Number of valid bits in bufBits
 	offset  int64  // Number of bytes read from the underlying io.Reader
 
-	// These fields are only used if rd is a bufio.Reader.
-	bufRd       *bufio.Reader
+	// These fields are only used if rd is a compress.BufferedReader.
+	bufRd       compress.BufferedReader
 	bufPeek     []byte // Buffer for the Peek data
-	discardBits int    // Number of bits to discard from bufio.Reader
+	discardBits int    // Number of bits to discard from bufRd
 	fedBits     uint   // Number of bits fed in last call to FeedBits
 
 	// Local copy of decoders to reduce memory allocations.
@@ -50,14 +53,14 @@ func (br *bitReader) Init(r io.Reader) {
 	} else {
 		br.rd = bufio.NewReader(r)
 	}
-	if brd, ok := br.rd.(*bufio.Reader); ok {
+	if brd, ok := br.rd.(compress.BufferedReader); ok {
 		br.bufRd = brd
 	}
 }
 
 // FlushOffset updates the read offset of the underlying byteReader.
-// If the byteReader is a bufio.Reader, then this calls Discard to update the
-// read offset.
+// If the byteReader is a compress.BufferedReader, then this calls Discard to
+// update the read offset.
 func (br *bitReader) FlushOffset() int64 {
 	if br.bufRd == nil {
 		return br.offset
@@ -78,11 +81,20 @@ func (br *bitReader) FlushOffset() int64 {
 	return br.offset
 }
 
+// BitsRead reports the total number of bits consumed from the underlying
+// byteReader.
+func (br *bitReader) BitsRead() int64 {
+	if br.bufRd == nil {
+		return 8*br.offset - int64(br.numBits)
+	}
+	return 8*br.offset + int64(br.discardBits) + int64(br.fedBits-br.numBits)
+}
+
 // FeedBits ensures that at least nb bits exist in the bit buffer.
-// If the underlying byteReader is a bufio.Reader, then this will fill the
-// bit buffer with as many bits as possible, relying on Peek and Discard to
-// properly advance the read offset. Otherwise, it will use ReadByte to fill the
-// buffer with just the right number of bits.
+// If the underlying byteReader is a compress.BufferedReader, then this will
+// fill the bit buffer with as many bits as possible, relying on Peek and
+// Discard to properly advance the read offset. Otherwise, it will use ReadByte
+// to fill the buffer with just the right number of bits.
 func (br *bitReader) FeedBits(nb uint) {
 	if br.bufRd != nil {
 		br.discardBits += int(br.fedBits - br.numBits)
@@ -109,6 +121,13 @@ func (br *bitReader) FeedBits(nb uint) {
 				}
 			}
 			cnt := int(64-br.numBits) / 8
+			if len(br.bufPeek) >= 8 {
+				u := internal.LoadUint64LE(br.bufPeek) << br.numBits
+				br.numBits += uint(cnt * 8)
+				br.bufBits |= u & (1<<br.numBits - 1) // Only keep whole bytes
+				br.bufPeek = br.bufPeek[cnt:]
+				break
+			}
 			if cnt > len(br.bufPeek) {
 				cnt = len(br.bufPeek)
 			}
@@ -194,10 +213,11 @@ func (br *bitReader) ReadPads() uint {
 //
 // This method is designed to be inlined for performance reasons.
 func (br *bitReader) TryReadSymbol(pd *prefixDecoder) (uint, bool) {
-	if br.numBits < uint(pd.minBits) || len(pd.chunks) == 0 {
+	chunks := pd.chunks
+	if br.numBits < uint(pd.minBits) || len(chunks) == 0 {
 		return 0, false
 	}
-	chunk := pd.chunks[uint32(br.bufBits)&pd.chunkMask]
+	chunk := chunks[int(br.bufBits)&(len(chunks)-1)] // len(chunks) is a power of two
 	nb := uint(chunk & prefixCountMask)
 	if nb > br.numBits || nb > uint(pd.chunkBits) {
 		return 0, false
@@ -207,20 +227,39 @@ func (br *bitReader) TryReadSymbol(pd *prefixDecoder) (uint, bool) {
 	return uint(chunk >> prefixCountBits), true
 }
 
+// TryReadCommand attempts to decode the next insert-and-copy command,
+// including the extra bits for the insert and copy lengths, using the contents
+// of the bit buffer alone. It returns the packed command and whether it
+// succeeded.
+//
+// This method is designed to be inlined for performance reasons.
+func (br *bitReader) TryReadCommand(cd *commandDecoder) (uint32, bool) {
+	chunk := cd.chunks[int(br.bufBits)&(len(cd.chunks)-1)]
+	nb := uint(chunk & commandCountMask)
+	if nb > br.numBits {
+		return 0, false
+	}
+	br.bufBits >>= nb
+	br.numBits -= nb
+	return chunk, true
+}
+
 // ReadSymbol reads the next prefix symbol using the provided prefixDecoder.
 func (br *bitReader) ReadSymbol(pd *prefixDecoder) uint {
-	if len(pd.chunks) == 0 {
+	chunks := pd.chunks
+	if len(chunks) == 0 {
 		errors.Panic(errInvalid) // Decode with empty tree
+		return 0                 // Unreachable, but proves that len(chunks) > 0
 	}
 
 	nb := uint(pd.minBits)
 	for {
 		br.FeedBits(nb)
-		chunk := pd.chunks[uint32(br.bufBits)&pd.chunkMask]
+		chunk := chunks[int(br.bufBits)&(len(chunks)-1)]
 		nb = uint(chunk & prefixCountMask)
 		if nb > uint(pd.chunkBits) {
-			linkIdx := chunk >> prefixCountBits
-			chunk = pd.links[linkIdx][uint32(br.bufBits>>pd.chunkBits)&pd.linkMask]
+			links := pd.links[chunk>>prefixCountBits]
+			chunk = links[int(br.bufBits>>pd.chunkBits)&(len(links)-1)]
 			nb = uint(chunk & prefixCountMask)
 		}
 		if nb <= br.numBits {
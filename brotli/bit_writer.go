@@ -4,29 +4,188 @@
 
 package brotli
 
-import "io"
+import (
+	"encoding/binary"
+	"io"
 
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// The bitWriter accumulates all output in memory until Flush is called.
+// This allows segments of a stream to be encoded concurrently into separate
+// bitWriters and then written out in order.
 type bitWriter struct {
 	wr     io.Writer
 	offset int64 // Number of bytes written to underlying io.Writer
+
+	bufBits uint64 // Buffer to hold some bits
+	numBits uint   // Number of valid bits in bufBits
+	buf     []byte // Complete bytes not yet written to wr
 }
 
 func (bw *bitWriter) Init(w io.Writer) {
+	*bw = bitWriter{wr: w, buf: bw.buf[:0]}
 	return
 }
 
+// Write writes bytes from buf.
+// The bit buffer must be byte-aligned.
 func (bw *bitWriter) Write(buf []byte) (int, error) {
-	return 0, nil
+	if bw.numBits%8 != 0 {
+		return 0, errUnaligned
+	}
+	bw.pushBits()
+	bw.buf = append(bw.buf, buf...)
+	return len(buf), nil
 }
 
+// WriteBits writes nb bits of val, where nb must be no more than 32.
 func (bw *bitWriter) WriteBits(val, nb uint) {
+	if bw.numBits > 32 {
+		bw.pushBits()
+	}
+	bw.bufBits |= uint64(val) << bw.numBits
+	bw.numBits += nb
 	return
 }
 
+// WritePads writes 0-7 zero bits to achieve byte-alignment.
 func (bw *bitWriter) WritePads() {
+	bw.numBits = (bw.numBits + 7) &^ 7
 	return
 }
 
 func (bw *bitWriter) WriteSymbol(pe *prefixEncoder, sym uint) {
+	chunk := pe.chunks[sym]
+	bw.WriteBits(uint(chunk>>prefixCountBits), uint(chunk&prefixCountMask))
+	return
+}
+
+// WriteOffset writes the extra bits for offset relative to rcs[sym].
+func (bw *bitWriter) WriteOffset(sym, offset uint, rcs []rangeCode) {
+	rc := rcs[sym]
+	bw.WriteBits(offset-uint(rc.base), uint(rc.bits))
 	return
 }
+
+// WritePrefixCode writes the prefix code according to RFC section 3.
+// The codes must be sorted by symbol and have the len field populated.
+func (bw *bitWriter) WritePrefixCode(codes []prefixCode, maxSyms uint) {
+	if len(codes) == 1 {
+		bw.writeSimplePrefixCode(codes, maxSyms)
+	} else {
+		bw.writeComplexPrefixCode(codes)
+	}
+}
+
+// writeSimplePrefixCode writes a single symbol prefix code according to
+// RFC section 3.4.
+func (bw *bitWriter) writeSimplePrefixCode(codes []prefixCode, maxSyms uint) {
+	bw.WriteBits(1, 2) // HSKIP
+	bw.WriteBits(0, 2) // NSYM-1
+	bw.WriteBits(uint(codes[0].sym), neededBits(uint32(maxSyms)))
+}
+
+// writeComplexPrefixCode writes the prefix code according to RFC section 3.5.
+// Runs of zero-length codes are encoded using repeat symbol 17, while all
+// trailing zero-length codes are implied by the completed prefix tree.
+func (bw *bitWriter) writeComplexPrefixCode(codes []prefixCode) {
+	// Convert code lengths into code-length symbols.
+	var clensArr [2 * maxNumAlphabetSyms]uint16 // Symbol and repeat extra
+	var clenCnts [len(complexLens)]uint32
+	clens := clensArr[:0]
+	var sym uint32
+	for _, c := range codes {
+		if n := c.sym - sym; n > 0 {
+			if n < 3 {
+				for ; n > 0; n-- {
+					clens = append(clens, 0)
+					clenCnts[0]++
+				}
+			} else {
+				// Consecutive repeat symbols form a base-8 count with the
+				// most-significant digit first.
+				i := len(clens)
+				for n -= 3; ; n-- {
+					clens = append(clens, uint16(n&7)<<8|17)
+					clenCnts[17]++
+					if n >>= 3; n == 0 {
+						break
+					}
+				}
+				for j := len(clens) - 1; i < j; i, j = i+1, j-1 {
+					clens[i], clens[j] = clens[j], clens[i]
+				}
+			}
+		}
+		clens = append(clens, uint16(c.len))
+		clenCnts[c.len]++
+		sym = c.sym + 1
+	}
+
+	// Generate and write the code-lengths prefix table.
+	var codeCLensArr [len(complexLens)]prefixCode
+	codeCLens := buildPrefixCodes(codeCLensArr[:0], clenCnts[:], 5)
+	var clenLens [len(complexLens)]uint
+	for _, c := range codeCLens {
+		clenLens[c.sym] = uint(c.len)
+		if len(codeCLens) == 1 {
+			clenLens[c.sym] = 1 // Single symbol uses zero bits
+		}
+	}
+	var pe prefixEncoder
+	pe.Init(codeCLens)
+
+	bw.WriteBits(0, 2) // HSKIP
+	sum := 32
+	for _, sym := range complexLens {
+		clen := clenLens[sym]
+		bw.WriteSymbol(&encCLens, clen)
+		if clen > 0 {
+			if sum -= 32 >> clen; sum <= 0 {
+				break
+			}
+		}
+	}
+
+	// Write the code lengths themselves.
+	for _, c := range clens {
+		bw.WriteSymbol(&pe, uint(c&0xff))
+		if c&0xff == 17 {
+			bw.WriteBits(uint(c>>8), 3)
+		}
+	}
+}
+
+// Flush writes all complete bytes to the underlying io.Writer.
+// At most 7 bits will remain in the bit buffer after this call.
+func (bw *bitWriter) Flush() (int64, error) {
+	bw.pushBits()
+	if len(bw.buf) == 0 || bw.wr == nil {
+		return bw.offset, nil
+	}
+	cnt, err := bw.wr.Write(bw.buf)
+	bw.offset += int64(cnt)
+	bw.buf = bw.buf[:copy(bw.buf, bw.buf[cnt:])]
+	return bw.offset, err
+}
+
+// Bytes returns all complete bytes held in memory.
+// The bit buffer must be byte-aligned.
+func (bw *bitWriter) Bytes() []byte {
+	if bw.numBits%8 != 0 {
+		errors.Panic(errUnaligned)
+	}
+	bw.pushBits()
+	return bw.buf
+}
+
+// pushBits moves all complete bytes from the bit buffer to the byte buffer.
+func (bw *bitWriter) pushBits() {
+	var arr [8]byte
+	binary.LittleEndian.PutUint64(arr[:], bw.bufBits)
+	nb := bw.numBits / 8
+	bw.buf = append(bw.buf, arr[:nb]...)
+	bw.bufBits >>= 8 * nb
+	bw.numBits -= 8 * nb
+}
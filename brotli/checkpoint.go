@@ -0,0 +1,123 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package brotli
+
+import (
+	"encoding/binary"
+	"io"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+const checkpointVersion = 1
+
+var errNoCheckpoint = errorf(errors.Invalid, "reader is not at a meta-block boundary")
+
+// Checkpoint is a snapshot of the state of a Reader at a meta-block boundary.
+// It allows decompression to resume at that point with a new Reader, without
+// decompressing any of the preceding data.
+//
+// Besides the position of the next meta-block, the state carried across
+// meta-blocks is the window size, the ring buffer of last distances, and the
+// sliding window itself.
+type Checkpoint struct {
+	InputOffset  int64 // Offset of the byte containing the start of the meta-block
+	OutputOffset int64 // Offset of the decompressed data that the meta-block produces
+
+	bits   uint8  // Number of bits of the byte at InputOffset already consumed
+	wbits  uint8  // Base-2 logarithm of the window size
+	dists  [4]int // Last few distances (newest-to-oldest)
+	window []byte // Sliding window history
+}
+
+// MarshalBinary encodes the checkpoint in a compact binary form.
+func (cp *Checkpoint) MarshalBinary() ([]byte, error) {
+	var b [binary.MaxVarintLen64]byte
+	buf := make([]byte, 0, 3+6*len(b)+len(cp.window))
+	buf = append(buf, checkpointVersion, cp.bits, cp.wbits)
+	buf = append(buf, b[:binary.PutUvarint(b[:], uint64(cp.InputOffset))]...)
+	buf = append(buf, b[:binary.PutUvarint(b[:], uint64(cp.OutputOffset))]...)
+	for _, d := range cp.dists {
+		buf = append(buf, b[:binary.PutUvarint(b[:], uint64(d))]...)
+	}
+	buf = append(buf, cp.window...)
+	return buf, nil
+}
+
+// UnmarshalBinary decodes a checkpoint produced by MarshalBinary.
+func (cp *Checkpoint) UnmarshalBinary(buf []byte) error {
+	if len(buf) < 3 || buf[0] != checkpointVersion || buf[1] >= 8 || buf[2] < 10 || buf[2] > 24 {
+		return errorf(errors.Corrupted, "invalid checkpoint header")
+	}
+	bits, wbits, buf := buf[1], buf[2], buf[3:]
+	var vals [6]int64
+	for i := range vals {
+		v, n := binary.Uvarint(buf)
+		if n <= 0 || int64(v) < 0 || (i >= 2 && (v == 0 || v > 1<<wbits)) {
+			return errorf(errors.Corrupted, "invalid checkpoint value")
+		}
+		vals[i], buf = int64(v), buf[n:]
+	}
+	if len(buf) > 1<<wbits-16 || int64(len(buf)) > vals[1] {
+		return errorf(errors.Corrupted, "invalid checkpoint window")
+	}
+	*cp = Checkpoint{
+		InputOffset:  vals[0],
+		OutputOffset: vals[1],
+		bits:         bits,
+		wbits:        wbits,
+		window:       append([]byte(nil), buf...),
+	}
+	for i := range cp.dists {
+		cp.dists[i] = int(vals[2+i])
+	}
+	return nil
+}
+
+// Checkpoint returns a snapshot of the Reader's state, which is only possible
+// when decompression has stopped at a meta-block boundary before the last
+// meta-block. The checkpoint resumes output after all of the data decompressed
+// so far, including any buffered data that has not yet been read.
+func (br *Reader) Checkpoint() (*Checkpoint, error) {
+	if br.err != nil || !br.blkStart || br.last {
+		return nil, errNoCheckpoint
+	}
+	var wbits uint8
+	for 1<<wbits-16 < br.dict.size {
+		wbits++
+	}
+	pos := br.rd.BitsRead()
+	return &Checkpoint{
+		InputOffset:  pos / 8,
+		OutputOffset: br.OutputOffset + int64(len(br.toRead)+br.dict.wrPos-br.dict.rdPos),
+		bits:         uint8(pos % 8),
+		wbits:        wbits,
+		dists:        br.dists,
+		window:       br.dict.Window(nil),
+	}, nil
+}
+
+// Restore discards the Reader's state and resumes decompression from the
+// checkpoint, reading from r. The caller must position r at cp.InputOffset
+// in the compressed stream. Afterwards, the Reader's offsets are relative to
+// the start of the original stream.
+func (br *Reader) Restore(r io.Reader, cp *Checkpoint) error {
+	br.Reset(r)
+	br.InputOffset, br.OutputOffset = cp.InputOffset, cp.OutputOffset
+	br.step = (*Reader).readBlockHeader
+	br.blkStart = true
+	br.dists = cp.dists
+	br.dict.Init(1<<cp.wbits - 16)
+	br.dict.Preset(cp.window)
+
+	// Skip the bits of the first byte that belong to the prior meta-block.
+	br.rd.offset = br.InputOffset
+	func() {
+		defer errors.Recover(&br.err)
+		br.rd.ReadBits(uint(cp.bits))
+	}()
+	br.InputOffset = br.rd.FlushOffset()
+	return br.err
+}
@@ -0,0 +1,100 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package brotli
+
+import (
+	"bufio"
+	"bytes"
+	"io"
+	"io/ioutil"
+	"testing"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+func TestCheckpoint(t *testing.T) {
+	var vectors []struct {
+		desc   string
+		input  []byte
+		output []byte
+	}
+	for _, f := range []string{"twain-speed-1e6.br", "twain-default-1e6.br", "digits-speed-1e6.br"} {
+		input := testutil.MustLoadFile("testdata/" + f)
+		br, _ := NewReader(bytes.NewReader(input), nil)
+		output, err := ioutil.ReadAll(br)
+		if err != nil {
+			t.Fatalf("%s: ReadAll() = %v", f, err)
+		}
+		vectors = append(vectors, struct {
+			desc   string
+			input  []byte
+			output []byte
+		}{f, input, output})
+	}
+
+	for i, v := range vectors {
+		// Collect checkpoints while reading with small buffers.
+		var cps []*Checkpoint
+		br, _ := NewReader(bytes.NewReader(v.input), nil)
+		buf := make([]byte, 1<<12)
+		for {
+			_, err := br.Read(buf)
+			if err == io.EOF {
+				break
+			}
+			if err != nil {
+				t.Fatalf("test %d (%s): Read() = %v", i, v.desc, err)
+			}
+			if cp, err := br.Checkpoint(); err == nil {
+				cps = append(cps, cp)
+			} else if err != errNoCheckpoint {
+				t.Fatalf("test %d (%s): Checkpoint() = %v", i, v.desc, err)
+			}
+		}
+		if len(cps) < 2 {
+			t.Errorf("test %d (%s): got %d checkpoints, want at least 2", i, v.desc, len(cps))
+		}
+
+		// Resume from some of the checkpoints after a round-trip through their
+		// binary encoding, using both buffered and unbuffered inputs.
+		for j, cp := range cps {
+			if j%4 > 1 {
+				continue
+			}
+			b, _ := cp.MarshalBinary()
+			cp = new(Checkpoint)
+			if err := cp.UnmarshalBinary(b); err != nil {
+				t.Fatalf("test %d (%s), checkpoint %d: UnmarshalBinary() = %v", i, v.desc, j, err)
+			}
+			var r io.Reader = bytes.NewReader(v.input[cp.InputOffset:])
+			if j%2 == 1 {
+				r = bufio.NewReader(r)
+			}
+			br := new(Reader)
+			if err := br.Restore(r, cp); err != nil {
+				t.Fatalf("test %d (%s), checkpoint %d: Restore() = %v", i, v.desc, j, err)
+			}
+			got, err := ioutil.ReadAll(br)
+			if err != nil {
+				t.Errorf("test %d (%s), checkpoint %d: ReadAll() = %v", i, v.desc, j, err)
+			}
+			if !bytes.Equal(got, v.output[cp.OutputOffset:]) {
+				t.Errorf("test %d (%s), checkpoint %d: output mismatch", i, v.desc, j)
+			}
+			if br.InputOffset != int64(len(v.input)) || br.OutputOffset != int64(len(v.output)) {
+				t.Errorf("test %d (%s), checkpoint %d: offsets = (%d, %d), want (%d, %d)",
+					i, v.desc, j, br.InputOffset, br.OutputOffset, len(v.input), len(v.output))
+			}
+		}
+	}
+
+	// Malformed checkpoints are rejected.
+	for _, b := range [][]byte{nil, {0, 0, 16, 0, 0, 1, 1, 1, 1}, {checkpointVersion, 0, 9, 0, 0, 1, 1, 1, 1},
+		{checkpointVersion, 0, 16, 0, 0, 0, 1, 1, 1}, {checkpointVersion, 0, 16, 0, 0, 1, 1, 1, 1, 'x'}} {
+		if err := new(Checkpoint).UnmarshalBinary(b); err == nil {
+			t.Errorf("UnmarshalBinary(%x) = nil, want error", b)
+		}
+	}
+}
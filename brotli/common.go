@@ -32,6 +32,12 @@ func errWrap(err error, replaceCode int) error {
 	return err
 }
 
+const (
+	BestSpeed          = 1
+	BestCompression    = 9
+	DefaultCompression = 6
+)
+
 var (
 	errClosed    = errorf(errors.Closed, "")
 	errCorrupted = errorf(errors.Corrupted, "")
@@ -100,6 +106,13 @@ func allocUint32s(s []uint32, n int) []uint32 {
 	return make([]uint32, n, n*3/2)
 }
 
+func allocInt32s(s []int32, n int) []int32 {
+	if cap(s) >= n {
+		return s[:n]
+	}
+	return make([]int32, n, n*3/2)
+}
+
 func extendSliceUints32s(s [][]uint32, n int) [][]uint32 {
 	if cap(s) >= n {
 		return s[:n]
@@ -117,3 +130,12 @@ func extendDecoders(s []prefixDecoder, n int) []prefixDecoder {
 	copy(ss, s[:cap(s)])
 	return ss
 }
+
+func extendCommandDecoders(s []commandDecoder, n int) []commandDecoder {
+	if cap(s) >= n {
+		return s[:n]
+	}
+	ss := make([]commandDecoder, n, n*3/2)
+	copy(ss, s[:cap(s)])
+	return ss
+}
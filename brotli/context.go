@@ -82,8 +82,8 @@ var (
 
 // These LUTs are dynamically computed from the LUTs in the specification.
 var (
-	contextP1LUT [256 * numContextModes]uint8
-	contextP2LUT [256 * numContextModes]uint8
+	contextP1LUT [numContextModes][256]uint8
+	contextP2LUT [numContextModes][256]uint8
 )
 
 // initContextLUTs computes LUTs so that context ID computation can be
@@ -91,22 +91,20 @@ var (
 func initContextLUTs() {
 	for i := 0; i < 256; i++ {
 		for m := 0; m < numContextModes; m++ {
-			base := m << 8
-
 			// Operations performed here are specified in RFC section 7.1.
 			switch m {
 			case contextLSB6:
-				contextP1LUT[base+i] = byte(i) & 0x3f
-				contextP2LUT[base+i] = 0
+				contextP1LUT[m][i] = byte(i) & 0x3f
+				contextP2LUT[m][i] = 0
 			case contextMSB6:
-				contextP1LUT[base+i] = byte(i) >> 2
-				contextP2LUT[base+i] = 0
+				contextP1LUT[m][i] = byte(i) >> 2
+				contextP2LUT[m][i] = 0
 			case contextUTF8:
-				contextP1LUT[base+i] = contextLUT0[byte(i)]
-				contextP2LUT[base+i] = contextLUT1[byte(i)]
+				contextP1LUT[m][i] = contextLUT0[byte(i)]
+				contextP2LUT[m][i] = contextLUT1[byte(i)]
 			case contextSigned:
-				contextP1LUT[base+i] = contextLUT2[byte(i)] << 3
-				contextP2LUT[base+i] = contextLUT2[byte(i)]
+				contextP1LUT[m][i] = contextLUT2[byte(i)] << 3
+				contextP2LUT[m][i] = contextLUT2[byte(i)]
 			default:
 				panic("unknown context mode")
 			}
@@ -117,8 +115,8 @@ func initContextLUTs() {
 // getLitContextID computes the context ID for literals from RFC section 7.1.
 // Bytes p1 and p2 are the last and second-to-last byte, respectively.
 func getLitContextID(p1, p2 byte, mode uint8) uint8 {
-	base := uint(mode) << 8
-	return contextP1LUT[base+uint(p1)] | contextP2LUT[base+uint(p2)]
+	mode &= numContextModes - 1 // Mask to avoid bounds checks
+	return contextP1LUT[mode][p1] | contextP2LUT[mode][p2]
 }
 
 // getDistContextID computes the context ID for distances using the copy length
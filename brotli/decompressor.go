@@ -0,0 +1,131 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package brotli
+
+import (
+	"io"
+
+	"github.com/dsnet/compress/internal"
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// pushStepSize is the maximum amount of data decompressed by a single step of
+// a Decompressor. Since a step that runs out of input is rolled back and
+// retried later, this bounds the amount of redundant work and the amount of
+// history that must be saved before each step.
+const pushStepSize = 1 << 10
+
+// Decompressor is a push-style Brotli decompressor. Rather than pulling input
+// from an io.Reader, the caller provides both the input and the output buffer
+// on each call to Decompress, which never blocks. This allows many streams to
+// be multiplexed on a few goroutines.
+type Decompressor struct {
+	InputOffset  int64 // Total number of bytes consumed from the input
+	OutputOffset int64 // Total number of bytes produced as output
+
+	br   Reader
+	src  internal.PushReader
+	hist []byte // Copy of the history that a step may overwrite
+}
+
+// NewDecompressor returns a new Decompressor.
+//
+// The ReleaseAfter policy of conf applies to Reset in the same way as for
+// Reader. The WorkBudget of conf is validated but otherwise unused, since each
+// step of a Decompressor is already limited to pushStepSize bytes of output
+// and each call to Decompress produces at most len(out) bytes.
+func NewDecompressor(conf *ReaderConfig) (*Decompressor, error) {
+	bd := new(Decompressor)
+	if conf != nil {
+		if conf.WorkBudget < 0 {
+			return nil, errorf(errors.Invalid, "invalid work budget: %d", conf.WorkBudget)
+		}
+		if conf.ReleaseAfter < 0 {
+			return nil, errorf(errors.Invalid, "invalid release count: %d", conf.ReleaseAfter)
+		}
+		bd.br.relAfter = conf.ReleaseAfter
+	}
+	bd.Reset()
+	return bd, nil
+}
+
+func (bd *Decompressor) Reset() error {
+	*bd = Decompressor{br: bd.br, src: bd.src, hist: bd.hist}
+	bd.src.Reset()
+	bd.br.Reset(&bd.src)
+	bd.br.dict.SetMaxWrite(pushStepSize)
+	return nil
+}
+
+// Decompress decompresses data from in into out, returning the number of
+// bytes consumed from in and the number of bytes produced into out.
+//
+// Input that has been consumed, but cannot be decoded yet (such as a partial
+// prefix code), is retained internally. Thus, the caller must resubmit only
+// in[consumed:] on the next call, which is only non-empty if out was filled or
+// the end of the stream was reached.
+//
+// It returns io.EOF once the entire stream has been decompressed and emitted,
+// in which case in[consumed:] is any data that follows the stream.
+// A nil error with produced < len(out) means that more input is needed.
+// Any other error is persistent.
+func (bd *Decompressor) Decompress(in, out []byte) (consumed, produced int, err error) {
+	br := &bd.br
+	bd.src.Begin(in)
+	var needInput bool
+	for {
+		if len(br.toRead) > 0 {
+			cnt := copy(out[produced:], br.toRead)
+			br.toRead = br.toRead[cnt:]
+			produced += cnt
+			if len(br.toRead) > 0 {
+				break
+			}
+		}
+		if br.err != nil || produced == len(out) {
+			break
+		}
+		if !bd.step() && !bd.src.More() {
+			needInput = true
+			break
+		}
+	}
+	consumed = bd.src.End(needInput)
+	bd.InputOffset += int64(consumed)
+	bd.OutputOffset += int64(produced)
+	if len(br.toRead) == 0 {
+		err = br.err
+	}
+	return consumed, produced, err
+}
+
+// step performs the next step of decompression. If the step runs out of
+// input, then all of its effects are undone and it reports false.
+func (bd *Decompressor) step() bool {
+	br := &bd.br
+	saved, pos := *br, bd.src.Mark()
+	end := br.dict.wrLimit + histSlop // Wide copies may write past wrLimit
+	if end > len(br.dict.hist) {
+		end = len(br.dict.hist)
+	}
+	bd.hist = append(bd.hist[:0], br.dict.hist[br.dict.wrPos:end]...)
+	br.doStep()
+	if br.err != internal.ErrNeedInput {
+		return true
+	}
+	*br = saved
+	copy(br.dict.hist[br.dict.wrPos:], bd.hist)
+	bd.src.Rewind(pos)
+	return false
+}
+
+// Close reports io.ErrUnexpectedEOF if the end of the stream has not been
+// reached, otherwise it returns the persistent error (if any).
+func (bd *Decompressor) Close() error {
+	if bd.br.err == nil {
+		bd.br.err = io.ErrUnexpectedEOF
+	}
+	return bd.br.Close()
+}
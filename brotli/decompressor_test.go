@@ -0,0 +1,99 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package brotli
+
+import (
+	"bytes"
+	"io"
+	"testing"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+func TestDecompressor(t *testing.T) {
+	lf := testutil.MustLoadFile
+	vectors := []struct {
+		desc   string
+		input  []byte
+		output []byte
+	}{
+		{"ukkonooa", lf("testdata/ukkonooa.br"), lf("testdata/ukkonooa")},
+		{"monkey", lf("testdata/monkey.br"), lf("testdata/monkey")},
+		{"random_org_10k.bin", lf("testdata/random_org_10k.bin.br"), lf("testdata/random_org_10k.bin")},
+		{"compressed_file", lf("testdata/compressed_file.br"), lf("testdata/compressed_file")},
+		{"compressed_repeated", lf("testdata/compressed_repeated.br"), lf("testdata/compressed_repeated")},
+		{"alice29.txt", lf("testdata/alice29.txt.br"), lf("testdata/alice29.txt")},
+	}
+
+	rand := testutil.NewRand(0)
+	trailer := []byte("trailer")
+	for i, v := range vectors {
+		for _, max := range []struct{ in, out int }{{1, 1 << 16}, {7, 3}, {1 << 10, 1 << 10}, {1 << 20, 1 << 20}} {
+			bd, _ := NewDecompressor(nil)
+			input := append(append([]byte(nil), v.input...), trailer...)
+			output, consumed, err := testutil.PushDecompress(bd, input, rand, max.in, max.out)
+			if err != io.EOF {
+				t.Errorf("test %d (%s), max %v: Decompress() = %v, want io.EOF", i, v.desc, max, err)
+			}
+			if !bytes.Equal(output, v.output) {
+				t.Errorf("test %d (%s), max %v: output mismatch", i, v.desc, max)
+			}
+			if consumed != len(v.input) || bd.InputOffset != int64(len(v.input)) {
+				t.Errorf("test %d (%s), max %v: consumed = (%d, %d), want %d", i, v.desc, max, consumed, bd.InputOffset, len(v.input))
+			}
+			if err := bd.Close(); err != nil {
+				t.Errorf("test %d (%s), max %v: Close() = %v", i, v.desc, max, err)
+			}
+		}
+
+		// Truncated streams are only detected by Close.
+		bd, _ := NewDecompressor(nil)
+		output, _, err := testutil.PushDecompress(bd, v.input[:len(v.input)-1], rand, 1<<10, 1<<10)
+		if err != nil {
+			t.Errorf("test %d (%s): Decompress() = %v, want nil", i, v.desc, err)
+		}
+		if !bytes.HasPrefix(v.output, output) {
+			t.Errorf("test %d (%s): output is not a prefix", i, v.desc)
+		}
+		if err := bd.Close(); err != io.ErrUnexpectedEOF {
+			t.Errorf("test %d (%s): Close() = %v, want io.ErrUnexpectedEOF", i, v.desc, err)
+		}
+	}
+
+	// Corrupt streams report a persistent error.
+	bd, _ := NewDecompressor(nil)
+	if _, _, err := bd.Decompress([]byte{0x11}, make([]byte, 10)); err == nil || err == io.EOF {
+		t.Errorf("Decompress() = %v, want corruption error", err)
+	}
+	if err := bd.Close(); err == nil {
+		t.Errorf("Close() = nil, want corruption error")
+	}
+
+	// The ReleaseAfter policy applies to Reset.
+	alice, aliceBr := lf("testdata/alice29.txt"), lf("testdata/alice29.txt.br")
+	bd, err := NewDecompressor(&ReaderConfig{ReleaseAfter: 1})
+	if err != nil {
+		t.Fatalf("unexpected NewDecompressor error: %v", err)
+	}
+	if _, _, err := testutil.PushDecompress(bd, windowBomb, rand, 1<<10, 1<<20); err != io.EOF {
+		t.Fatalf("Decompress() = %v, want io.EOF", err)
+	}
+	for i := 0; i < 2; i++ {
+		bd.Reset()
+		output, _, err := testutil.PushDecompress(bd, aliceBr, rand, 1<<10, 1<<10)
+		if err != io.EOF || !bytes.Equal(output, alice) {
+			t.Errorf("test %d: Decompress() = %v, output match %v, want io.EOF and match", i, err, bytes.Equal(output, alice))
+		}
+		if got, want := cap(bd.br.dict.hist) >= 1<<23, i < 1; got != want {
+			t.Errorf("test %d: large window retained = %v, want %v", i, got, want)
+		}
+	}
+
+	for _, conf := range []ReaderConfig{{WorkBudget: -1}, {ReleaseAfter: -1}} {
+		if _, err := NewDecompressor(&conf); err == nil {
+			t.Errorf("NewDecompressor(%+v) = nil, want error", conf)
+		}
+	}
+}
@@ -3,3 +3,131 @@
 // license that can be found in the LICENSE.md file.
 
 package brotli
+
+import "encoding/binary"
+
+// The dictEncoder implements a hash-chain based LZ77 match finder.
+// Unlike a typical streaming encoder, it operates on a contiguous buffer where
+// some leading portion is history that is only searched but never encoded.
+// This allows independent segments of the input to be encoded concurrently,
+// where each segment is primed with the data that precedes it.
+
+const (
+	minMatchLen = 4 // Shortest match that the encoder emits
+	maxMatchLen = 1 << 16
+
+	hashBits = 16
+	hashSize = 1 << hashBits
+)
+
+// command is a single insert-and-copy command from RFC section 5.
+// A command with a zero cpyLen only inserts literals and must be last in the
+// meta-block.
+type command struct {
+	insLen uint32 // Number of literals to insert
+	cpyLen uint32 // Number of bytes to copy
+	dist   uint32 // Backward distance of the copy
+}
+
+type dictEncoder struct {
+	chainLen int  // Maximum number of hash-chain entries to search
+	lazy     bool // Check whether the next position has a better match
+
+	head []int32 // Most recent position plus one for each hash
+	prev []int32 // Previous position plus one with the same hash
+}
+
+func (de *dictEncoder) Init(chainLen int, lazy bool) {
+	*de = dictEncoder{chainLen: chainLen, lazy: lazy, head: de.head, prev: de.prev}
+	if de.head == nil {
+		de.head = make([]int32, hashSize)
+	}
+}
+
+func hash4(b []byte) uint32 {
+	return (binary.LittleEndian.Uint32(b) * 0x1e35a7bd) >> (32 - hashBits)
+}
+
+// Encode appends the commands for buf[start:] to cmds. The data in buf[:start]
+// is used as history and no match will have a distance beyond maxDist.
+func (de *dictEncoder) Encode(cmds []command, buf []byte, start, maxDist int) []command {
+	for i := range de.head {
+		de.head[i] = 0
+	}
+	de.prev = allocInt32s(de.prev, len(buf))
+
+	insert := func(i int) {
+		h := hash4(buf[i:])
+		de.prev[i] = de.head[h]
+		de.head[h] = int32(i + 1)
+	}
+	search := func(i int) (bestLen, bestDist int) {
+		maxLen := len(buf) - i
+		if maxLen > maxMatchLen {
+			maxLen = maxMatchLen
+		}
+		cand := int(de.head[hash4(buf[i:])]) - 1
+		for n := de.chainLen; n > 0 && cand >= 0 && i-cand <= maxDist; n-- {
+			if buf[cand+bestLen] == buf[i+bestLen] || bestLen == 0 {
+				var cnt int
+				for cnt < maxLen && buf[cand+cnt] == buf[i+cnt] {
+					cnt++
+				}
+				if cnt > bestLen {
+					bestLen, bestDist = cnt, i-cand
+					if cnt == maxLen {
+						break
+					}
+				}
+			}
+			cand = int(de.prev[cand]) - 1
+		}
+		if bestLen < minMatchLen {
+			return 0, 0
+		}
+		return bestLen, bestDist
+	}
+
+	// Prime the hash chains with the history.
+	end := len(buf) - minMatchLen
+	prime := start - maxDist
+	if prime < 0 {
+		prime = 0
+	}
+	for i := prime; i < start && i <= end; i++ {
+		insert(i)
+	}
+
+	lit := start
+	for i := start; i <= end; {
+		cpyLen, dist := search(i)
+		insert(i)
+		if cpyLen == 0 {
+			i++
+			continue
+		}
+		if de.lazy && i+1 <= end {
+			if nextLen, nextDist := search(i + 1); nextLen > cpyLen {
+				insert(i + 1)
+				i, cpyLen, dist = i+1, nextLen, nextDist
+			}
+		}
+
+		cmds = append(cmds, command{
+			insLen: uint32(i - lit),
+			cpyLen: uint32(cpyLen),
+			dist:   uint32(dist),
+		})
+		if de.chainLen > 1 {
+			for j := i + 1; j < i+cpyLen && j <= end; j++ {
+				insert(j)
+			}
+		}
+		i += cpyLen
+		lit = i
+	}
+	if lit < len(buf) {
+		cmds = append(cmds, command{insLen: uint32(len(buf) - lit)})
+	}
+	return cmds
+}
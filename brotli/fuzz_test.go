@@ -0,0 +1,58 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+// +build go1.18
+
+package brotli
+
+import (
+	"bytes"
+	"io"
+	"io/ioutil"
+	"testing"
+	"time"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+// maxFuzzOutput is the maximum number of bytes decompressed for any input.
+const maxFuzzOutput = 1 << 22
+
+// fuzzCost is the maximum cost that decoding a single input may incur.
+// The fixed allocation allowance covers the largest possible window.
+var fuzzCost = testutil.CostBound{
+	TimeFixed:    100 * time.Millisecond,
+	TimePerByte:  1 * time.Microsecond,
+	AllocFixed:   64 << 20,
+	AllocPerByte: 16,
+}
+
+// FuzzReader checks that the Reader does not panic and that the cost of
+// decoding any input is proportional to the size of the input and output.
+func FuzzReader(f *testing.F) {
+	for _, name := range []string{
+		"ukkonooa.br", "monkey.br", "random_org_10k.bin.br", "compressed_file.br",
+		"compressed_repeated.br", "twain-speed-1e4.br", "digits-best-1e4.br",
+	} {
+		f.Add(testutil.MustLoadFile("testdata/" + name))
+	}
+	f.Add(windowBomb)
+
+	f.Fuzz(func(t *testing.T, data []byte) {
+		c := testutil.MeasureCost(func() int64 {
+			rd, _ := NewReader(bytes.NewReader(data), nil)
+			n, err := io.Copy(ioutil.Discard, io.LimitReader(rd, maxFuzzOutput))
+			if cerr := rd.Close(); err == nil && n < maxFuzzOutput && cerr != nil {
+				err = cerr
+			}
+			if err == nil && n < maxFuzzOutput && rd.InputOffset > int64(len(data)) {
+				t.Errorf("input offset exceeds input length: %d > %d", rd.InputOffset, len(data))
+			}
+			return int64(len(data)) + n
+		})
+		if err := fuzzCost.Check(c); err != nil {
+			t.Error(err)
+		}
+	})
+}
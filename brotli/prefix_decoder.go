@@ -184,3 +184,69 @@ func (pd *prefixDecoder) Init(codes []prefixCode, assignCodes bool) {
 		}
 	}
 }
+
+// The commandDecoder is a specialized decoding table for the insert-and-copy
+// alphabet. Each entry resolves the prefix symbol together with the extra bits
+// for both the insert and copy lengths in a single lookup. Only entries where
+// the combined bit-length of the code and its extra bits fit within
+// commandChunkBits are valid; all others (including symbols that require the
+// links table) must be decoded by the generic ReadSymbol and ReadBits path.
+//
+// Like the chunks of prefixDecoder, each entry is packed into a uint32:
+//
+//	var length   = chunk & commandCountMask
+//	var distZero = chunk & commandDistZero != 0
+//	var insLen   = chunk >> commandInsShift & commandLenMask
+//	var cpyLen   = chunk >> commandCpyShift
+//
+// Invalid entries have a length of commandCountMask, which is larger than
+// the number of bits that the bit buffer can ever hold.
+const (
+	commandChunkBits = 10 // This can be tuned for better performance
+
+	commandCountMask = 0x7f // Total number of bits consumed by the command
+	commandDistZero  = 0x80 // Whether the implicit zero distance is used
+	commandInsShift  = 8
+	commandCpyShift  = 20
+	commandLenMask   = 1<<(commandCpyShift-commandInsShift) - 1
+)
+
+type commandDecoder struct {
+	chunks *[1 << commandChunkBits]uint32
+}
+
+// Init initializes commandDecoder according to the prefixDecoder provided,
+// which must be a decoder for the insert-and-copy alphabet.
+func (cd *commandDecoder) Init(pd *prefixDecoder) {
+	if cd.chunks == nil {
+		cd.chunks = new([1 << commandChunkBits]uint32)
+	}
+	for i := range cd.chunks {
+		cd.chunks[i] = commandCountMask
+	}
+	if len(pd.chunks) == 0 {
+		return // Empty tree (ReadSymbol will report the error)
+	}
+
+	for i := range cd.chunks {
+		chunk := pd.chunks[uint32(i)&pd.chunkMask]
+		nb := uint(chunk & prefixCountMask)
+		if nb > uint(pd.chunkBits) {
+			continue // Symbol requires the links table
+		}
+		sym := chunk >> prefixCountBits
+		rec := iacLUT[sym]
+		if nb+uint(rec.ins.bits)+uint(rec.cpy.bits) > commandChunkBits {
+			continue // Extra bits do not fit in the table
+		}
+		insExtra := uint32(i>>nb) & (1<<rec.ins.bits - 1)
+		nb += uint(rec.ins.bits)
+		cpyExtra := uint32(i>>nb) & (1<<rec.cpy.bits - 1)
+		nb += uint(rec.cpy.bits)
+		cmd := (rec.cpy.base+cpyExtra)<<commandCpyShift | (rec.ins.base+insExtra)<<commandInsShift | uint32(nb)
+		if sym < 128 {
+			cmd |= commandDistZero
+		}
+		cd.chunks[i] = cmd
+	}
+}
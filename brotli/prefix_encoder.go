@@ -4,6 +4,81 @@
 
 package brotli
 
-type prefixEncoder struct{}
+import (
+	"github.com/dsnet/compress/internal/errors"
+	"github.com/dsnet/compress/internal/prefix"
+)
 
-func (pe *prefixEncoder) Init(codes []prefixCode) {}
+// The prefixEncoder is a direct lookup table keyed by symbol, where each entry
+// holds the bit-reversed prefix code and its bit-length packed in the same way
+// as the chunks of prefixDecoder:
+//
+//	var length = chunks[symbol] & prefixCountMask
+//	var code   = chunks[symbol] >> prefixCountBits
+type prefixEncoder struct {
+	chunks  []uint32 // Lookup table keyed by symbol
+	numSyms uint32   // Number of symbols
+}
+
+// Init initializes prefixEncoder according to the codes provided.
+// The codes must have the val and len fields populated.
+func (pe *prefixEncoder) Init(codes []prefixCode) {
+	var maxSym uint32
+	for _, c := range codes {
+		if maxSym < c.sym {
+			maxSym = c.sym
+		}
+	}
+	pe.chunks = allocUint32s(pe.chunks, int(maxSym)+1)
+	for i := range pe.chunks {
+		pe.chunks[i] = 0
+	}
+	for _, c := range codes {
+		pe.chunks[c.sym] = c.val<<prefixCountBits | c.len
+	}
+	pe.numSyms = uint32(len(codes))
+}
+
+// buildPrefixCodes appends a canonical prefix code to codes for all symbols
+// with a non-zero count in cnts, where the index of cnts is the symbol.
+// The bit-length of each code is limited to maxBits. The resulting codes are
+// sorted by symbol and have the val field populated the same way that
+// prefixDecoder.Init assigns them. If only a single symbol is used,
+// then it is assigned a bit-length of zero.
+func buildPrefixCodes(codes []prefixCode, cnts []uint32, maxBits uint) []prefixCode {
+	var pcArr [maxNumAlphabetSyms]prefix.PrefixCode
+	pcs := prefix.PrefixCodes(pcArr[:0])
+	for sym, cnt := range cnts {
+		if cnt > 0 {
+			pcs = append(pcs, prefix.PrefixCode{Sym: uint32(sym), Cnt: cnt})
+		}
+	}
+	if len(pcs) == 0 {
+		pcs = append(pcs, prefix.PrefixCode{Sym: 0}) // Tree must be non-empty
+	}
+	pcs.SortByCount()
+	if err := prefix.GenerateLengths(pcs, maxBits); err != nil {
+		errors.Panic(err)
+	}
+	pcs.SortBySymbol()
+
+	// Compute the next code for a symbol of a given bit length.
+	var bitCnts [maxPrefixBits + 1]uint
+	for _, c := range pcs {
+		bitCnts[c.Len]++
+	}
+	bitCnts[0] = 0
+	var nextCodes [maxPrefixBits + 1]uint
+	var code uint
+	for i := 1; i <= maxPrefixBits; i++ {
+		code = (code + bitCnts[i-1]) << 1
+		nextCodes[i] = code
+	}
+
+	for _, c := range pcs {
+		val := reverseBits(uint32(nextCodes[c.Len]), uint(c.Len))
+		nextCodes[c.Len]++
+		codes = append(codes, prefixCode{sym: c.Sym, val: val, len: c.Len})
+	}
+	return codes
+}
@@ -3,3 +3,187 @@
 // license that can be found in the LICENSE.md file.
 
 package brotli
+
+import (
+	"bufio"
+	"bytes"
+	"testing"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+type testCommand struct {
+	insLen, cpyLen uint
+	distZero       bool
+}
+
+// makeCommands generates a prefix code for the insert-and-copy alphabet and n
+// random commands encoded with it. Symbols with fewer extra bits are more
+// likely, such that the frequent symbols are served by the commandDecoder
+// table, while the rare ones have long codes that need the links table.
+func makeCommands(n int) (pd *prefixDecoder, cmds []testCommand, stream []byte) {
+	rand := testutil.NewRand(0)
+	var cnts [numIaCSyms]uint32
+	var pool []uint
+	for sym := range cnts {
+		rec := iacLUT[sym]
+		cnts[sym] = 1 + uint32(1<<uint(rand.Intn(16)))>>(2*(rec.ins.bits+rec.cpy.bits))
+		for i := 0; i < int(cnts[sym]); i++ {
+			pool = append(pool, uint(sym))
+		}
+	}
+	codes := buildPrefixCodes(nil, cnts[:], maxPrefixBits)
+	pd = new(prefixDecoder)
+	pd.Init(codes, false)
+	var pe prefixEncoder
+	pe.Init(codes)
+
+	var bw bitWriter
+	bw.Init(nil)
+	for i := 0; i < n; i++ {
+		sym := pool[rand.Intn(len(pool))]
+		rec := iacLUT[sym]
+		insExtra := uint(rand.Int()) & (1<<rec.ins.bits - 1)
+		cpyExtra := uint(rand.Int()) & (1<<rec.cpy.bits - 1)
+		bw.WriteSymbol(&pe, sym)
+		bw.WriteBits(insExtra, uint(rec.ins.bits))
+		bw.WriteBits(cpyExtra, uint(rec.cpy.bits))
+		cmds = append(cmds, testCommand{
+			insLen:   uint(rec.ins.base) + insExtra,
+			cpyLen:   uint(rec.cpy.base) + cpyExtra,
+			distZero: sym < 128,
+		})
+	}
+	bw.WritePads()
+	bw.WriteBits(0, 32) // Trailing bits so that FeedBits never hits EOF
+	bw.WriteBits(0, 32)
+	return pd, cmds, bw.Bytes()
+}
+
+// readCommand reads a single command in the same way as Reader.readCommands.
+// If cd is nil, then only the generic ReadSymbol and ReadBits path is used.
+// It reports whether the command was decoded by the commandDecoder table.
+func readCommand(br *bitReader, cd *commandDecoder, pd *prefixDecoder) (testCommand, bool) {
+	if cd != nil {
+		if cmd, ok := br.TryReadCommand(cd); ok {
+			insLen := uint(cmd>>commandInsShift) & commandLenMask
+			return testCommand{insLen, uint(cmd >> commandCpyShift), cmd&commandDistZero != 0}, true
+		}
+	}
+	sym, ok := br.TryReadSymbol(pd)
+	if !ok {
+		sym = br.ReadSymbol(pd)
+	}
+	rec := iacLUT[sym]
+	insExtra, ok := br.TryReadBits(uint(rec.ins.bits))
+	if !ok {
+		insExtra = br.ReadBits(uint(rec.ins.bits))
+	}
+	cpyExtra, ok := br.TryReadBits(uint(rec.cpy.bits))
+	if !ok {
+		cpyExtra = br.ReadBits(uint(rec.cpy.bits))
+	}
+	return testCommand{uint(rec.ins.base) + insExtra, uint(rec.cpy.base) + cpyExtra, sym < 128}, false
+}
+
+func TestCommandDecoder(t *testing.T) {
+	// Every command that fits in the table must also fit in its packed form.
+	for sym, rec := range iacLUT {
+		if rec.ins.bits+rec.cpy.bits > commandChunkBits {
+			continue
+		}
+		insMax := rec.ins.base + 1<<rec.ins.bits - 1
+		cpyMax := rec.cpy.base + 1<<rec.cpy.bits - 1
+		if insMax > commandLenMask || cpyMax > commandLenMask {
+			t.Errorf("symbol %d, lengths (%d, %d) overflow the packed command", sym, insMax, cpyMax)
+		}
+	}
+
+	pd, cmds, stream := makeCommands(1e5)
+	if pd.chunkBits >= maxPrefixBits || len(pd.links) == 0 {
+		t.Fatalf("prefix code does not use the links table")
+	}
+	var cd commandDecoder
+	cd.Init(pd)
+
+	for _, fused := range []bool{false, true} {
+		var br bitReader
+		br.Init(bufio.NewReader(bytes.NewReader(stream)))
+		var cdp *commandDecoder
+		if fused {
+			cdp = &cd
+		}
+
+		var hits, misses int
+		for i, want := range cmds {
+			got, hit := readCommand(&br, cdp, pd)
+			if got != want {
+				t.Fatalf("fused %v, command %d, mismatch: got %+v, want %+v", fused, i, got, want)
+			}
+			if hit {
+				hits++
+			} else {
+				misses++
+			}
+		}
+		if fused && (hits == 0 || misses == 0) {
+			t.Errorf("fused %v, table hits = %d, misses = %d, want both non-zero", fused, hits, misses)
+		}
+		if !fused && hits != 0 {
+			t.Errorf("fused %v, table hits = %d, want zero", fused, hits)
+		}
+	}
+}
+
+func BenchmarkCommandDecoder(b *testing.B) {
+	pd, cmds, stream := makeCommands(1e5)
+	var cd commandDecoder
+	cd.Init(pd)
+
+	// The loops mirror Reader.readCommands with and without the fast path.
+	var br bitReader
+	rd := bufio.NewReader(nil)
+	b.Run("Generic", func(b *testing.B) {
+		b.SetBytes(int64(len(stream)))
+		for i := 0; i < b.N; i++ {
+			rd.Reset(bytes.NewReader(stream))
+			br.Init(rd)
+			for range cmds {
+				sym, ok := br.TryReadSymbol(pd)
+				if !ok {
+					sym = br.ReadSymbol(pd)
+				}
+				rec := iacLUT[sym]
+				if _, ok := br.TryReadBits(uint(rec.ins.bits)); !ok {
+					br.ReadBits(uint(rec.ins.bits))
+				}
+				if _, ok := br.TryReadBits(uint(rec.cpy.bits)); !ok {
+					br.ReadBits(uint(rec.cpy.bits))
+				}
+			}
+		}
+	})
+	b.Run("Fused", func(b *testing.B) {
+		b.SetBytes(int64(len(stream)))
+		for i := 0; i < b.N; i++ {
+			rd.Reset(bytes.NewReader(stream))
+			br.Init(rd)
+			for range cmds {
+				if _, ok := br.TryReadCommand(&cd); ok {
+					continue
+				}
+				sym, ok := br.TryReadSymbol(pd)
+				if !ok {
+					sym = br.ReadSymbol(pd)
+				}
+				rec := iacLUT[sym]
+				if _, ok := br.TryReadBits(uint(rec.ins.bits)); !ok {
+					br.ReadBits(uint(rec.ins.bits))
+				}
+				if _, ok := br.TryReadBits(uint(rec.cpy.bits)); !ok {
+					br.ReadBits(uint(rec.cpy.bits))
+				}
+			}
+		}
+	})
+}
@@ -15,14 +15,22 @@ import (
 type Reader struct {
 	InputOffset  int64 // Total number of bytes read from underlying io.Reader
 	OutputOffset int64 // Total number of bytes emitted from Read
+	NumSymbols   int64 // Total number of literal and command symbols decoded
 
-	rd     bitReader // Input source
-	toRead []byte    // Uncompressed data ready to be emitted from Read
-	blkLen int       // Uncompressed bytes left to read in meta-block
-	insLen int       // Bytes left to insert in current command
-	cpyLen int       // Bytes left to copy in current command
-	last   bool      // Last block bit detected
-	err    error     // Persistent error
+	rd      bitReader // Input source
+	toRead  []byte    // Uncompressed data ready to be emitted from Read
+	peekBuf []byte    // Buffer to accumulate data for Peek
+	blkLen  int       // Uncompressed bytes left to read in meta-block
+	insLen  int       // Bytes left to insert in current command
+	cpyLen  int       // Bytes left to copy in current command
+	last    bool      // Last block bit detected
+	err     error     // Persistent error
+	budget  int       // Maximum work per call to Read (zero means unlimited)
+
+	relAfter int // Number of oversized streams before Reset calls Release
+	relCnt   int // Number of consecutive oversized streams
+
+	blkStart bool // The next step reads a meta-block header
 
 	step      func(*Reader) // Single step of decompression work (can panic)
 	stepState int           // The sub-step state for certain steps
@@ -30,32 +38,32 @@ type Reader struct {
 	mtf     internal.MoveToFront // Local move-to-front decoder
 	dict    dictDecoder          // Dynamic sliding dictionary
 	iacBlk  blockDecoder         // Insert-and-copy block decoder
+	iacCmds []commandDecoder     // Fused command decoders for each iacBlk type
 	litBlk  blockDecoder         // Literal block decoder
 	distBlk blockDecoder         // Distance block decoder
 
 	// Literal decoding state fields.
-	litMapType []uint8 // The current literal context map for the current block type
-	litMap     []uint8 // Literal context map
-	cmode      uint8   // The current context mode
-	cmodes     []uint8 // Literal context modes
+	litMapType [64]uint8 // The current literal context map for the current block type
+	litMap     []uint8   // Literal context map
+	cmode      uint8     // The current context mode
+	cmodes     []uint8   // Literal context modes
 
 	// Distance decoding state fields.
-	distMap     []uint8 // Distance context map
-	distMapType []uint8 // The current distance context map for the current block type
-	dist        int     // The current distance (may not be in dists)
-	dists       [4]int  // Last few distances (newest-to-oldest)
-	distZero    bool    // Implicit zero distance symbol found
-	npostfix    uint8   // Postfix bits used in distance decoding
-	ndirect     uint8   // Number of direct distance codes
+	distMap     []uint8  // Distance context map
+	distMapType [4]uint8 // The current distance context map for the current block type
+	dist        int      // The current distance (may not be in dists)
+	dists       [4]int   // Last few distances (newest-to-oldest)
+	distZero    bool     // Implicit zero distance symbol found
+	npostfix    uint8    // Postfix bits used in distance decoding
+	ndirect     uint8    // Number of direct distance codes
 
 	// Static dictionary state fields.
 	word    []byte            // Transformed word obtained from static dictionary
 	wordBuf [maxWordSize]byte // Buffer to write a transformed word into
 
 	// Meta data fields.
-	metaRd  io.LimitedReader // Local LimitedReader to reduce allocation
-	metaWr  io.Writer        // Writer to write meta data to
-	metaBuf []byte           // Scratch space for reading meta data
+	metaWr  io.Writer // Writer to write meta data to
+	metaBuf []byte    // Scratch space for reading meta data
 }
 
 type blockDecoder struct {
@@ -68,16 +76,44 @@ type blockDecoder struct {
 }
 
 type ReaderConfig struct {
+	// WorkBudget is a soft limit on the work performed by a single call to
+	// Read, as measured in bytes of output produced. Read decodes until some
+	// output is available and then returns at most the budget. Without a
+	// budget, a stream with a large window may decode many megabytes before
+	// Read returns. Meta-blocks that produce no output are always decoded
+	// within the same call. If zero, Read decodes until output is available.
+	WorkBudget int
+
+	// ReleaseAfter makes Reset call Release once this many consecutive streams
+	// have needed less than a quarter of the sliding window that was allocated
+	// for an earlier stream. This bounds the memory held by long-lived Readers
+	// that only occasionally decode streams with a large window.
+	// If zero, buffers are only released by calling Release.
+	ReleaseAfter int
+
 	_ struct{} // Blank field to prevent unkeyed struct literals
 }
 
 func NewReader(r io.Reader, conf *ReaderConfig) (*Reader, error) {
 	br := new(Reader)
+	if conf != nil {
+		if conf.WorkBudget < 0 {
+			return nil, errorf(errors.Invalid, "invalid work budget: %d", conf.WorkBudget)
+		}
+		if conf.ReleaseAfter < 0 {
+			return nil, errorf(errors.Invalid, "invalid release count: %d", conf.ReleaseAfter)
+		}
+		br.budget = conf.WorkBudget
+		br.relAfter = conf.ReleaseAfter
+	}
 	br.Reset(r)
 	return br, nil
 }
 
 func (br *Reader) Read(buf []byte) (int, error) {
+	// The dictionary limits each step to budget bytes of output. Steps that
+	// produce no output are never interrupted, so that Read always makes
+	// progress unless an error occurs.
 	for {
 		if len(br.toRead) > 0 {
 			cnt := copy(buf, br.toRead)
@@ -88,17 +124,76 @@ func (br *Reader) Read(buf []byte) (int, error) {
 		if br.err != nil {
 			return 0, br.err
 		}
+		br.doStep()
+	}
+}
 
-		// Perform next step in decompression process.
-		br.rd.offset = br.InputOffset
-		func() {
-			defer errors.Recover(&br.err)
-			br.step(br)
-		}()
-		br.InputOffset = br.rd.FlushOffset()
+// Buffered reports the number of decompressed bytes that can be obtained from
+// Peek or Discard without performing further decompression work.
+func (br *Reader) Buffered() int {
+	return len(br.toRead)
+}
+
+// Peek returns the next n decompressed bytes without advancing the reader.
+// If n <= Buffered(), then the returned slice aliases the sliding window and
+// no copy is made. Otherwise, the decompressed output is accumulated into an
+// internal buffer until n bytes are available.
+//
+// The result is only valid until the next call to Read, Peek, or Discard.
+func (br *Reader) Peek(n int) ([]byte, error) {
+	if n < 0 {
+		return nil, errInvalid
+	}
+	for len(br.toRead) < n {
 		if br.err != nil {
-			br.toRead = br.dict.ReadFlush() // Flush what's left in case of error
+			return br.toRead, br.err
+		}
+		br.peekBuf = append(br.peekBuf[:0], br.toRead...)
+		br.toRead = nil
+		br.doStep()
+		br.peekBuf = append(br.peekBuf, br.toRead...)
+		br.toRead = br.peekBuf
+	}
+	return br.toRead[:n], nil
+}
+
+// Discard skips the next n decompressed bytes, returning the number of bytes
+// discarded. If Discard skips fewer than n bytes, it also returns an error.
+func (br *Reader) Discard(n int) (int, error) {
+	if n < 0 {
+		return 0, errInvalid
+	}
+	var cnt int
+	for cnt < n {
+		if len(br.toRead) == 0 {
+			if br.err != nil {
+				return cnt, br.err
+			}
+			br.doStep()
+			continue
+		}
+		m := n - cnt
+		if m > len(br.toRead) {
+			m = len(br.toRead)
 		}
+		br.toRead = br.toRead[m:]
+		br.OutputOffset += int64(m)
+		cnt += m
+	}
+	return cnt, nil
+}
+
+// doStep performs the next step in the decompression process.
+// It may only be called when all of toRead has been consumed.
+func (br *Reader) doStep() {
+	br.rd.offset = br.InputOffset
+	func() {
+		defer errors.Recover(&br.err)
+		br.step(br)
+	}()
+	br.InputOffset = br.rd.FlushOffset()
+	if br.err != nil {
+		br.toRead = br.dict.ReadFlush() // Flush what's left in case of error
 	}
 }
 
@@ -111,13 +206,35 @@ func (br *Reader) Close() error {
 	return br.err // Return the persistent error
 }
 
+// Release frees the large buffers held by the Reader, such as the sliding
+// window, leaving them to the garbage collector. Any data not yet read is
+// discarded, and reads fail until Reset is called. The buffers are allocated
+// again as needed by subsequent streams.
+func (br *Reader) Release() {
+	br.dict.Release()
+	br.toRead, br.peekBuf = nil, nil
+	br.err = io.ErrClosedPipe
+}
+
 func (br *Reader) Reset(r io.Reader) error {
+	if br.relAfter > 0 {
+		if br.dict.Oversized() {
+			br.relCnt++
+		} else {
+			br.relCnt = 0
+		}
+		if br.relCnt >= br.relAfter {
+			br.Release()
+			br.relCnt = 0
+		}
+	}
 	*br = Reader{
 		rd:   br.rd,
 		step: (*Reader).readStreamHeader,
 
 		dict:    br.dict,
 		iacBlk:  br.iacBlk,
+		iacCmds: br.iacCmds,
 		litBlk:  br.litBlk,
 		distBlk: br.distBlk,
 		word:    br.word[:0],
@@ -129,8 +246,14 @@ func (br *Reader) Reset(r io.Reader) error {
 		// TODO(dsnet): Should we write meta data somewhere useful?
 		metaWr:  ioutil.Discard,
 		metaBuf: br.metaBuf,
+		peekBuf: br.peekBuf[:0],
+		budget:  br.budget,
+
+		relAfter: br.relAfter,
+		relCnt:   br.relCnt,
 	}
 	br.rd.Init(r)
+	br.dict.SetMaxWrite(br.budget)
 	return nil
 }
 
@@ -147,6 +270,7 @@ func (br *Reader) readStreamHeader() {
 
 // readBlockHeader reads a meta-block header according to RFC section 9.2.
 func (br *Reader) readBlockHeader() {
+	br.blkStart = false
 	if br.last {
 		if br.rd.ReadPads() > 0 {
 			errors.Panic(errCorrupted)
@@ -207,17 +331,34 @@ func (br *Reader) readBlockHeader() {
 
 // readMetaData reads meta data according to RFC section 9.2.
 func (br *Reader) readMetaData() {
-	br.metaRd.R = &br.rd
-	br.metaRd.N = int64(br.blkLen)
-	if br.metaBuf == nil {
-		br.metaBuf = make([]byte, 4096) // Lazy allocate
-	}
-	if cnt, err := io.CopyBuffer(br.metaWr, &br.metaRd, br.metaBuf); err != nil {
-		errors.Panic(err) // Will never panic with io.EOF
-	} else if cnt < int64(br.blkLen) {
-		errors.Panic(io.ErrUnexpectedEOF)
+	if br.blkLen > 0 {
+		if br.metaBuf == nil {
+			br.metaBuf = make([]byte, 4096) // Lazy allocate
+		}
+		buf := br.metaBuf
+		if len(buf) > br.blkLen {
+			buf = buf[:br.blkLen]
+		}
+
+		cnt, err := br.rd.Read(buf)
+		br.blkLen -= cnt
+		if _, werr := br.metaWr.Write(buf[:cnt]); werr != nil {
+			errors.Panic(werr)
+		}
+		if err != nil {
+			if err == io.EOF {
+				err = io.ErrUnexpectedEOF
+			}
+			errors.Panic(err)
+		}
+
+		if br.blkLen > 0 {
+			br.step = (*Reader).readMetaData // We need to continue this work
+			return
+		}
 	}
 	br.step = (*Reader).readBlockHeader
+	br.blkStart = true
 }
 
 // readRawData reads raw data according to RFC section 9.2.
@@ -243,6 +384,7 @@ func (br *Reader) readRawData() {
 		return
 	}
 	br.step = (*Reader).readBlockHeader
+	br.blkStart = true
 }
 
 // readPrefixCodes reads the prefix codes according to RFC section 9.2.
@@ -287,7 +429,7 @@ func (br *Reader) readPrefixCodes() {
 			br.litMap[i] = 0
 		}
 	}
-	br.litMapType = br.litMap[0:] // First block type is zero
+	copy(br.litMapType[:], br.litMap) // First block type is zero
 
 	// Read CMAPD, the distance context map.
 	numDistTrees := int(br.rd.ReadSymbol(&decCounts)) // 1..256
@@ -299,7 +441,7 @@ func (br *Reader) readPrefixCodes() {
 			br.distMap[i] = 0
 		}
 	}
-	br.distMapType = br.distMap[0:] // First block type is zero
+	copy(br.distMapType[:], br.distMap) // First block type is zero
 
 	// Read HTREEL[], HTREEI[], and HTREED[], the arrays of prefix codes.
 	br.litBlk.prefixes = extendDecoders(br.litBlk.prefixes, numLitTrees)
@@ -310,6 +452,10 @@ func (br *Reader) readPrefixCodes() {
 	for i := range br.iacBlk.prefixes {
 		br.rd.ReadPrefixCode(&br.iacBlk.prefixes[i], numIaCSyms)
 	}
+	br.iacCmds = extendCommandDecoders(br.iacCmds, br.iacBlk.numTypes)
+	for i := range br.iacCmds {
+		br.iacCmds[i].Init(&br.iacBlk.prefixes[i])
+	}
 	br.distBlk.prefixes = extendDecoders(br.distBlk.prefixes, numDistTrees)
 	for i := range br.distBlk.prefixes {
 		br.rd.ReadPrefixCode(&br.distBlk.prefixes[i], numDistSyms)
@@ -386,6 +532,18 @@ startCommand:
 			br.readBlockSwitch(&br.iacBlk)
 		}
 		br.iacBlk.typeLen--
+		br.NumSymbols++
+
+		// Fast path: decode the symbol and both extra bits in one lookup.
+		if cmd, ok := br.rd.TryReadCommand(&br.iacCmds[br.iacBlk.types[0]]); ok {
+			br.insLen = int(cmd>>commandInsShift) & commandLenMask
+			br.cpyLen = int(cmd >> commandCpyShift)
+			br.distZero = cmd&commandDistZero != 0
+			if br.insLen > 0 {
+				goto readLiterals
+			}
+			goto readDistance
+		}
 
 		iacTree := &br.iacBlk.prefixes[br.iacBlk.types[0]]
 		iacSym, ok := br.rd.TryReadSymbol(iacTree)
@@ -422,13 +580,13 @@ readLiterals:
 		for i := range buf {
 			if br.litBlk.typeLen == 0 {
 				br.readBlockSwitch(&br.litBlk)
-				br.litMapType = br.litMap[64*int(br.litBlk.types[0]):]
+				copy(br.litMapType[:], br.litMap[64*int(br.litBlk.types[0]):])
 				br.cmode = br.cmodes[br.litBlk.types[0]] // 0..3
 			}
 			br.litBlk.typeLen--
 
 			litCID := getLitContextID(p1, p2, br.cmode) // 0..63
-			litTree := &br.litBlk.prefixes[br.litMapType[litCID]]
+			litTree := &br.litBlk.prefixes[br.litMapType[litCID&63]]
 			litSym, ok := br.rd.TryReadSymbol(litTree)
 			if !ok {
 				litSym = br.rd.ReadSymbol(litTree)
@@ -440,6 +598,7 @@ readLiterals:
 		}
 		br.insLen -= len(buf)
 		br.blkLen -= len(buf)
+		br.NumSymbols += int64(len(buf))
 
 		if br.insLen > 0 {
 			br.toRead = br.dict.ReadFlush()
@@ -461,12 +620,12 @@ readDistance:
 		} else {
 			if br.distBlk.typeLen == 0 {
 				br.readBlockSwitch(&br.distBlk)
-				br.distMapType = br.distMap[4*int(br.distBlk.types[0]):]
+				copy(br.distMapType[:], br.distMap[4*int(br.distBlk.types[0]):])
 			}
 			br.distBlk.typeLen--
 
 			distCID := getDistContextID(br.cpyLen) // 0..3
-			distTree := &br.distBlk.prefixes[br.distMapType[distCID]]
+			distTree := &br.distBlk.prefixes[br.distMapType[distCID&3]]
 			distSym, ok := br.rd.TryReadSymbol(distTree)
 			if !ok {
 				distSym = br.rd.ReadSymbol(distTree)
@@ -474,11 +633,11 @@ readDistance:
 
 			if distSym < 16 { // Short-code
 				rec := distShortLUT[distSym]
-				br.dist = br.dists[rec.index] + rec.delta
+				br.dist = br.dists[rec.index&3] + rec.delta
 			} else if distSym < uint(16+br.ndirect) { // Direct-code
 				br.dist = int(distSym - 15) // 1..ndirect
 			} else { // Long-code
-				rec := distLongLUT[br.npostfix][distSym-uint(16+br.ndirect)]
+				rec := distLongLUT[br.npostfix&3][distSym-uint(16+br.ndirect)]
 				extra, ok := br.rd.TryReadBits(uint(rec.bits))
 				if !ok {
 					extra = br.rd.ReadBits(uint(rec.bits))
@@ -566,6 +725,7 @@ finishCommand:
 	br.toRead = br.dict.ReadFlush()
 	br.step = (*Reader).readBlockHeader
 	br.stepState = stateInit // Next call to readCommands must start here
+	br.blkStart = true
 }
 
 // readContextMap reads the context map according to RFC section 7.3.
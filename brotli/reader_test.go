@@ -12,6 +12,7 @@ import (
 	"runtime"
 	"testing"
 
+	"github.com/dsnet/compress"
 	"github.com/dsnet/compress/internal/errors"
 	"github.com/dsnet/compress/internal/testutil"
 )
@@ -542,6 +543,194 @@ func TestReader(t *testing.T) {
 	}
 }
 
+func TestReaderBuffered(t *testing.T) {
+	var _ compress.BufferedReader = (*Reader)(nil)
+	lf := testutil.MustLoadFile
+	for i, name := range []string{"monkey", "alice29.txt", "compressed_repeated", "mapsdatazrh"} {
+		rd, _ := NewReader(bytes.NewReader(lf("testdata/"+name+".br")), nil)
+		output, err := testutil.ReadAllBuffered(rd, i)
+		if err != nil {
+			t.Errorf("test %d, %s\nReadAllBuffered() = %v, want nil", i, name, err)
+		}
+		want := lf("testdata/" + name)
+		if got, want, ok := testutil.BytesCompare(output, want); !ok {
+			t.Errorf("test %d, %s\noutput mismatch:\ngot  %s\nwant %s", i, name, got, want)
+		}
+		if rd.OutputOffset != int64(len(want)) {
+			t.Errorf("test %d, %s\noutput offset mismatch: got %d, want %d", i, name, rd.OutputOffset, len(want))
+		}
+	}
+}
+
+func TestReaderMapped(t *testing.T) {
+	// The MappedReader is a compress.BufferedReader, so the bitReader decodes
+	// directly from the mapping using Peek and Discard.
+	lf := testutil.MustLoadFile
+	for i, name := range []string{"alice29.txt", "mapsdatazrh", "random_org_10k.bin"} {
+		mr, err := compress.OpenMapped("testdata/"+name+".br", compress.AccessSequential)
+		if err != nil {
+			t.Fatalf("test %d, %s\nunexpected OpenMapped error: %v", i, name, err)
+		}
+		rd, err := NewReader(mr, nil)
+		if err != nil {
+			t.Fatalf("test %d, %s\nunexpected NewReader error: %v", i, name, err)
+		}
+		output, err := ioutil.ReadAll(rd)
+		if err != nil {
+			t.Errorf("test %d, %s\nunexpected ReadAll error: %v", i, name, err)
+		}
+		if got, want, ok := testutil.BytesCompare(output, lf("testdata/"+name)); !ok {
+			t.Errorf("test %d, %s\noutput mismatch:\ngot  %s\nwant %s", i, name, got, want)
+		}
+		if rd.InputOffset != mr.Size() || mr.Buffered() != 0 {
+			t.Errorf("test %d, %s\ninput offset mismatch: got (%d, %d unread), want (%d, 0 unread)",
+				i, name, rd.InputOffset, mr.Buffered(), mr.Size())
+		}
+		if err := mr.Close(); err != nil {
+			t.Errorf("test %d, %s\nunexpected Close error: %v", i, name, err)
+		}
+	}
+}
+
+// windowBomb is a stream that uses the largest window size and expands
+// approximately 40 bytes of input into 16MiB of output using a single
+// insert-and-copy command. It forces the dictionary to grow to its maximum
+// size through every intermediate allocation.
+var windowBomb = testutil.MustDecodeBitGen(`<<<
+	<D4:15                       # WBITS: 24
+	1 0                          # ISLAST, ISLASTEMPTY
+	D2:2 D24:16777215            # MNIBBLES: 6, MLEN: 1<<24
+	0 0 0                        # NBLTYPESL, NBLTYPESI, NBLTYPESD: 1
+	D2:0 D4:1                    # NPOSTFIX: 0, NDIRECT: 1
+	D2:0                         # CMODE: LSB6
+	0 0                          # NTREESL, NTREESD: 1
+	D2:1 D2:0 D8:97              # HTREEL: simple, 1 symbol ('a')
+	D2:1 D2:0 D10:399            # HTREEI: simple, 1 symbol (insert: 1, copy: 2118+)
+	D2:1 D2:0 D7:16              # HTREED: simple, 1 symbol (distance: 1)
+	D24:16775097                 # Copy length: 2118 + 16775097 = (1<<24) - 1
+`)
+
+func TestWindowBomb(t *testing.T) {
+	rd, _ := NewReader(bytes.NewReader(windowBomb), nil)
+	n, err := io.Copy(ioutil.Discard, rd)
+	if err != nil || n != 1<<24 {
+		t.Fatalf("Copy() = (%d, %v), want (%d, nil)", n, err, 1<<24)
+	}
+	if err := rd.Close(); err != nil {
+		t.Errorf("Close() = %v, want nil", err)
+	}
+}
+
+func TestReaderWorkBudget(t *testing.T) {
+	// Without a budget, the window bomb is decoded in a few large steps.
+	// With a budget, Read returns every budget bytes.
+	const budget = 4096
+	rd, err := NewReader(bytes.NewReader(windowBomb), &ReaderConfig{WorkBudget: budget})
+	if err != nil {
+		t.Fatalf("unexpected NewReader error: %v", err)
+	}
+	var total int
+	buf := make([]byte, 1<<16)
+	for {
+		n, err := rd.Read(buf)
+		if n > budget {
+			t.Fatalf("Read() = %d, want at most %d", n, budget)
+		}
+		total += n
+		if err == io.EOF {
+			break
+		}
+		if err != nil {
+			t.Fatalf("unexpected Read error: %v", err)
+		}
+	}
+	if total != 1<<24 {
+		t.Errorf("total output = %d, want %d", total, 1<<24)
+	}
+	if rd.NumSymbols != 2 {
+		t.Errorf("NumSymbols = %d, want 2", rd.NumSymbols) // One command and one literal
+	}
+
+	lf := testutil.MustLoadFile
+	rd.Reset(bytes.NewReader(lf("testdata/alice29.txt.br")))
+	output, err := ioutil.ReadAll(rd)
+	if err != nil {
+		t.Errorf("unexpected ReadAll error: %v", err)
+	}
+	if got, want, ok := testutil.BytesCompare(output, lf("testdata/alice29.txt")); !ok {
+		t.Errorf("output mismatch:\ngot  %s\nwant %s", got, want)
+	}
+
+	if _, err := NewReader(nil, &ReaderConfig{WorkBudget: -1}); err == nil {
+		t.Errorf("NewReader(WorkBudget: -1) = nil, want error")
+	}
+}
+
+func TestReaderRelease(t *testing.T) {
+	lf := testutil.MustLoadFile
+	alice, aliceBr := lf("testdata/alice29.txt"), lf("testdata/alice29.txt.br")
+	rd, err := NewReader(bytes.NewReader(windowBomb), &ReaderConfig{ReleaseAfter: 2})
+	if err != nil {
+		t.Fatalf("unexpected NewReader error: %v", err)
+	}
+	if _, err := io.Copy(ioutil.Discard, rd); err != nil {
+		t.Fatalf("unexpected Copy error: %v", err)
+	}
+	if cap(rd.dict.hist) < 1<<23 {
+		t.Fatalf("cap(hist) = %d, want at least %d", cap(rd.dict.hist), 1<<23)
+	}
+
+	// The window is only released by the Reset following the second stream
+	// that needed much less of it.
+	for i := 0; i < 3; i++ {
+		rd.Reset(bytes.NewReader(aliceBr))
+		output, err := ioutil.ReadAll(rd)
+		if err != nil {
+			t.Errorf("test %d, unexpected ReadAll error: %v", i, err)
+		}
+		if got, want, ok := testutil.BytesCompare(output, alice); !ok {
+			t.Errorf("test %d, output mismatch:\ngot  %s\nwant %s", i, got, want)
+		}
+		if got, want := cap(rd.dict.hist) >= 1<<23, i < 2; got != want {
+			t.Errorf("test %d, large window retained = %v, want %v", i, got, want)
+		}
+	}
+
+	rd.Release()
+	if cap(rd.dict.hist) != 0 {
+		t.Errorf("cap(hist) = %d, want 0", cap(rd.dict.hist))
+	}
+	if _, err := rd.Read(make([]byte, 1)); err == nil {
+		t.Errorf("Read() after Release = nil, want error")
+	}
+	rd.Reset(bytes.NewReader(aliceBr))
+	output, err := ioutil.ReadAll(rd)
+	if err != nil {
+		t.Errorf("unexpected ReadAll error: %v", err)
+	}
+	if got, want, ok := testutil.BytesCompare(output, alice); !ok {
+		t.Errorf("output mismatch:\ngot  %s\nwant %s", got, want)
+	}
+
+	if _, err := NewReader(nil, &ReaderConfig{ReleaseAfter: -1}); err == nil {
+		t.Errorf("NewReader(ReleaseAfter: -1) = nil, want error")
+	}
+}
+
+func BenchmarkDecodeWindowBomb(b *testing.B) {
+	b.ReportAllocs()
+	b.SetBytes(1 << 24)
+	br := new(bytes.Reader)
+	rd := new(Reader)
+	for i := 0; i < b.N; i++ {
+		br.Reset(windowBomb)
+		rd.Reset(br)
+		if n, err := io.Copy(ioutil.Discard, rd); n != 1<<24 || err != nil {
+			b.Fatalf("Copy() = (%d, %v), want (%d, nil)", n, err, 1<<24)
+		}
+	}
+}
+
 func benchmarkDecode(b *testing.B, testfile string) {
 	b.StopTimer()
 	b.ReportAllocs()
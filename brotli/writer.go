@@ -4,32 +4,398 @@
 
 package brotli
 
-import "io"
+import (
+	"io"
+	"runtime"
+	"sync"
 
-type writer struct {
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// The Writer splits the input into fixed-size segments, each of which is
+// encoded as a separate meta-block. Since meta-blocks only depend on prior
+// output through the sliding window and the last distances (which the encoder
+// never relies upon across meta-blocks), segments can be encoded concurrently.
+// Each segment is primed with the data that precedes it, such that matches may
+// reach back into the previous segment. Every segment is terminated by an empty
+// metadata block to achieve byte-alignment so that the output of all segments
+// can simply be concatenated.
+//
+// Since segment boundaries only depend on the input, the output is identical
+// regardless of the concurrency used.
+
+const (
+	// The window must be larger than primeSize+segmentSize so that every
+	// match found within a segment is a valid backward reference.
+	winBits     = 22                  // Window size used in the stream header
+	maxDist     = (1 << winBits) - 16 // Maximum backward distance
+	segmentSize = 1 << 20             // Uncompressed size of each segment
+	primeSize   = 1 << 20             // History available to each segment
+	maxBufSize  = primeSize + 64<<20  // Upper bound on buffered input
+)
+
+// levelParams contains the match finder parameters for each level.
+var levelParams = [...]struct {
+	chainLen int
+	lazy     bool
+}{
+	BestSpeed:          {1, false},
+	2:                  {2, false},
+	3:                  {4, false},
+	4:                  {8, true},
+	5:                  {16, true},
+	DefaultCompression: {32, true},
+	7:                  {64, true},
+	8:                  {128, true},
+	BestCompression:    {256, true},
+}
+
+type Writer struct {
 	InputOffset  int64 // Total number of bytes issued to Write
 	OutputOffset int64 // Total number of bytes written to underlying io.Writer
 
-	wr  bitWriter // Output destination
-	err error     // Persistent error
+	wr    bitWriter // Output destination
+	err   error     // Persistent error
+	level int       // The current compression level
+	conc  int       // Number of segments to encode concurrently
+	wrHdr bool      // Have we written the stream header?
+
+	buf  []byte           // History followed by pending input
+	hist int              // Number of bytes of history in buf
+	encs []segmentEncoder // Encoder for each concurrent segment
 }
 
-type writerConfig struct {
+type WriterConfig struct {
+	Level int
+
+	// Concurrency is the maximum number of segments to encode in parallel.
+	// If zero, then runtime.GOMAXPROCS(0) is used.
+	Concurrency int
+
 	_ struct{} // Blank field to prevent unkeyed struct literals
 }
 
-func newWriter(w io.Writer, conf *writerConfig) (*writer, error) {
-	return nil, nil
+func NewWriter(w io.Writer, conf *WriterConfig) (*Writer, error) {
+	var lvl, conc int
+	if conf != nil {
+		lvl = conf.Level
+		conc = conf.Concurrency
+	}
+	if lvl == 0 {
+		lvl = DefaultCompression
+	}
+	if lvl < BestSpeed || lvl > BestCompression {
+		return nil, errorf(errors.Invalid, "compression level: %d", lvl)
+	}
+	if conc == 0 {
+		conc = runtime.GOMAXPROCS(0)
+	}
+	if conc < 0 {
+		return nil, errorf(errors.Invalid, "concurrency: %d", conc)
+	}
+	if primeSize+conc*segmentSize > maxBufSize {
+		conc = (maxBufSize - primeSize) / segmentSize
+	}
+	bw := new(Writer)
+	bw.level = lvl
+	bw.conc = conc
+	bw.Reset(w)
+	return bw, nil
+}
+
+func (bw *Writer) Write(buf []byte) (int, error) {
+	if bw.err != nil {
+		return 0, bw.err
+	}
+
+	cnt := len(buf)
+	for len(buf) > 0 {
+		bufSize := bw.hist + bw.conc*segmentSize
+		n := bufSize - len(bw.buf)
+		if n > len(buf) {
+			n = len(buf)
+		}
+		bw.buf = append(bw.buf, buf[:n]...)
+		buf = buf[n:]
+		if len(bw.buf) == bufSize {
+			if bw.err = bw.flush(false); bw.err != nil {
+				return 0, bw.err
+			}
+		}
+	}
+	bw.InputOffset += int64(cnt)
+	return cnt, nil
 }
 
-func (bw *writer) Write(buf []byte) (int, error) {
-	return 0, nil
+// flush encodes all complete segments in the buffer. If final is set, then
+// any trailing partial segment is encoded as well.
+func (bw *Writer) flush(final bool) error {
+	pending := len(bw.buf) - bw.hist
+	numSegs := pending / segmentSize
+	if final && pending%segmentSize > 0 {
+		numSegs++
+	}
+	if numSegs == 0 {
+		return nil
+	}
+
+	var wg sync.WaitGroup
+	for i := 0; i < numSegs; i++ {
+		segStart := bw.hist + i*segmentSize
+		segEnd := segStart + segmentSize
+		if segEnd > len(bw.buf) {
+			segEnd = len(bw.buf)
+		}
+		base := segStart - primeSize
+		if base < 0 {
+			base = 0
+		}
+		se, buf, hdr := &bw.encs[i], bw.buf[base:segEnd], i == 0 && !bw.wrHdr
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			se.Encode(buf, segStart-base, hdr, bw.level)
+		}()
+	}
+	wg.Wait()
+	bw.wrHdr = true
+
+	// Write out all segments in order.
+	for i := range bw.encs[:numSegs] {
+		se := &bw.encs[i]
+		if se.err != nil {
+			return errWrap(se.err, errors.Internal)
+		}
+		if _, err := bw.wr.Write(se.bw.Bytes()); err != nil {
+			return errWrap(err, errors.Internal)
+		}
+		var err error
+		if bw.OutputOffset, err = bw.wr.Flush(); err != nil {
+			return errWrap(err, errors.Internal)
+		}
+	}
+
+	// Retain the tail of the input as history for the next segment.
+	keep := primeSize
+	if keep > len(bw.buf) {
+		keep = len(bw.buf)
+	}
+	bw.buf = bw.buf[:copy(bw.buf, bw.buf[len(bw.buf)-keep:])]
+	bw.hist = keep
+	return nil
 }
 
-func (bw *writer) Close() error {
+func (bw *Writer) Close() error {
+	if bw.err == errClosed {
+		return nil
+	}
+	if bw.err != nil {
+		return bw.err
+	}
+
+	// Encode any left-over data.
+	if bw.err = bw.flush(true); bw.err != nil {
+		return bw.err
+	}
+
+	// Write the last meta-block.
+	func() {
+		defer errors.Recover(&bw.err)
+		if !bw.wrHdr {
+			bw.wr.WriteSymbol(&encWinBits, winBits)
+			bw.wrHdr = true
+		}
+		bw.wr.WriteBits(1, 1) // ISLAST
+		bw.wr.WriteBits(1, 1) // ISLASTEMPTY
+		bw.wr.WritePads()
+	}()
+	var err error
+	if bw.OutputOffset, err = bw.wr.Flush(); bw.err == nil {
+		bw.err = err
+	}
+	if bw.err != nil {
+		bw.err = errWrap(bw.err, errors.Internal)
+		return bw.err
+	}
+
+	bw.err = errClosed
 	return nil
 }
 
-func (bw *writer) Reset(w io.Writer) error {
+func (bw *Writer) Reset(w io.Writer) error {
+	*bw = Writer{
+		wr:    bw.wr,
+		level: bw.level,
+		conc:  bw.conc,
+
+		buf:  bw.buf[:0],
+		encs: bw.encs,
+	}
+	bw.wr.Init(w)
+	if len(bw.encs) != bw.conc {
+		bw.encs = make([]segmentEncoder, bw.conc)
+	}
 	return nil
 }
+
+// segmentEncoder encodes a single segment of the input as a meta-block.
+type segmentEncoder struct {
+	bw   bitWriter
+	de   dictEncoder
+	cmds []command
+	err  error
+
+	litCodes  []prefixCode
+	iacCodes  []prefixCode
+	distCodes []prefixCode
+	litEnc    prefixEncoder
+	iacEnc    prefixEncoder
+	distEnc   prefixEncoder
+}
+
+// Encode encodes buf[start:] as a meta-block using buf[:start] as history.
+// If hdr is set, then the stream header is written first.
+// The output is always byte-aligned.
+func (se *segmentEncoder) Encode(buf []byte, start int, hdr bool, lvl int) {
+	se.err = nil
+	se.bw.Init(nil)
+	defer errors.Recover(&se.err)
+
+	if hdr {
+		se.bw.WriteSymbol(&encWinBits, winBits)
+	}
+	se.de.Init(levelParams[lvl].chainLen, levelParams[lvl].lazy)
+	se.cmds = se.de.Encode(se.cmds[:0], buf, start, maxDist)
+	se.encodeMetaBlock(buf[start:], se.cmds)
+
+	// Achieve byte-alignment with an empty metadata block (RFC section 9.2).
+	if se.bw.numBits%8 != 0 {
+		se.bw.WriteBits(0, 1) // ISLAST
+		se.bw.WriteBits(3, 2) // MNIBBLES
+		se.bw.WriteBits(0, 1) // Reserved
+		se.bw.WriteBits(0, 2) // MSKIPBYTES
+		se.bw.WritePads()
+	}
+}
+
+// encodeMetaBlock writes a compressed meta-block for buf according to
+// RFC section 9.2 using a single block type and prefix tree for each category.
+// Only explicit distances are used, such that the meta-block does not depend
+// on the last distances of prior meta-blocks.
+func (se *segmentEncoder) encodeMetaBlock(buf []byte, cmds []command) {
+	// Compute the symbol histograms.
+	var litCnts [numLitSyms]uint32
+	var iacCnts [numIaCSyms]uint32
+	var distCnts [16 + 48]uint32
+	var pos int
+	var lastDist uint32
+	for _, cmd := range cmds {
+		for _, c := range buf[pos : pos+int(cmd.insLen)] {
+			litCnts[c]++
+		}
+		pos += int(cmd.insLen) + int(cmd.cpyLen)
+		iacCnts[iacSymbol(cmd)]++
+		if cmd.cpyLen > 0 {
+			distCnts[distSymbol(cmd.dist, lastDist)]++
+			lastDist = cmd.dist
+		}
+	}
+
+	se.litCodes = buildPrefixCodes(se.litCodes[:0], litCnts[:], maxPrefixBits)
+	se.iacCodes = buildPrefixCodes(se.iacCodes[:0], iacCnts[:], maxPrefixBits)
+	se.distCodes = buildPrefixCodes(se.distCodes[:0], distCnts[:], maxPrefixBits)
+	se.litEnc.Init(se.litCodes)
+	se.iacEnc.Init(se.iacCodes)
+	se.distEnc.Init(se.distCodes)
+
+	// Write the meta-block header.
+	bw := &se.bw
+	mlen := uint(len(buf) - 1)
+	nibbles := uint(4)
+	for mlen>>(4*nibbles) > 0 {
+		nibbles++
+	}
+	bw.WriteBits(0, 1) // ISLAST
+	bw.WriteBits(nibbles-4, 2)
+	bw.WriteBits(mlen, 4*nibbles)
+	bw.WriteBits(0, 1)            // ISUNCOMPRESSED
+	bw.WriteSymbol(&encCounts, 1) // NBLTYPESL
+	bw.WriteSymbol(&encCounts, 1) // NBLTYPESI
+	bw.WriteSymbol(&encCounts, 1) // NBLTYPESD
+	bw.WriteBits(0, 2)            // NPOSTFIX
+	bw.WriteBits(0, 4)            // NDIRECT
+	bw.WriteBits(0, 2)            // CMODE
+	bw.WriteSymbol(&encCounts, 1) // NTREESL
+	bw.WriteSymbol(&encCounts, 1) // NTREESD
+	bw.WritePrefixCode(se.litCodes, numLitSyms)
+	bw.WritePrefixCode(se.iacCodes, numIaCSyms)
+	bw.WritePrefixCode(se.distCodes, 16+48)
+
+	// Write the commands.
+	pos, lastDist = 0, 0
+	for _, cmd := range cmds {
+		iacSym := iacSymbol(cmd)
+		bw.WriteSymbol(&se.iacEnc, iacSym)
+		rec := iacLUT[iacSym]
+		bw.WriteBits(uint(cmd.insLen-rec.ins.base), uint(rec.ins.bits))
+		if cmd.cpyLen > 0 {
+			bw.WriteBits(uint(cmd.cpyLen-rec.cpy.base), uint(rec.cpy.bits))
+		} else {
+			bw.WriteBits(0, uint(rec.cpy.bits)) // Ignored by the decoder
+		}
+		for _, c := range buf[pos : pos+int(cmd.insLen)] {
+			bw.WriteSymbol(&se.litEnc, uint(c))
+		}
+		pos += int(cmd.insLen) + int(cmd.cpyLen)
+		if cmd.cpyLen > 0 {
+			distSym := distSymbol(cmd.dist, lastDist)
+			bw.WriteSymbol(&se.distEnc, distSym)
+			if distSym >= 16 {
+				bw.WriteOffset(distSym-16, uint(cmd.dist), distLongLUT[0])
+			}
+			lastDist = cmd.dist
+		}
+	}
+}
+
+// iacSymbol computes the insert-and-copy length symbol for cmd according to
+// RFC section 5. The implicit zero distance symbols (0..127) are never used.
+// A command without a copy uses the shortest copy length, which the decoder
+// ignores since the meta-block ends after the insert.
+func iacSymbol(cmd command) uint {
+	insSym := lengthSymbol(cmd.insLen, insLenRanges)
+	cpySym := uint(0)
+	if cmd.cpyLen > 0 {
+		cpySym = lengthSymbol(cmd.cpyLen, cpyLenRanges)
+	}
+	return iacBases[insSym>>3][cpySym>>3] + (insSym&7)<<3 + cpySym&7
+}
+
+// iacBases maps the upper bits of the insert and copy symbols to the base
+// insert-and-copy symbol with an explicit distance code.
+var iacBases = [3][3]uint{
+	{128, 192, 384},
+	{256, 320, 512},
+	{448, 576, 640},
+}
+
+// lengthSymbol returns the symbol whose range contains n.
+func lengthSymbol(n uint32, rcs []rangeCode) uint {
+	sym := len(rcs) - 1
+	for rcs[sym].base > n {
+		sym--
+	}
+	return uint(sym)
+}
+
+// distSymbol computes the distance symbol for dist according to RFC section 4,
+// assuming that NPOSTFIX and NDIRECT are both zero.
+func distSymbol(dist, lastDist uint32) uint {
+	if dist == lastDist {
+		return 0 // Last distance used
+	}
+	v := uint(dist) + 3
+	nbits := neededBits(uint32(v)+1) - 2 // Bit-length of v minus two
+	hi := v >> nbits & 1
+	return 16 + 2*(nbits-1) + hi
+}
@@ -3,3 +3,119 @@
 // license that can be found in the LICENSE.md file.
 
 package brotli
+
+import (
+	"bytes"
+	"io"
+	"io/ioutil"
+	"testing"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+func TestWriter(t *testing.T) {
+	lf := testutil.MustLoadFile
+	rand := testutil.NewRand(0)
+	large := append(lf("../testdata/twain.txt"), rand.Bytes(1<<20)...)
+	large = append(large, bytes.Repeat(lf("../testdata/digits.txt"), 4)...)
+
+	vectors := []struct {
+		desc  string
+		input []byte
+	}{
+		{"empty", nil},
+		{"single byte", []byte("a")},
+		{"short", []byte("hello, world")},
+		{"zeros", lf("../testdata/zeros.bin")},
+		{"random", lf("../testdata/random.bin")},
+		{"repeats", lf("../testdata/repeats.bin")},
+		{"huffman", lf("../testdata/huffman.txt")},
+		{"twain", lf("../testdata/twain.txt")},
+		{"large", large},
+	}
+
+	for _, v := range vectors {
+		var want []byte
+		for _, conc := range []int{1, 2, 5} {
+			for _, lvl := range []int{BestSpeed, DefaultCompression, BestCompression} {
+				var bb bytes.Buffer
+				wr, err := NewWriter(&bb, &WriterConfig{Level: lvl, Concurrency: conc})
+				if err != nil {
+					t.Fatalf("test %s: NewWriter() = %v", v.desc, err)
+				}
+				if _, err := io.Copy(wr, bytes.NewReader(v.input)); err != nil {
+					t.Errorf("test %s, level %d: Write() = %v", v.desc, lvl, err)
+				}
+				if err := wr.Close(); err != nil {
+					t.Errorf("test %s, level %d: Close() = %v", v.desc, lvl, err)
+				}
+				if wr.InputOffset != int64(len(v.input)) || wr.OutputOffset != int64(bb.Len()) {
+					t.Errorf("test %s, level %d: offsets = (%d, %d), want (%d, %d)",
+						v.desc, lvl, wr.InputOffset, wr.OutputOffset, len(v.input), bb.Len())
+				}
+
+				// The output must not depend on the concurrency.
+				if lvl == DefaultCompression {
+					if want == nil {
+						want = append([]byte(nil), bb.Bytes()...)
+					} else if !bytes.Equal(bb.Bytes(), want) {
+						t.Errorf("test %s, concurrency %d: output mismatch", v.desc, conc)
+					}
+				}
+
+				rd, _ := NewReader(&bb, nil)
+				got, err := ioutil.ReadAll(rd)
+				if err != nil {
+					t.Errorf("test %s, level %d: ReadAll() = %v", v.desc, lvl, err)
+				}
+				if !bytes.Equal(got, v.input) {
+					t.Errorf("test %s, level %d: output mismatch", v.desc, lvl)
+				}
+			}
+		}
+	}
+}
+
+func benchmarkEncode(b *testing.B, testfile string, lvl int) {
+	b.StopTimer()
+	b.ReportAllocs()
+
+	input := testutil.MustLoadFile(testfile)
+	input = bytes.Repeat(input, 1+(8<<20)/len(input))
+	br := new(bytes.Reader)
+	wr, _ := NewWriter(nil, &WriterConfig{Level: lvl})
+
+	b.SetBytes(int64(len(input)))
+	b.StartTimer()
+	for i := 0; i < b.N; i++ {
+		br.Reset(input)
+		wr.Reset(ioutil.Discard)
+
+		n, err := io.Copy(wr, br)
+		if n != int64(len(input)) || err != nil {
+			b.Fatalf("Copy() = (%d, %v), want (%d, nil)", n, err, len(input))
+		}
+		if err := wr.Close(); err != nil {
+			b.Fatalf("Close() = %v, want nil", err)
+		}
+	}
+}
+
+func BenchmarkEncodeDigitsSpeed(b *testing.B) {
+	benchmarkEncode(b, "../testdata/digits.txt", BestSpeed)
+}
+func BenchmarkEncodeDigitsDefault(b *testing.B) {
+	benchmarkEncode(b, "../testdata/digits.txt", DefaultCompression)
+}
+func BenchmarkEncodeDigitsCompress(b *testing.B) {
+	benchmarkEncode(b, "../testdata/digits.txt", BestCompression)
+}
+func BenchmarkEncodeTwainSpeed(b *testing.B) {
+	benchmarkEncode(b, "../testdata/twain.txt", BestSpeed)
+}
+func BenchmarkEncodeTwainDefault(b *testing.B) {
+	benchmarkEncode(b, "../testdata/twain.txt", DefaultCompression)
+}
+func BenchmarkEncodeTwainCompress(b *testing.B) {
+	benchmarkEncode(b, "../testdata/twain.txt", BestCompression)
+}
@@ -25,6 +25,19 @@ type burrowsWheelerTransform struct {
 }
 
 func (bwt *burrowsWheelerTransform) Encode(buf []byte) (ptr int) {
+	return bwt.EncodeFunc(buf, nil)
+}
+
+// bwtChunkSize is the number of transformed bytes handed to the callback of
+// EncodeFunc at a time. It is small enough that the chunk is still in the L1
+// cache when the callback processes it.
+const bwtChunkSize = 1 << 12
+
+// EncodeFunc is identical to Encode, except that emit (if non-nil) is called
+// on every chunk of buf as soon as its transformation is complete. This allows
+// the following stages to consume the output while it is still in cache,
+// instead of making another pass over the whole block afterwards.
+func (bwt *burrowsWheelerTransform) EncodeFunc(buf []byte, emit func([]byte)) (ptr int) {
 	if len(buf) == 0 {
 		return -1
 	}
@@ -52,7 +65,7 @@ func (bwt *burrowsWheelerTransform) Encode(buf []byte) (ptr int) {
 	// Step 3: Convert the SA to a BWT. Since ComputeSA does not mutate the
 	// input, we have two copies of the input; in buf and buf2. Thus, we write
 	// the transformation to buf, while using buf2.
-	var j int
+	var j, k int // Output is complete up to j, and emitted up to k
 	buf2 := t[n:]
 	for _, i := range sa {
 		if i < n {
@@ -62,11 +75,20 @@ func (bwt *burrowsWheelerTransform) Encode(buf []byte) (ptr int) {
 			}
 			buf[j] = buf2[i-1]
 			j++
+			if j-k == bwtChunkSize && emit != nil {
+				emit(buf[k:j])
+				k = j
+			}
 		}
 	}
+	if k < j && emit != nil {
+		emit(buf[k:j])
+	}
 	return ptr
 }
 
+// Decode inverts the BWT of buf in place, starting at the origin pointer ptr.
+// The length of buf must be less than 1<<24, which holds for all bzip2 blocks.
 func (bwt *burrowsWheelerTransform) Decode(buf []byte, ptr int) {
 	if len(buf) == 0 {
 		return
@@ -85,26 +107,23 @@ func (bwt *burrowsWheelerTransform) Decode(buf []byte, ptr int) {
 	}
 
 	// Step 2: Compute perm, where perm[ptr] contains a pointer to the next
-	// byte in buf and the next pointer in perm itself.
+	// byte in buf and the next pointer in perm itself. The byte itself is
+	// packed into the lower 8 bits, which avoids a dependent lookup into buf
+	// and allows the output to be written directly over buf.
 	if cap(bwt.perm) < len(buf) {
 		bwt.perm = make([]uint32, len(buf))
 	}
 	perm := bwt.perm[:len(buf)]
 	for i, b := range buf {
-		perm[cumm[b]] = uint32(i)
+		perm[cumm[b]] = uint32(i)<<8 | uint32(b)
 		cumm[b]++
 	}
 
 	// Step 3: Follow each pointer in perm to the next byte, starting with the
 	// origin pointer.
-	if cap(bwt.buf) < len(buf) {
-		bwt.buf = make([]byte, len(buf))
-	}
-	buf2 := bwt.buf[:len(buf)]
-	i := perm[ptr]
-	for j := range buf2 {
-		buf2[j] = buf[i]
-		i = perm[i]
+	v := perm[ptr]
+	for j := range buf {
+		buf[j] = byte(v)
+		v = perm[v>>8]
 	}
-	copy(buf, buf2)
 }
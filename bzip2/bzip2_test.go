@@ -13,6 +13,7 @@ import (
 	"strings"
 	"testing"
 
+	"github.com/dsnet/compress"
 	"github.com/dsnet/compress/internal/testutil"
 )
 
@@ -139,6 +140,28 @@ func TestRoundTrip(t *testing.T) {
 	}
 }
 
+func TestBufferedOutput(t *testing.T) {
+	var _ compress.BufferedReader = (*Reader)(nil)
+	for i, v := range testdata {
+		var buf bytes.Buffer
+		wr, _ := NewWriter(&buf, &WriterConfig{Level: BestSpeed})
+		wr.Write(v.data)
+		wr.Close()
+
+		rd, _ := NewReader(&buf, nil)
+		output, err := testutil.ReadAllBuffered(rd, i)
+		if err != nil {
+			t.Errorf("test %d, ReadAllBuffered() = %v, want nil", i, err)
+		}
+		if got, want, ok := testutil.BytesCompare(output, v.data); !ok {
+			t.Errorf("test %d, output data mismatch:\ngot  %s\nwant %s", i, got, want)
+		}
+		if rd.OutputOffset != int64(len(v.data)) {
+			t.Errorf("test %d, output offset mismatch: got %d, want %d", i, rd.OutputOffset, len(v.data))
+		}
+	}
+}
+
 func runBenchmarks(b *testing.B, f func(b *testing.B, buf []byte, lvl int)) {
 	for _, td := range testdata {
 		if len(td.data) == 0 {
@@ -157,3 +180,27 @@ func runBenchmarks(b *testing.B, f func(b *testing.B, buf []byte, lvl int)) {
 		}
 	}
 }
+
+// worstCases are inputs that are degenerate for some stage of the compression
+// stack, such as suffix sorting in the BWT or prefix tree construction.
+// They are generated only when benchmarks ask for them.
+var worstCases = []struct {
+	name string
+	gen  func() []byte
+}{
+	{"FibonacciWord", func() []byte { return testutil.FibonacciWord(1e6) }},
+	{"FibonacciFreqs", func() []byte { return testutil.FibonacciFreqs(1e6) }},
+	{"Periodic", func() []byte { return bytes.Repeat([]byte("abcdefghijklmnopqrstuvwxyz"), 38462) }},
+	{"Runs", func() []byte { return bytes.Repeat(append(bytes.Repeat([]byte{'a'}, 251), 'b'), 3969) }},
+}
+
+func runWorstCaseBenchmarks(b *testing.B, f func(b *testing.B, buf []byte, lvl int)) {
+	for _, wc := range worstCases {
+		buf := wc.gen()
+		for _, tl := range levels {
+			b.Run(wc.name+"/"+tl.name, func(b *testing.B) {
+				f(b, buf, tl.level)
+			})
+		}
+	}
+}
@@ -0,0 +1,129 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package bzip2
+
+import (
+	"encoding/binary"
+	"io"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+const checkpointVersion = 1
+
+var errNoCheckpoint = errorf(errors.Invalid, "reader is not at a block boundary")
+
+// Checkpoint is a snapshot of the state of a Reader at a block boundary.
+// It allows decompression to resume at that point with a new Reader, without
+// decompressing any of the preceding data.
+//
+// Since bzip2 blocks are independent of each other, the only state carried
+// across blocks is the position of the next block and the checksums needed
+// to verify the remainder of the stream.
+type Checkpoint struct {
+	InputOffset  int64 // Offset of the byte containing the start of the block
+	OutputOffset int64 // Offset of the decompressed data that the block produces
+
+	bits     uint8  // Number of bits of the byte at InputOffset already consumed
+	level    uint8  // The current compression level
+	rdHdrFtr uint64 // Number of times the stream header and footer were read
+	blkCRC   uint32 // CRC-32 IEEE of the previous block (as stored)
+	crcVal   uint32 // CRC-32 IEEE of the previous block (as computed)
+	endCRC   uint32 // Checksum of all blocks prior to the previous block
+}
+
+// MarshalBinary encodes the checkpoint in a compact binary form.
+func (cp *Checkpoint) MarshalBinary() ([]byte, error) {
+	var b [binary.MaxVarintLen64]byte
+	buf := make([]byte, 0, 3+6*len(b))
+	buf = append(buf, checkpointVersion, cp.bits, cp.level)
+	for _, v := range []uint64{
+		uint64(cp.InputOffset), uint64(cp.OutputOffset), cp.rdHdrFtr,
+		uint64(cp.blkCRC), uint64(cp.crcVal), uint64(cp.endCRC),
+	} {
+		buf = append(buf, b[:binary.PutUvarint(b[:], v)]...)
+	}
+	return buf, nil
+}
+
+// UnmarshalBinary decodes a checkpoint produced by MarshalBinary.
+func (cp *Checkpoint) UnmarshalBinary(buf []byte) error {
+	if len(buf) < 3 || buf[0] != checkpointVersion || buf[1] >= 8 || buf[2] > BestCompression {
+		return errorf(errors.Corrupted, "invalid checkpoint header")
+	}
+	bits, level, buf := buf[1], buf[2], buf[3:]
+	var vals [6]uint64
+	for i := range vals {
+		v, n := binary.Uvarint(buf)
+		if n <= 0 || int64(v) < 0 || (i >= 3 && v > 1<<32-1) {
+			return errorf(errors.Corrupted, "invalid checkpoint value")
+		}
+		vals[i], buf = v, buf[n:]
+	}
+	if len(buf) > 0 {
+		return errorf(errors.Corrupted, "invalid checkpoint trailer")
+	}
+	*cp = Checkpoint{
+		InputOffset:  int64(vals[0]),
+		OutputOffset: int64(vals[1]),
+		bits:         bits,
+		level:        level,
+		rdHdrFtr:     vals[2],
+		blkCRC:       uint32(vals[3]),
+		crcVal:       uint32(vals[4]),
+		endCRC:       uint32(vals[5]),
+	}
+	return nil
+}
+
+// Checkpoint returns a snapshot of the Reader's state, which is only possible
+// when all of the data in the current block has been decompressed. The
+// checkpoint resumes output after all of the data decompressed so far,
+// including any buffered data that has not yet been read.
+func (zr *Reader) Checkpoint() (*Checkpoint, error) {
+	rle := &zr.rle
+	if zr.err != nil || rle.idx < len(rle.buf) || rle.repCnt > 0 || rle.lastCnt == 4 {
+		return nil, errNoCheckpoint
+	}
+	pos := zr.rd.BitsRead()
+	return &Checkpoint{
+		InputOffset:  pos / 8,
+		OutputOffset: zr.OutputOffset + int64(len(zr.toRead)),
+		bits:         uint8(pos % 8),
+		level:        uint8(zr.level),
+		rdHdrFtr:     uint64(zr.rdHdrFtr),
+		blkCRC:       zr.blkCRC,
+		crcVal:       zr.crc.val,
+		endCRC:       zr.endCRC,
+	}, nil
+}
+
+// Restore discards the Reader's state and resumes decompression from the
+// checkpoint, reading from r. The caller must position r at cp.InputOffset
+// in the compressed stream. Afterwards, the Reader's offsets are relative to
+// the start of the original stream.
+func (zr *Reader) Restore(r io.Reader, cp *Checkpoint) error {
+	zr.Reset(r)
+	zr.rle.Init(nil)
+	zr.InputOffset, zr.OutputOffset = cp.InputOffset, cp.OutputOffset
+	zr.level = int(cp.level)
+	zr.rdHdrFtr = int(cp.rdHdrFtr)
+	zr.blkCRC, zr.crc.val, zr.endCRC = cp.blkCRC, cp.crcVal, cp.endCRC
+
+	// Skip the bits of the first byte that belong to the prior block.
+	zr.rd.Offset = zr.InputOffset
+	func() {
+		defer errors.Recover(&zr.err)
+		zr.rd.ReadBits(uint(cp.bits))
+	}()
+	var err error
+	if zr.InputOffset, err = zr.rd.Flush(); zr.err == nil {
+		zr.err = err
+	}
+	if zr.err != nil {
+		zr.err = errWrap(zr.err, errors.Corrupted)
+	}
+	return zr.err
+}
@@ -0,0 +1,107 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package bzip2
+
+import (
+	"bufio"
+	"bytes"
+	"io"
+	"io/ioutil"
+	"testing"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+func TestCheckpoint(t *testing.T) {
+	compress := func(b []byte, lvl int) []byte {
+		var bb bytes.Buffer
+		zw, _ := NewWriter(&bb, &WriterConfig{Level: lvl})
+		zw.Write(b)
+		zw.Close()
+		return bb.Bytes()
+	}
+
+	lf := testutil.MustLoadFile
+	twain := lf("../testdata/twain.txt")
+	digits := lf("../testdata/digits.txt")
+	vectors := []struct {
+		desc   string
+		input  []byte
+		output []byte
+	}{
+		{"twain", compress(twain, BestSpeed), twain}, // Multiple blocks
+		{"concatenated", append(compress(digits, BestSpeed), compress(twain, BestSpeed)...), append(digits, twain...)},
+	}
+
+	for i, v := range vectors {
+		// Collect checkpoints while reading with small buffers.
+		var cps []*Checkpoint
+		zr, _ := NewReader(bytes.NewReader(v.input), nil)
+		buf := make([]byte, 1<<12)
+		for {
+			_, err := zr.Read(buf)
+			if err == io.EOF {
+				break
+			}
+			if err != nil {
+				t.Fatalf("test %d (%s): Read() = %v", i, v.desc, err)
+			}
+			if cp, err := zr.Checkpoint(); err == nil {
+				cps = append(cps, cp)
+			} else if err != errNoCheckpoint {
+				t.Fatalf("test %d (%s): Checkpoint() = %v", i, v.desc, err)
+			}
+		}
+		if len(cps) < 2 {
+			t.Errorf("test %d (%s): got %d checkpoints, want at least 2", i, v.desc, len(cps))
+		}
+
+		// Resume from each checkpoint after a round-trip through its binary
+		// encoding, using both buffered and unbuffered inputs.
+		for j, cp := range cps {
+			b, _ := cp.MarshalBinary()
+			cp = new(Checkpoint)
+			if err := cp.UnmarshalBinary(b); err != nil {
+				t.Fatalf("test %d (%s), checkpoint %d: UnmarshalBinary() = %v", i, v.desc, j, err)
+			}
+			var r io.Reader = struct{ io.Reader }{bytes.NewReader(v.input[cp.InputOffset:])}
+			if j%2 == 1 {
+				r = bufio.NewReader(r)
+			}
+			zr := new(Reader)
+			if err := zr.Restore(r, cp); err != nil {
+				t.Fatalf("test %d (%s), checkpoint %d: Restore() = %v", i, v.desc, j, err)
+			}
+			got, err := ioutil.ReadAll(zr)
+			if err != nil {
+				t.Errorf("test %d (%s), checkpoint %d: ReadAll() = %v", i, v.desc, j, err)
+			}
+			if !bytes.Equal(got, v.output[cp.OutputOffset:]) {
+				t.Errorf("test %d (%s), checkpoint %d: output mismatch", i, v.desc, j)
+			}
+			if zr.InputOffset != int64(len(v.input)) || zr.OutputOffset != int64(len(v.output)) {
+				t.Errorf("test %d (%s), checkpoint %d: offsets = (%d, %d), want (%d, %d)",
+					i, v.desc, j, zr.InputOffset, zr.OutputOffset, len(v.input), len(v.output))
+			}
+		}
+
+		// A checkpoint with the wrong checksum state is detected later.
+		cp := *cps[0]
+		cp.endCRC++
+		zr = new(Reader)
+		zr.Restore(bytes.NewReader(v.input[cp.InputOffset:]), &cp)
+		if _, err := ioutil.ReadAll(zr); err == nil {
+			t.Errorf("test %d (%s): ReadAll() = nil, want checksum error", i, v.desc)
+		}
+	}
+
+	// Malformed checkpoints are rejected.
+	for _, b := range [][]byte{nil, {0, 0, 1, 0, 0, 0, 0, 0, 0}, {checkpointVersion, 0, 10, 0, 0, 0, 0, 0, 0},
+		{checkpointVersion, 0, 1, 0, 0, 0, 0x80, 0x80, 0x80, 0x80, 0x10, 0, 0}, {checkpointVersion, 0, 1, 0, 0, 0, 0, 0, 0, 0}} {
+		if err := new(Checkpoint).UnmarshalBinary(b); err == nil {
+			t.Errorf("UnmarshalBinary(%x) = nil, want error", b)
+		}
+	}
+}
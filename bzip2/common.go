@@ -51,6 +51,8 @@ const (
 	endMagic = 0x177245385090 // BCD of sqrt(PI)
 
 	blockSize = 100000
+
+	minPeekSize = 4096 // Minimum buffer size allocated by Reader.Peek
 )
 
 func errorf(c int, f string, a ...interface{}) error {
@@ -100,8 +102,17 @@ func (c *crc) update(buf []byte) {
 		if n > len(c.buf) {
 			n = len(c.buf)
 		}
-		for i, b := range buf[:n] {
-			c.buf[i] = internal.ReverseLUT[b]
+		i := 0
+		for ; i+8 <= n; i += 8 {
+			// Swap all the bits within each byte, 8 bytes at a time.
+			u := internal.LoadUint64LE(buf[i:])
+			u = (u&0xaaaaaaaaaaaaaaaa)>>1 | (u&0x5555555555555555)<<1
+			u = (u&0xcccccccccccccccc)>>2 | (u&0x3333333333333333)<<2
+			u = (u&0xf0f0f0f0f0f0f0f0)>>4 | (u&0x0f0f0f0f0f0f0f0f)<<4
+			internal.StoreUint64LE(c.buf[i:], u)
+		}
+		for ; i < n; i++ {
+			c.buf[i] = internal.ReverseLUT[buf[i]]
 		}
 		cval = crc32.Update(cval, crc32.IEEETable, c.buf[:n])
 		buf = buf[n:]
@@ -0,0 +1,165 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package bzip2
+
+import (
+	"io"
+
+	"github.com/dsnet/compress/internal"
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// minRetrySize is the amount of available input below which a step that ran
+// out of input is always retried. It is large enough to hold the stream
+// header or footer, which are not followed by a block magic value.
+const minRetrySize = 16
+
+// Decompressor is a push-style bzip2 decompressor. Rather than pulling input
+// from an io.Reader, the caller provides both the input and the output buffer
+// on each call to Decompress, which never blocks. This allows many streams to
+// be multiplexed on a few goroutines.
+//
+// Since bzip2 blocks are decoded as a whole, a block is not decompressed until
+// all of its input has been provided.
+type Decompressor struct {
+	InputOffset  int64 // Total number of bytes consumed from the input
+	OutputOffset int64 // Total number of bytes produced as output
+
+	zr  Reader
+	src internal.PushReader
+
+	// A step that runs out of input is rolled back and must re-decode the
+	// entire block when retried. To avoid quadratic behavior when input arrives
+	// in small pieces, a large step is only retried once the input contains
+	// what appears to be the magic value that starts the next block or footer.
+	wait    bool
+	waitBit int64  // Magic values must start at or after this bit offset
+	scanOff int64  // Offset of the next byte to scan
+	scanWin uint64 // Last 8 bytes scanned
+}
+
+// NewDecompressor returns a new Decompressor.
+// The ReleaseAfter policy of conf applies to Reset in the same way as for
+// Reader.
+func NewDecompressor(conf *ReaderConfig) (*Decompressor, error) {
+	zd := new(Decompressor)
+	if conf != nil {
+		if conf.ReleaseAfter < 0 {
+			return nil, errorf(errors.Invalid, "invalid release count: %d", conf.ReleaseAfter)
+		}
+		zd.zr.relAfter = conf.ReleaseAfter
+	}
+	zd.Reset()
+	return zd, nil
+}
+
+func (zd *Decompressor) Reset() error {
+	*zd = Decompressor{zr: zd.zr, src: zd.src}
+	zd.src.Reset()
+	zd.zr.Reset(&zd.src)
+	return nil
+}
+
+// Decompress decompresses data from in into out, returning the number of
+// bytes consumed from in and the number of bytes produced into out.
+//
+// Input that has been consumed, but cannot be decoded yet (such as a partial
+// block), is retained internally. Thus, the caller must resubmit only
+// in[consumed:] on the next call, which is only non-empty if out was filled.
+//
+// It returns io.EOF when the end of a stream has been reached and no further
+// input is available. Since bzip2 streams may be concatenated, this is not
+// persistent and a subsequent call with more input continues decoding the
+// next stream. A nil error with produced < len(out) means that more input is
+// needed. Any other error is persistent.
+func (zd *Decompressor) Decompress(in, out []byte) (consumed, produced int, err error) {
+	zr := &zd.zr
+	zd.src.Begin(in)
+	var needInput bool
+	for {
+		cnt, err := zr.rle.decode(out[produced:], &zr.crc)
+		if err != rleDone && zr.err == nil {
+			zr.err = err
+		}
+		produced += cnt
+		if zr.err != nil || produced == len(out) {
+			break
+		}
+		if !zd.step() && !zd.src.More() {
+			needInput = !zd.atEOF()
+			break
+		}
+	}
+	consumed = zd.src.End(needInput)
+	zd.InputOffset += int64(consumed)
+	zd.OutputOffset += int64(produced)
+	if zr.err == nil && !needInput && produced < len(out) {
+		return consumed, produced, io.EOF
+	}
+	return consumed, produced, zr.err
+}
+
+// step reads the next block. If the step runs out of input, then all of its
+// effects are undone and it reports false.
+func (zd *Decompressor) step() bool {
+	zr := &zd.zr
+	if !zd.ready() {
+		return false
+	}
+	saved, pos := *zr, zd.src.Mark()
+	zr.doStep()
+	if zr.err != internal.ErrNeedInput {
+		return true
+	}
+	*zr = saved
+	zd.src.Rewind(pos)
+	if zd.src.Buffered() >= minRetrySize {
+		zd.wait = true
+		zd.waitBit = 8*zr.InputOffset + 32 + 48 // Skip stream header and magic
+		zd.scanOff, zd.scanWin = zr.InputOffset, 0
+	}
+	return false
+}
+
+// ready reports whether a step that previously ran out of input should be
+// retried, scanning any new input for magic values.
+func (zd *Decompressor) ready() bool {
+	if !zd.wait {
+		return true
+	}
+	buf, _ := zd.src.Peek(zd.src.Buffered())
+	for _, c := range buf[zd.scanOff-zd.zr.InputOffset:] {
+		zd.scanWin = zd.scanWin<<8 | uint64(c)
+		zd.scanOff++
+		for s := uint(0); s < 8; s++ {
+			switch zd.scanWin >> s & (1<<48 - 1) {
+			case blkMagic, endMagic:
+				if 8*zd.scanOff-int64(s)-48 >= zd.waitBit {
+					zd.wait = false
+					return true
+				}
+			}
+		}
+	}
+	return false
+}
+
+// atEOF reports whether the decompressor is between streams with no input.
+func (zd *Decompressor) atEOF() bool {
+	zr := &zd.zr
+	return zr.rdHdrFtr > 0 && zr.rdHdrFtr%2 == 0 && zd.src.Buffered() == 0
+}
+
+// Close reports io.ErrUnexpectedEOF if the input did not end on a stream
+// boundary, otherwise it returns the persistent error (if any).
+func (zd *Decompressor) Close() error {
+	if zd.zr.err == nil {
+		zd.zr.err = io.ErrUnexpectedEOF
+		if zd.atEOF() {
+			zd.zr.err = io.EOF
+		}
+	}
+	return zd.zr.Close()
+}
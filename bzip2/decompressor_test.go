@@ -0,0 +1,90 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package bzip2
+
+import (
+	"bytes"
+	"io"
+	"testing"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+func TestDecompressor(t *testing.T) {
+	compress := func(b []byte, lvl int) []byte {
+		var bb bytes.Buffer
+		zw, _ := NewWriter(&bb, &WriterConfig{Level: lvl})
+		zw.Write(b)
+		zw.Close()
+		return bb.Bytes()
+	}
+
+	lf := testutil.MustLoadFile
+	twain := lf("../testdata/twain.txt")
+	digits := lf("../testdata/digits.txt")
+	vectors := []struct {
+		desc   string
+		input  []byte
+		output []byte
+	}{
+		{"empty", compress(nil, BestSpeed), nil},
+		{"digits", compress(digits, BestSpeed), digits},
+		{"twain", compress(twain, BestSpeed), twain}, // Multiple blocks
+		{"concatenated", append(compress(digits, BestSpeed), compress(twain, BestCompression)...), append(digits, twain...)},
+	}
+
+	rand := testutil.NewRand(0)
+	for i, v := range vectors {
+		for _, max := range []struct{ in, out int }{{1, 1 << 16}, {7, 3}, {1 << 10, 1 << 10}, {1 << 20, 1 << 20}} {
+			zd, _ := NewDecompressor(nil)
+			output, consumed, err := testutil.PushDecompress(zd, v.input, rand, max.in, max.out)
+			if err != io.EOF && err != nil {
+				t.Errorf("test %d (%s), max %v: Decompress() = %v, want io.EOF", i, v.desc, max, err)
+			}
+			if !bytes.Equal(output, v.output) {
+				t.Errorf("test %d (%s), max %v: output mismatch", i, v.desc, max)
+			}
+			if consumed != len(v.input) || zd.InputOffset != int64(len(v.input)) {
+				t.Errorf("test %d (%s), max %v: consumed = (%d, %d), want %d", i, v.desc, max, consumed, zd.InputOffset, len(v.input))
+			}
+			if err := zd.Close(); err != nil {
+				t.Errorf("test %d (%s), max %v: Close() = %v", i, v.desc, max, err)
+			}
+		}
+
+		// Truncated streams are only detected by Close.
+		zd, _ := NewDecompressor(nil)
+		output, _, err := testutil.PushDecompress(zd, v.input[:len(v.input)-1], rand, 1<<10, 1<<10)
+		if err != nil {
+			t.Errorf("test %d (%s): Decompress() = %v, want nil", i, v.desc, err)
+		}
+		if !bytes.HasPrefix(v.output, output) {
+			t.Errorf("test %d (%s): output is not a prefix", i, v.desc)
+		}
+		if err := zd.Close(); err != io.ErrUnexpectedEOF {
+			t.Errorf("test %d (%s): Close() = %v, want io.ErrUnexpectedEOF", i, v.desc, err)
+		}
+	}
+
+	// Corrupt streams report a persistent error.
+	zd, _ := NewDecompressor(nil)
+	if _, _, err := zd.Decompress([]byte("BZh0"), make([]byte, 10)); err == nil || err == io.EOF {
+		t.Errorf("Decompress() = %v, want corruption error", err)
+	}
+	if err := zd.Close(); err == nil {
+		t.Errorf("Close() = nil, want corruption error")
+	}
+
+	zd, err := NewDecompressor(&ReaderConfig{ReleaseAfter: 3})
+	if err != nil {
+		t.Fatalf("unexpected NewDecompressor error: %v", err)
+	}
+	if zd.Reset(); zd.zr.relAfter != 3 {
+		t.Errorf("relAfter = %d, want 3", zd.zr.relAfter)
+	}
+	if _, err := NewDecompressor(&ReaderConfig{ReleaseAfter: -1}); err == nil {
+		t.Errorf("NewDecompressor(ReleaseAfter: -1) = nil, want error")
+	}
+}
@@ -0,0 +1,102 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+// +build go1.18
+
+package bzip2
+
+import (
+	"bytes"
+	"hash/adler32"
+	"io"
+	"io/ioutil"
+	"testing"
+	"time"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+// maxFuzzOutput is the maximum number of bytes decompressed for any input.
+const maxFuzzOutput = 1 << 22
+
+// fuzzCost is the maximum cost that processing a single input may incur.
+// The fixed allocation allowance covers the buffers for the largest block size.
+var fuzzCost = testutil.CostBound{
+	TimeFixed:    200 * time.Millisecond,
+	TimePerByte:  2 * time.Microsecond,
+	AllocFixed:   64 << 20,
+	AllocPerByte: 64,
+}
+
+func fuzzSeeds(f *testing.F) {
+	for _, v := range testdata {
+		if len(v.data) > 1<<12 {
+			v.data = v.data[:1<<12]
+		}
+		var buf bytes.Buffer
+		wr, _ := NewWriter(&buf, &WriterConfig{Level: BestSpeed})
+		wr.Write(v.data)
+		wr.Close()
+		f.Add(buf.Bytes())
+	}
+}
+
+// FuzzReader checks that the Reader does not panic and that the cost of
+// decoding any input is proportional to the size of the input and output.
+func FuzzReader(f *testing.F) {
+	fuzzSeeds(f)
+	f.Fuzz(func(t *testing.T, data []byte) {
+		c := testutil.MeasureCost(func() int64 {
+			rd, _ := NewReader(bytes.NewReader(data), nil)
+			n, _ := io.Copy(ioutil.Discard, io.LimitReader(rd, maxFuzzOutput))
+			rd.Close()
+			return int64(len(data)) + n
+		})
+		if err := fuzzCost.Check(c); err != nil {
+			t.Error(err)
+		}
+	})
+}
+
+// FuzzBWT checks that the BWT correctly round-trips any input and that the
+// cost of suffix sorting is proportional to the size of the input.
+func FuzzBWT(f *testing.F) {
+	f.Add(testutil.FibonacciWord(1 << 12))
+	f.Add(testutil.FibonacciFreqs(1 << 12))
+	for _, v := range testdata {
+		if len(v.data) > 1<<12 {
+			v.data = v.data[:1<<12]
+		}
+		f.Add(v.data)
+	}
+
+	f.Fuzz(func(t *testing.T, data []byte) {
+		if len(data) == 0 {
+			return
+		}
+
+		// Verify that any arbitrary input can be reversed given a valid
+		// origin pointer.
+		var bwt burrowsWheelerTransform
+		buf := append([]byte(nil), data...)
+		bwt.Decode(buf, int(adler32.Checksum(buf))%len(buf))
+
+		// Verify that the round-trip faithfully reproduces the input.
+		c := testutil.MeasureCost(func() int64 {
+			copy(buf, data)
+			ptr := bwt.Encode(buf)
+			if ptr < 0 || ptr >= len(buf) {
+				t.Fatalf("invalid origin pointer: %d", ptr)
+			}
+			bwt.Decode(buf, ptr)
+			return int64(len(data))
+		})
+		if !bytes.Equal(buf, data) {
+			t.Fatalf("mismatching bytes")
+		}
+		if err := fuzzCost.Check(c); err != nil {
+			t.Error(err)
+		}
+	})
+}
@@ -29,6 +29,8 @@ type moveToFront struct {
 	vals    []byte
 	syms    []uint16
 	blkSize int
+	numVals int    // Number of values encoded in the block (encoder only)
+	lastNum uint32 // Length of the pending run of zeros (encoder only)
 }
 
 func (mtf *moveToFront) Init(dict []uint8, blkSize int) {
@@ -38,17 +40,31 @@ func (mtf *moveToFront) Init(dict []uint8, blkSize int) {
 	copy(mtf.dictBuf[:], dict)
 	mtf.dictLen = len(dict)
 	mtf.blkSize = blkSize
+	mtf.syms = mtf.syms[:0]
+	mtf.numVals, mtf.lastNum = 0, 0
 }
 
+// Encode encodes vals as an entire block.
 func (mtf *moveToFront) Encode(vals []byte) (syms []uint16) {
+	mtf.syms = mtf.syms[:0]
+	mtf.numVals, mtf.lastNum = 0, 0
+	mtf.EncodeChunk(vals)
+	return mtf.Finish()
+}
+
+// EncodeChunk appends the encoding of vals to the symbols of the current
+// block. A trailing run of zeros is held back until the next call to
+// EncodeChunk or Finish.
+func (mtf *moveToFront) EncodeChunk(vals []byte) {
 	dict := mtf.dictBuf[:mtf.dictLen]
-	syms = mtf.syms[:0]
+	syms := mtf.syms
 
-	if len(vals) > mtf.blkSize {
+	mtf.numVals += len(vals)
+	if mtf.numVals > mtf.blkSize {
 		panicf(errors.Internal, "exceeded block size")
 	}
 
-	var lastNum uint32
+	lastNum := mtf.lastNum
 	for _, val := range vals {
 		// Normal move-to-front transform.
 		var idx uint8 // Reverse lookup idx in dict
@@ -74,17 +90,27 @@ func (mtf *moveToFront) Encode(vals []byte) (syms []uint16) {
 		}
 		syms = append(syms, uint16(idx)+1)
 	}
-	if lastNum > 0 {
-		for rc := lastNum + 1; rc != 1; rc >>= 1 {
+	mtf.syms, mtf.lastNum = syms, lastNum
+}
+
+// Finish flushes any pending run and returns all symbols of the block.
+func (mtf *moveToFront) Finish() (syms []uint16) {
+	syms = mtf.syms
+	if mtf.lastNum > 0 {
+		for rc := mtf.lastNum + 1; rc != 1; rc >>= 1 {
 			syms = append(syms, uint16(rc&1))
 		}
+		mtf.lastNum = 0
 	}
 	mtf.syms = syms
 	return syms
 }
 
 func (mtf *moveToFront) Decode(syms []uint16) (vals []byte) {
-	dict := mtf.dictBuf[:mtf.dictLen]
+	// The caller guarantees that 2 <= sym <= dictLen+1 for all non-RUN symbols,
+	// so masking sym-1 and indexing the full array is equivalent to indexing
+	// dictBuf[:dictLen], but is provably in bounds.
+	dict := &mtf.dictBuf
 	vals = mtf.vals[:0]
 
 	var lastCnt uint
@@ -108,8 +134,9 @@ func (mtf *moveToFront) Decode(syms []uint16) (vals []byte) {
 		}
 
 		// Normal move-to-front transform.
-		val := dict[sym-1] // Forward lookup val in dict
-		copy(dict[1:], dict[:sym-1])
+		idx := int(sym-1) & 0xff
+		val := dict[idx] // Forward lookup val in dict
+		copy(dict[1:], dict[:idx])
 		dict[0] = val
 
 		if len(vals) >= mtf.blkSize {
@@ -133,6 +133,25 @@ func TestMoveToFront(t *testing.T) {
 			input = mtf.Decode(v.output)
 		}()
 
+		// Encoding in chunks must produce the same output.
+		if err == nil {
+			want := append([]uint16(nil), output...)
+			for n := 1; n <= 4; n++ {
+				mtf.Init(getDict(v.input), v.size)
+				for b := v.input; len(b) > 0; {
+					m := n
+					if m > len(b) {
+						m = len(b)
+					}
+					mtf.EncodeChunk(b[:m])
+					b = b[m:]
+				}
+				if syms := mtf.Finish(); !reflect.DeepEqual(syms, want) && !(len(syms) == 0 && len(want) == 0) {
+					t.Errorf("test %d, chunked output mismatch:\ngot  %v\nwant %v", i, syms, want)
+				}
+			}
+		}
+
 		fail := err != nil
 		if fail && !v.fail {
 			t.Errorf("test %d, unexpected error: %v", i, err)
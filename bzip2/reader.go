@@ -15,13 +15,19 @@ import (
 type Reader struct {
 	InputOffset  int64 // Total number of bytes read from underlying io.Reader
 	OutputOffset int64 // Total number of bytes emitted from Read
+	NumSymbols   int64 // Total number of prefix symbols decoded
 
 	rd       prefixReader
 	err      error
+	toRead   []byte // Decompressed data ready to be emitted from Read
+	peekBuf  []byte // Buffer to accumulate data for Peek
 	level    int    // The current compression level
 	rdHdrFtr int    // Number of times we read the stream header and footer
 	blkCRC   uint32 // CRC-32 IEEE of each block (as stored)
 	endCRC   uint32 // Checksum of all blocks using bzip2's custom method
+	blkMax   int    // Length of the largest block decoded since Reset
+	relAfter int    // Number of oversized streams before Reset calls Release
+	relCnt   int    // Number of consecutive oversized streams
 
 	crc crc
 	mtf moveToFront
@@ -39,18 +45,57 @@ type Reader struct {
 }
 
 type ReaderConfig struct {
+	// ReleaseAfter makes Reset call Release once this many consecutive streams
+	// have used blocks less than a quarter of the size of the buffers that were
+	// allocated for an earlier stream. This bounds the memory held by
+	// long-lived Readers that only occasionally decode large blocks.
+	// If zero, buffers are only released by calling Release.
+	ReleaseAfter int
+
 	_ struct{} // Blank field to prevent unkeyed struct literals
 }
 
 func NewReader(r io.Reader, conf *ReaderConfig) (*Reader, error) {
 	zr := new(Reader)
+	if conf != nil {
+		if conf.ReleaseAfter < 0 {
+			return nil, errorf(errors.Invalid, "invalid release count: %d", conf.ReleaseAfter)
+		}
+		zr.relAfter = conf.ReleaseAfter
+	}
 	zr.Reset(r)
 	return zr, nil
 }
 
+// Release frees the large buffers held by the Reader, such as the block
+// buffers, leaving them to the garbage collector. Any data not yet read is
+// discarded, and reads fail until Reset is called. The buffers are allocated
+// again as needed by subsequent streams.
+func (zr *Reader) Release() {
+	zr.rle.Init(nil)
+	zr.mtf.vals = nil
+	zr.bwt = burrowsWheelerTransform{}
+	zr.syms = nil
+	zr.toRead, zr.peekBuf = nil, nil
+	zr.err = errClosed
+}
+
 func (zr *Reader) Reset(r io.Reader) error {
+	if zr.relAfter > 0 {
+		if n := cap(zr.mtf.vals); n > blockSize && 4*zr.blkMax <= n {
+			zr.relCnt++
+		} else {
+			zr.relCnt = 0
+		}
+		if zr.relCnt >= zr.relAfter {
+			zr.Release()
+			zr.relCnt = 0
+		}
+	}
 	*zr = Reader{
-		rd: zr.rd,
+		rd:       zr.rd,
+		relAfter: zr.relAfter,
+		relCnt:   zr.relCnt,
 
 		mtf: zr.mtf,
 		bwt: zr.bwt,
@@ -59,82 +104,169 @@ func (zr *Reader) Reset(r io.Reader) error {
 		treeSels: zr.treeSels,
 		trees1D:  zr.trees1D,
 		syms:     zr.syms,
+		peekBuf:  zr.peekBuf[:0],
 	}
 	zr.rd.Init(r)
 	return nil
 }
 
 func (zr *Reader) Read(buf []byte) (int, error) {
+	if len(zr.toRead) > 0 {
+		cnt := copy(buf, zr.toRead)
+		zr.toRead = zr.toRead[cnt:]
+		zr.OutputOffset += int64(cnt)
+		return cnt, nil
+	}
+	cnt, err := zr.read(buf)
+	zr.OutputOffset += int64(cnt)
+	return cnt, err
+}
+
+// Buffered reports the number of decompressed bytes that can be obtained from
+// Peek or Discard without performing further decompression work.
+func (zr *Reader) Buffered() int {
+	return len(zr.toRead)
+}
+
+// Peek returns the next n decompressed bytes without advancing the reader.
+// Since the final RLE1 stage is decoded lazily, the output is accumulated
+// into an internal buffer until n bytes are available. Any unused capacity of
+// the buffer is filled as well, such that subsequent calls to Read and Peek
+// are served from the buffer.
+//
+// The result is only valid until the next call to Read, Peek, or Discard.
+func (zr *Reader) Peek(n int) ([]byte, error) {
+	if n < 0 {
+		return nil, errorf(errors.Invalid, "negative count")
+	}
+	for len(zr.toRead) < n {
+		size := cap(zr.peekBuf)
+		if size < n {
+			size = n
+		}
+		if size < minPeekSize {
+			size = minPeekSize
+		}
+		if cap(zr.peekBuf) < size {
+			zr.peekBuf = make([]byte, 0, size)
+		}
+		zr.peekBuf = append(zr.peekBuf[:0], zr.toRead...)
+		zr.toRead = zr.peekBuf
+		cnt, err := zr.read(zr.peekBuf[len(zr.peekBuf):cap(zr.peekBuf)])
+		zr.peekBuf = zr.peekBuf[:len(zr.peekBuf)+cnt]
+		zr.toRead = zr.peekBuf
+		if err != nil {
+			return zr.toRead, err
+		}
+	}
+	return zr.toRead[:n], nil
+}
+
+// Discard skips the next n decompressed bytes, returning the number of bytes
+// discarded. If Discard skips fewer than n bytes, it also returns an error.
+func (zr *Reader) Discard(n int) (int, error) {
+	if n < 0 {
+		return 0, errorf(errors.Invalid, "negative count")
+	}
+	var cnt int
+	for cnt < n {
+		if len(zr.toRead) == 0 {
+			if _, err := zr.Peek(1); err != nil {
+				return cnt, err
+			}
+		}
+		m := n - cnt
+		if m > len(zr.toRead) {
+			m = len(zr.toRead)
+		}
+		zr.toRead = zr.toRead[m:]
+		zr.OutputOffset += int64(m)
+		cnt += m
+	}
+	return cnt, nil
+}
+
+// read decodes data into buf, reading the next block as necessary.
+// It does not update OutputOffset.
+func (zr *Reader) read(buf []byte) (int, error) {
 	for {
-		cnt, err := zr.rle.Read(buf)
+		cnt, err := zr.rle.decode(buf, &zr.crc)
 		if err != rleDone && zr.err == nil {
 			zr.err = err
 		}
 		if cnt > 0 {
-			zr.crc.update(buf[:cnt])
-			zr.OutputOffset += int64(cnt)
 			return cnt, nil
 		}
 		if zr.err != nil || len(buf) == 0 {
 			return 0, zr.err
 		}
 
-		// Read the next chunk.
-		zr.rd.Offset = zr.InputOffset
-		func() {
-			defer errors.Recover(&zr.err)
-			if zr.rdHdrFtr%2 == 0 {
-				// Check if we are already at EOF.
-				if err := zr.rd.PullBits(1); err != nil {
-					if err == io.ErrUnexpectedEOF && zr.rdHdrFtr > 0 {
-						err = io.EOF // EOF is okay if we read at least one stream
-					}
-					errors.Panic(err)
-				}
+		// Read the next block.
+		zr.doStep()
+		if zr.err != nil {
+			return 0, zr.err
+		}
+	}
+}
 
-				// Read stream header.
-				if zr.rd.ReadBitsBE64(16) != hdrMagic {
-					panicf(errors.Corrupted, "invalid stream magic")
-				}
-				if ver := zr.rd.ReadBitsBE64(8); ver != 'h' {
-					if ver == '0' {
-						panicf(errors.Deprecated, "bzip1 format is not supported")
-					}
-					panicf(errors.Corrupted, "invalid version: %q", ver)
-				}
-				lvl := int(zr.rd.ReadBitsBE64(8)) - '0'
-				if lvl < BestSpeed || lvl > BestCompression {
-					panicf(errors.Corrupted, "invalid block size: %d", lvl*blockSize)
+// doStep reads the next block, along with the stream header or footer as
+// necessary. It may only be called once all of the current block is decoded.
+func (zr *Reader) doStep() {
+	zr.rd.Offset = zr.InputOffset
+	func() {
+		defer errors.Recover(&zr.err)
+		if zr.rdHdrFtr%2 == 0 {
+			// Check if we are already at EOF.
+			if err := zr.rd.PullBits(1); err != nil {
+				if err == io.ErrUnexpectedEOF && zr.rdHdrFtr > 0 {
+					err = io.EOF // EOF is okay if we read at least one stream
 				}
-				zr.level = lvl
-				zr.rdHdrFtr++
-			} else {
-				// Check and update the CRC.
-				if internal.GoFuzz {
-					zr.updateChecksum(-1, zr.crc.val) // Update with value
-					zr.blkCRC = zr.crc.val            // Suppress CRC failures
-				}
-				if zr.blkCRC != zr.crc.val {
-					panicf(errors.Corrupted, "mismatching block checksum")
+				errors.Panic(err)
+			}
+
+			// Read stream header.
+			if zr.rd.ReadBitsBE64(16) != hdrMagic {
+				panicf(errors.Corrupted, "invalid stream magic")
+			}
+			if ver := zr.rd.ReadBitsBE64(8); ver != 'h' {
+				if ver == '0' {
+					panicf(errors.Deprecated, "bzip1 format is not supported")
 				}
-				zr.endCRC = (zr.endCRC<<1 | zr.endCRC>>31) ^ zr.blkCRC
+				panicf(errors.Corrupted, "invalid version: %q", ver)
 			}
-			buf := zr.decodeBlock()
-			zr.rle.Init(buf)
-		}()
-		if zr.InputOffset, err = zr.rd.Flush(); zr.err == nil {
-			zr.err = err
-		}
-		if zr.err != nil {
-			zr.err = errWrap(zr.err, errors.Corrupted)
-			return 0, zr.err
+			lvl := int(zr.rd.ReadBitsBE64(8)) - '0'
+			if lvl < BestSpeed || lvl > BestCompression {
+				panicf(errors.Corrupted, "invalid block size: %d", lvl*blockSize)
+			}
+			zr.level = lvl
+			zr.rdHdrFtr++
+		} else {
+			// Check and update the CRC.
+			if internal.GoFuzz {
+				zr.updateChecksum(-1, zr.crc.val) // Update with value
+				zr.blkCRC = zr.crc.val            // Suppress CRC failures
+			}
+			if zr.blkCRC != zr.crc.val {
+				panicf(errors.Corrupted, "mismatching block checksum")
+			}
+			zr.endCRC = (zr.endCRC<<1 | zr.endCRC>>31) ^ zr.blkCRC
 		}
+		buf := zr.decodeBlock()
+		zr.rle.Init(buf)
+	}()
+	var err error
+	if zr.InputOffset, err = zr.rd.Flush(); zr.err == nil {
+		zr.err = err
+	}
+	if zr.err != nil {
+		zr.err = errWrap(zr.err, errors.Corrupted)
 	}
 }
 
 func (zr *Reader) Close() error {
 	if zr.err == io.EOF || zr.err == errClosed {
 		zr.rle.Init(nil) // Make sure future reads fail
+		zr.toRead = nil
 		zr.err = errClosed
 		return nil
 	}
@@ -189,6 +321,7 @@ func (zr *Reader) decodeBlock() []byte {
 
 	// Step 1: Prefix encoding.
 	syms := zr.decodePrefix(len(dict))
+	zr.NumSymbols += int64(len(syms))
 
 	// Step 2: Move-to-front transform and run-length encoding.
 	zr.mtf.Init(dict, zr.level*blockSize)
@@ -200,6 +333,9 @@ func (zr *Reader) decodeBlock() []byte {
 	}
 	zr.bwt.Decode(buf, ptr)
 
+	if len(buf) > zr.blkMax {
+		zr.blkMax = len(buf)
+	}
 	return buf
 }
 
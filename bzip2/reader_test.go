@@ -904,32 +904,112 @@ func TestReader(t *testing.T) {
 	}
 }
 
-func BenchmarkDecode(b *testing.B) {
-	runBenchmarks(b, func(b *testing.B, data []byte, lvl int) {
-		b.StopTimer()
-		b.ReportAllocs()
+func TestReaderNumSymbols(t *testing.T) {
+	input := testutil.MustLoadFile("../testdata/twain.txt")
+	var bb bytes.Buffer
+	wr, _ := NewWriter(&bb, &WriterConfig{Level: BestSpeed})
+	wr.Write(input)
+	wr.Close()
 
-		buf := new(bytes.Buffer)
-		wr, _ := NewWriter(buf, &WriterConfig{Level: lvl})
-		wr.Write(data)
+	rd, err := NewReader(bytes.NewReader(bb.Bytes()), nil)
+	if err != nil {
+		t.Fatalf("unexpected NewReader error: %v", err)
+	}
+	output, err := ioutil.ReadAll(rd)
+	if err != nil {
+		t.Errorf("unexpected ReadAll error: %v", err)
+	}
+	if got, want, ok := testutil.BytesCompare(output, input); !ok {
+		t.Errorf("output mismatch:\ngot  %s\nwant %s", got, want)
+	}
+	if rd.NumSymbols == 0 || rd.NumSymbols >= int64(len(input)) {
+		t.Errorf("NumSymbols = %d, want within (0, %d)", rd.NumSymbols, len(input))
+	}
+}
+
+func TestReaderRelease(t *testing.T) {
+	compress := func(input []byte) []byte {
+		var bb bytes.Buffer
+		wr, _ := NewWriter(&bb, &WriterConfig{Level: BestCompression})
+		wr.Write(input)
 		wr.Close()
+		return bb.Bytes()
+	}
+	twain := testutil.MustLoadFile("../testdata/twain.txt")
+	large, small := testutil.ResizeData(twain, 800000), twain[:10000]
 
-		br := new(bytes.Reader)
-		rd := new(Reader)
+	rd, err := NewReader(bytes.NewReader(compress(large)), &ReaderConfig{ReleaseAfter: 2})
+	if err != nil {
+		t.Fatalf("unexpected NewReader error: %v", err)
+	}
+	if _, err := io.Copy(ioutil.Discard, rd); err != nil {
+		t.Fatalf("unexpected Copy error: %v", err)
+	}
 
-		b.SetBytes(int64(len(data)))
-		b.StartTimer()
-		for i := 0; i < b.N; i++ {
-			br.Reset(buf.Bytes())
-			rd.Reset(br)
+	// The buffers are only released by the Reset following the second stream
+	// that needed much less of them.
+	for i := 0; i < 3; i++ {
+		rd.Reset(bytes.NewReader(compress(small)))
+		output, err := ioutil.ReadAll(rd)
+		if err != nil {
+			t.Errorf("test %d, unexpected ReadAll error: %v", i, err)
+		}
+		if got, want, ok := testutil.BytesCompare(output, small); !ok {
+			t.Errorf("test %d, output mismatch:\ngot  %s\nwant %s", i, got, want)
+		}
+		if got, want := cap(rd.mtf.vals) >= len(large), i < 2; got != want {
+			t.Errorf("test %d, large buffers retained = %v, want %v", i, got, want)
+		}
+	}
 
-			n, err := io.Copy(ioutil.Discard, rd)
-			if n != int64(len(data)) || err != nil {
-				b.Fatalf("Copy() = (%d, %v), want (%d, nil)", n, err, len(data))
-			}
-			if err := rd.Close(); err != nil {
-				b.Fatalf("Close() = %v, want nil", err)
-			}
+	rd.Release()
+	if cap(rd.mtf.vals)+cap(rd.bwt.perm)+cap(rd.syms) != 0 {
+		t.Errorf("buffers were not released")
+	}
+	if _, err := rd.Read(make([]byte, 1)); err == nil {
+		t.Errorf("Read() after Release = nil, want error")
+	}
+	rd.Reset(bytes.NewReader(compress(large)))
+	output, err := ioutil.ReadAll(rd)
+	if err != nil {
+		t.Errorf("unexpected ReadAll error: %v", err)
+	}
+	if got, want, ok := testutil.BytesCompare(output, large); !ok {
+		t.Errorf("output mismatch:\ngot  %s\nwant %s", got, want)
+	}
+
+	if _, err := NewReader(nil, &ReaderConfig{ReleaseAfter: -1}); err == nil {
+		t.Errorf("NewReader(ReleaseAfter: -1) = nil, want error")
+	}
+}
+
+func BenchmarkDecode(b *testing.B)          { runBenchmarks(b, benchmarkDecode) }
+func BenchmarkDecodeWorstCase(b *testing.B) { runWorstCaseBenchmarks(b, benchmarkDecode) }
+
+func benchmarkDecode(b *testing.B, data []byte, lvl int) {
+	b.StopTimer()
+	b.ReportAllocs()
+
+	buf := new(bytes.Buffer)
+	wr, _ := NewWriter(buf, &WriterConfig{Level: lvl})
+	wr.Write(data)
+	wr.Close()
+
+	br := new(bytes.Reader)
+	rd := new(Reader)
+
+	b.SetBytes(int64(len(data)))
+	b.StartTimer()
+	for i := 0; i < b.N; i++ {
+		br.Reset(buf.Bytes())
+		rd.Reset(br)
+
+		n, err := io.Copy(ioutil.Discard, rd)
+		if n != int64(len(data)) || err != nil {
+			b.Fatalf("Copy() = (%d, %v), want (%d, nil)", n, err, len(data))
+		}
+		if err := rd.Close(); err != nil {
+			b.Fatalf("Close() = %v, want nil", err)
 		}
-	})
+	}
 }
@@ -26,6 +26,9 @@ type runLengthEncoding struct {
 	idx     int
 	lastVal byte
 	lastCnt int
+	repCnt  int // Number of pending repeats of lastVal (decoder only)
+
+	used [256]bool // Set of byte values in buf (encoder only)
 }
 
 func (rle *runLengthEncoding) Init(buf []byte) {
@@ -35,6 +38,9 @@ func (rle *runLengthEncoding) Init(buf []byte) {
 func (rle *runLengthEncoding) Write(buf []byte) (int, error) {
 	for i, b := range buf {
 		if rle.lastVal != b {
+			if rle.lastCnt >= 4 {
+				rle.used[rle.buf[rle.idx-1]] = true // Final repeat count
+			}
 			rle.lastCnt = 0
 		}
 		rle.lastCnt++
@@ -45,6 +51,7 @@ func (rle *runLengthEncoding) Write(buf []byte) (int, error) {
 			}
 			rle.buf[rle.idx] = b
 			rle.idx++
+			rle.used[b] = true
 		case rle.lastCnt == 4:
 			if rle.idx+1 >= len(rle.buf) {
 				return i, rleDone
@@ -59,6 +66,7 @@ func (rle *runLengthEncoding) Write(buf []byte) (int, error) {
 			if rle.idx >= len(rle.buf) {
 				return i, rleDone
 			}
+			rle.used[rle.buf[rle.idx-1]] = true // Final repeat count
 			rle.lastCnt = 1
 			rle.buf[rle.idx] = b
 			rle.idx++
@@ -69,33 +77,98 @@ func (rle *runLengthEncoding) Write(buf []byte) (int, error) {
 }
 
 func (rle *runLengthEncoding) Read(buf []byte) (int, error) {
-	for i := range buf {
-		switch {
-		case rle.lastCnt == -4:
-			if rle.idx >= len(rle.buf) {
-				return i, errorf(errors.Corrupted, "missing terminating run-length repeater")
-			}
-			rle.lastCnt = int(rle.buf[rle.idx])
-			rle.idx++
-			if rle.lastCnt > 0 {
-				break // Break the switch
+	return rle.decode(buf, nil)
+}
+
+// decode is the implementation of Read. If c is non-nil, then the CRC is also
+// updated with the output, which is done in chunks of crcChunkSize bytes
+// while the data is still hot in the cache.
+//
+// The decoder is structured as a sequence of bulk operations. Literal spans
+// (which end right after the 4th duplicate byte) are scanned and then copied
+// with a single copy, while repeat counts are expanded with a fill.
+func (rle *runLengthEncoding) decode(buf []byte, c *crc) (n int, err error) {
+	const crcChunkSize = 4 << 10
+	var crcIdx int
+	for n < len(buf) {
+		if c != nil && n-crcIdx >= crcChunkSize {
+			c.update(buf[crcIdx:n])
+			crcIdx = n
+		}
+
+		// Expand any pending repeats of the last value.
+		if rle.repCnt > 0 {
+			cnt := rle.repCnt
+			if cnt > len(buf)-n {
+				cnt = len(buf) - n
 			}
-			fallthrough // Count was zero, continue the work
-		case rle.lastCnt <= 0:
+			fillBytes(buf[n:n+cnt], rle.lastVal)
+			n += cnt
+			rle.repCnt -= cnt
+			continue
+		}
+
+		// The 4th duplicate byte is always followed by a repeat count.
+		if rle.lastCnt == 4 {
 			if rle.idx >= len(rle.buf) {
-				return i, rleDone
+				err = errorf(errors.Corrupted, "missing terminating run-length repeater")
+				break
 			}
-			b := rle.buf[rle.idx]
+			rle.repCnt = int(rle.buf[rle.idx])
 			rle.idx++
-			if b != rle.lastVal {
-				rle.lastCnt = 0
-				rle.lastVal = b
+			rle.lastCnt = 0
+			continue
+		}
+
+		// Copy a literal span up to and including the next 4th duplicate.
+		src := rle.buf[rle.idx:]
+		if len(src) == 0 {
+			err = rleDone
+			break
+		}
+		if len(src) > len(buf)-n {
+			src = src[:len(buf)-n]
+		}
+		cnt, val := rle.lastCnt, rle.lastVal
+		var i int
+		for i < len(src) {
+			b := src[i]
+			i++
+			if b != val {
+				val, cnt = b, 1
+			} else if cnt++; cnt == 4 {
+				break
 			}
 		}
-		buf[i] = rle.lastVal
-		rle.lastCnt--
+		rle.lastCnt, rle.lastVal = cnt, val
+		n += copy(buf[n:], src[:i])
+		rle.idx += i
+	}
+	if c != nil {
+		c.update(buf[crcIdx:n])
+	}
+	return n, err
+}
+
+// fillBytes sets every byte in buf to b.
+func fillBytes(buf []byte, b byte) {
+	if len(buf) == 0 {
+		return
+	}
+	buf[0] = b
+	for i := 1; i < len(buf); i *= 2 {
+		copy(buf[i:], buf[:i])
 	}
-	return len(buf), nil
 }
 
 func (rle *runLengthEncoding) Bytes() []byte { return rle.buf[:rle.idx] }
+
+// Used reports the set of byte values present in Bytes.
+// This is tracked during encoding so that the block need not be scanned again.
+func (rle *runLengthEncoding) Used() (used [256]bool) {
+	used = rle.used
+	if rle.lastCnt >= 4 {
+		used[rle.buf[rle.idx-1]] = true // Repeat count of the pending run
+	}
+	return used
+}
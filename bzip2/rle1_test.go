@@ -85,6 +85,13 @@ func TestRunLengthEncoder(t *testing.T) {
 		if done := err == rleDone; done != v.done {
 			t.Errorf("test %d, done mismatch: got %v want %v", i, done, v.done)
 		}
+		var used [256]bool
+		for _, c := range output {
+			used[c] = true
+		}
+		if got := rle.Used(); got != used {
+			t.Errorf("test %d, used symbols mismatch", i)
+		}
 	}
 }
 
@@ -145,19 +152,49 @@ func TestRunLengthDecoder(t *testing.T) {
 		output: "aaabbbcccddddddeeefgghiiijkllmmmmmmmmnnoo",
 	}}
 
-	buf := make([]byte, 3)
-	for i, v := range vectors {
-		wr := new(bytes.Buffer)
-		rle := new(runLengthEncoding)
-		rle.Init([]byte(v.input))
-		_, err := io.CopyBuffer(struct{ io.Writer }{wr}, rle, buf)
-		output := wr.Bytes()
+	for _, n := range []int{1, 3, 4096} {
+		buf := make([]byte, n)
+		for i, v := range vectors {
+			wr := new(bytes.Buffer)
+			rle := new(runLengthEncoding)
+			rle.Init([]byte(v.input))
+			_, err := io.CopyBuffer(struct{ io.Writer }{wr}, rle, buf)
+			output := wr.Bytes()
 
-		if got, want, ok := testutil.BytesCompare(output, []byte(v.output)); !ok {
-			t.Errorf("test %d, output mismatch:\ngot  %s\nwant %s", i, got, want)
+			if got, want, ok := testutil.BytesCompare(output, []byte(v.output)); !ok {
+				t.Errorf("test %d (bufsize %d), output mismatch:\ngot  %s\nwant %s", i, n, got, want)
+			}
+			if fail := err != rleDone; fail != v.fail {
+				t.Errorf("test %d (bufsize %d), failure mismatch: got %t, want %t", i, n, fail, v.fail)
+			}
+
+			// Check that the fused CRC matches a separate CRC pass.
+			var c1, c2 crc
+			rle.Init([]byte(v.input))
+			cnt, _ := rle.decode(buf, &c1)
+			if c2.update(buf[:cnt]); c1.val != c2.val {
+				t.Errorf("test %d (bufsize %d), crc mismatch: got 0x%08x, want 0x%08x", i, n, c1.val, c2.val)
+			}
 		}
-		if fail := err != rleDone; fail != v.fail {
-			t.Errorf("test %d, failure mismatch: got %t, want %t", i, fail, v.fail)
+	}
+}
+
+func BenchmarkRunLengthDecoder(b *testing.B) {
+	var rle runLengthEncoding
+	data := testutil.MustLoadFile("../testdata/twain.txt")
+	data = append(data, bytes.Repeat([]byte{'a'}, 1<<16)...)
+	rle.Init(make([]byte, 2*len(data)))
+	rle.Write(data)
+	input := rle.Bytes()
+
+	var c crc
+	buf := make([]byte, len(data))
+	b.SetBytes(int64(len(data)))
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		rle.Init(input)
+		if n, _ := rle.decode(buf, &c); n != len(data) {
+			b.Fatalf("decode() = %d, want %d", n, len(data))
 		}
 	}
 }
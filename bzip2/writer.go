@@ -22,6 +22,10 @@ type Writer struct {
 	wrHdr  bool   // Have we written the stream header?
 	blkCRC uint32 // CRC-32 IEEE of each block
 	endCRC uint32 // Checksum of all blocks using bzip2's custom method
+	blkMax int    // Length of the largest block encoded since Reset
+
+	relAfter int // Number of oversized streams before Reset calls Release
+	relCnt   int // Number of consecutive oversized streams
 
 	crc crc
 	rle runLengthEncoding
@@ -35,18 +39,34 @@ type Writer struct {
 	codes2D     [maxNumTrees][maxNumSyms]prefix.PrefixCode
 	codes1D     [maxNumTrees]prefix.PrefixCodes
 	trees1D     [maxNumTrees]prefix.Encoder
+	grpCnts     [numGroupMods][maxNumSyms]uint32
 }
 
+// numGroupMods is the number of distinct histograms kept for the groups of
+// numBlockSyms symbols. Histograms are accumulated before the number of trees
+// is known, so group i is counted in grpCnts[i%numGroupMods]. Since every
+// possible number of trees divides numGroupMods, the histogram of each tree
+// can later be summed from these, given that group i initially uses tree
+// i%numTrees.
+const numGroupMods = 60 // Least common multiple of minNumTrees..maxNumTrees
+
 type WriterConfig struct {
 	Level int
 
+	// ReleaseAfter makes Reset call Release once this many consecutive streams
+	// have used blocks less than a quarter of the size of the suffix array that
+	// was allocated for an earlier stream. This bounds the memory held by
+	// long-lived Writers that only occasionally encode large blocks.
+	// If zero, buffers are only released by calling Release.
+	ReleaseAfter int
+
 	_ struct{} // Blank field to prevent unkeyed struct literals
 }
 
 func NewWriter(w io.Writer, conf *WriterConfig) (*Writer, error) {
-	var lvl int
+	var lvl, relAfter int
 	if conf != nil {
-		lvl = conf.Level
+		lvl, relAfter = conf.Level, conf.ReleaseAfter
 	}
 	if lvl == 0 {
 		lvl = DefaultCompression
@@ -54,17 +74,48 @@ func NewWriter(w io.Writer, conf *WriterConfig) (*Writer, error) {
 	if lvl < BestSpeed || lvl > BestCompression {
 		return nil, errorf(errors.Invalid, "compression level: %d", lvl)
 	}
+	if relAfter < 0 {
+		return nil, errorf(errors.Invalid, "invalid release count: %d", relAfter)
+	}
 	zw := new(Writer)
 	zw.level = lvl
+	zw.relAfter = relAfter
 	zw.Reset(w)
 	return zw, nil
 }
 
+// Release frees the buffers held by the Writer that grow with the size of the
+// blocks encoded, which are the suffix array and the BWT and MTF buffers,
+// leaving them to the garbage collector. The block buffer is kept, since its
+// size is fixed by the compression level and Reset needs it again.
+// Any data not yet flushed is discarded, and writes fail until Reset is
+// called. The freed buffers are allocated again as needed by later streams.
+func (zw *Writer) Release() {
+	zw.rle.Init(nil)
+	zw.bwt = burrowsWheelerTransform{}
+	zw.mtf.vals, zw.mtf.syms = nil, nil
+	zw.err = errClosed
+}
+
 func (zw *Writer) Reset(w io.Writer) error {
+	if zw.relAfter > 0 {
+		if n := cap(zw.bwt.sa); n > 2*blockSize && 8*zw.blkMax <= n {
+			zw.relCnt++
+		} else {
+			zw.relCnt = 0
+		}
+		if zw.relCnt >= zw.relAfter {
+			zw.Release()
+			zw.relCnt = 0
+		}
+	}
 	*zw = Writer{
 		wr:    zw.wr,
 		level: zw.level,
 
+		relAfter: zw.relAfter,
+		relCnt:   zw.relCnt,
+
 		rle: zw.rle,
 		bwt: zw.bwt,
 		mtf: zw.mtf,
@@ -110,6 +161,9 @@ func (zw *Writer) flush() error {
 	if len(vals) == 0 {
 		return nil
 	}
+	if len(vals) > zw.blkMax {
+		zw.blkMax = len(vals)
+	}
 	zw.wr.Offset = zw.OutputOffset
 	func() {
 		defer errors.Recover(&zw.err)
@@ -175,21 +229,9 @@ func (zw *Writer) Close() error {
 }
 
 func (zw *Writer) encodeBlock(buf []byte) {
-	zw.blkCRC = zw.crc.val
-	zw.wr.WriteBitsBE64(blkMagic, 48)
-	zw.wr.WriteBitsBE64(uint64(zw.blkCRC), 32)
-	zw.wr.WriteBitsBE64(0, 1)
-	zw.crc.val = 0
-
-	// Step 1: Burrows-Wheeler transformation.
-	ptr := zw.bwt.Encode(buf)
-	zw.wr.WriteBitsBE64(uint64(ptr), 24)
-
-	// Step 2: Move-to-front transform and run-length encoding.
-	var dictMap [256]bool
-	for _, c := range buf {
-		dictMap[c] = true
-	}
+	// Step 1: Determine the alphabet of the block, which the RLE1 stage
+	// already tracked while filling buf.
+	dictMap := zw.rle.Used()
 
 	var dictArr [256]uint8
 	var bmapLo [16]uint16
@@ -204,6 +246,27 @@ func (zw *Writer) encodeBlock(buf []byte) {
 		}
 	}
 
+	// Step 2: Burrows-Wheeler transformation, move-to-front transform, and
+	// run-length encoding. The MTF stage consumes each chunk of the BWT output
+	// while it is still in cache, and the symbol histograms of each group are
+	// accumulated as soon as the symbols are produced.
+	var numCnt int // Number of symbols that have been counted
+	zw.mtf.Init(dict, len(buf))
+	ptr := zw.bwt.EncodeFunc(buf, func(b []byte) {
+		zw.mtf.EncodeChunk(b)
+		numCnt = zw.countSymbols(zw.mtf.syms, numCnt)
+	})
+	syms := zw.mtf.Finish()
+	syms = append(syms, uint16(len(dict)+1)) // EOB marker
+	zw.countSymbols(syms, numCnt)
+
+	zw.blkCRC = zw.crc.val
+	zw.wr.WriteBitsBE64(blkMagic, 48)
+	zw.wr.WriteBitsBE64(uint64(zw.blkCRC), 32)
+	zw.wr.WriteBitsBE64(0, 1)
+	zw.crc.val = 0
+	zw.wr.WriteBitsBE64(uint64(ptr), 24)
+
 	zw.wr.WriteBits(uint(bmapHi), 16)
 	for _, m := range bmapLo {
 		if m > 0 {
@@ -211,19 +274,35 @@ func (zw *Writer) encodeBlock(buf []byte) {
 		}
 	}
 
-	zw.mtf.Init(dict, len(buf))
-	syms := zw.mtf.Encode(buf)
-
 	// Step 3: Prefix encoding.
 	zw.encodePrefix(syms, len(dict))
 }
 
+// countSymbols adds syms[i:] to the histograms in grpCnts and returns the new
+// number of counted symbols.
+func (zw *Writer) countSymbols(syms []uint16, i int) int {
+	for i < len(syms) {
+		grp := i / numBlockSyms
+		end := (grp + 1) * numBlockSyms
+		if end > len(syms) {
+			end = len(syms)
+		}
+		cnts := &zw.grpCnts[grp%numGroupMods]
+		for _, sym := range syms[i:end] {
+			cnts[sym]++
+		}
+		i = end
+	}
+	return i
+}
+
+// encodePrefix encodes syms, which must already include the EOB marker and
+// have been counted in grpCnts.
 func (zw *Writer) encodePrefix(syms []uint16, numSyms int) {
 	numSyms += 2 // Remove 0 symbol, add RUNA, RUNB, and EOB symbols
 	if numSyms < 3 {
 		panicf(errors.Internal, "unable to encode EOB marker")
 	}
-	syms = append(syms, uint16(numSyms-1)) // EOB marker
 
 	// Compute number of prefix trees needed.
 	numTrees := maxNumTrees
@@ -253,17 +332,19 @@ func (zw *Writer) encodePrefix(syms []uint16, numSyms int) {
 		zw.codes1D[i] = pc
 	}
 
-	// First cut at assigning prefix trees to each group.
-	var codes prefix.PrefixCodes
-	var blkLen, selIdx int
-	for _, sym := range syms {
-		if blkLen == 0 {
-			blkLen = numBlockSyms
-			codes = zw.codes2D[treeSels[selIdx]][:numSyms]
-			selIdx++
+	// First cut at assigning prefix trees to each group. The histograms are
+	// cleared for use by the next block.
+	numMods := numGroupMods
+	if numSels < numMods {
+		numMods = numSels
+	}
+	for m := range zw.grpCnts[:numMods] {
+		codes := zw.codes2D[m%numTrees][:numSyms]
+		cnts := &zw.grpCnts[m]
+		for sym := range codes {
+			codes[sym].Cnt += cnts[sym]
+			cnts[sym] = 0
 		}
-		blkLen--
-		codes[sym].Cnt++
 	}
 
 	// TODO(dsnet): Use K-means to cluster groups to each prefix tree.
@@ -291,7 +372,7 @@ func (zw *Writer) encodePrefix(syms []uint16, numSyms int) {
 
 	// Write out prefix encoded symbols of compressed data.
 	var tree *prefix.Encoder
-	blkLen, selIdx = 0, 0
+	var blkLen, selIdx int
 	for _, sym := range syms {
 		if blkLen == 0 {
 			blkLen = numBlockSyms
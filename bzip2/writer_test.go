@@ -9,29 +9,90 @@ import (
 	"io"
 	"io/ioutil"
 	"testing"
+
+	"github.com/dsnet/compress/internal/testutil"
 )
 
-func BenchmarkEncode(b *testing.B) {
-	runBenchmarks(b, func(b *testing.B, data []byte, lvl int) {
-		b.StopTimer()
-		b.ReportAllocs()
-
-		br := new(bytes.Reader)
-		wr, _ := NewWriter(nil, &WriterConfig{Level: lvl})
-
-		b.SetBytes(int64(len(data)))
-		b.StartTimer()
-		for i := 0; i < b.N; i++ {
-			br.Reset(data)
-			wr.Reset(ioutil.Discard)
-
-			n, err := io.Copy(wr, br)
-			if n != int64(len(data)) || err != nil {
-				b.Fatalf("Copy() = (%d, %v), want (%d, nil)", n, err, len(data))
-			}
-			if err := wr.Close(); err != nil {
-				b.Fatalf("Close() = %v, want nil", err)
-			}
-		}
-	})
+func TestWriterRelease(t *testing.T) {
+	twain := testutil.MustLoadFile("../testdata/twain.txt")
+	large, small := testutil.ResizeData(twain, 800000), twain[:10000]
+	roundTrip := func(wr *Writer, input []byte) {
+		var bb bytes.Buffer
+		wr.Reset(&bb)
+		if _, err := wr.Write(input); err != nil {
+			t.Fatalf("unexpected Write error: %v", err)
+		}
+		if err := wr.Close(); err != nil {
+			t.Fatalf("unexpected Close error: %v", err)
+		}
+		rd, _ := NewReader(&bb, nil)
+		output, err := ioutil.ReadAll(rd)
+		if err != nil {
+			t.Errorf("unexpected ReadAll error: %v", err)
+		}
+		if got, want, ok := testutil.BytesCompare(output, input); !ok {
+			t.Errorf("output mismatch:\ngot  %s\nwant %s", got, want)
+		}
+	}
+
+	wr, err := NewWriter(nil, &WriterConfig{Level: BestCompression, ReleaseAfter: 2})
+	if err != nil {
+		t.Fatalf("unexpected NewWriter error: %v", err)
+	}
+	roundTrip(wr, large)
+	buf := wr.buf
+
+	// The suffix array is only released by the Reset following the second
+	// stream that needed much less of it. The block buffer is always kept.
+	for i := 0; i < 3; i++ {
+		roundTrip(wr, small)
+		if got, want := cap(wr.bwt.sa) >= len(large), i < 2; got != want {
+			t.Errorf("test %d, large buffers retained = %v, want %v", i, got, want)
+		}
+		if &wr.buf[0] != &buf[0] {
+			t.Errorf("test %d, block buffer was reallocated", i)
+		}
+	}
+
+	wr.Release()
+	if cap(wr.bwt.sa)+cap(wr.bwt.buf)+cap(wr.mtf.vals)+cap(wr.mtf.syms) != 0 {
+		t.Errorf("buffers were not released")
+	}
+	if len(wr.buf) != BestCompression*blockSize {
+		t.Errorf("len(buf) = %d, want %d", len(wr.buf), BestCompression*blockSize)
+	}
+	if _, err := wr.Write(small); err == nil {
+		t.Errorf("Write() after Release = nil, want error")
+	}
+	roundTrip(wr, large)
+
+	if _, err := NewWriter(nil, &WriterConfig{ReleaseAfter: -1}); err == nil {
+		t.Errorf("NewWriter(ReleaseAfter: -1) = nil, want error")
+	}
+}
+
+func BenchmarkEncode(b *testing.B)          { runBenchmarks(b, benchmarkEncode) }
+func BenchmarkEncodeWorstCase(b *testing.B) { runWorstCaseBenchmarks(b, benchmarkEncode) }
+
+func benchmarkEncode(b *testing.B, data []byte, lvl int) {
+	b.StopTimer()
+	b.ReportAllocs()
+
+	br := new(bytes.Reader)
+	wr, _ := NewWriter(nil, &WriterConfig{Level: lvl})
+
+	b.SetBytes(int64(len(data)))
+	b.StartTimer()
+	for i := 0; i < b.N; i++ {
+		br.Reset(data)
+		wr.Reset(ioutil.Discard)
+
+		n, err := io.Copy(wr, br)
+		if n != int64(len(data)) || err != nil {
+			b.Fatalf("Copy() = (%d, %v), want (%d, nil)", n, err, len(data))
+		}
+		if err := wr.Close(); err != nil {
+			b.Fatalf("Close() = %v, want nil", err)
+		}
+	}
 }
@@ -0,0 +1,108 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package flate
+
+import (
+	"encoding/binary"
+	"io"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+const checkpointVersion = 1
+
+var errNoCheckpoint = errorf(errors.Invalid, "reader is not at a block boundary")
+
+// Checkpoint is a snapshot of the state of a Reader at a block boundary.
+// It allows decompression to resume at that point with a new Reader, without
+// decompressing any of the preceding data.
+//
+// Since a DEFLATE block may start at any bit, the checkpoint records how many
+// bits of the byte at InputOffset have already been consumed, along with the
+// last 32KiB of decompressed output that later blocks may refer back to.
+type Checkpoint struct {
+	InputOffset  int64 // Offset of the byte containing the start of the block
+	OutputOffset int64 // Offset of the decompressed data that the block produces
+
+	bits   uint8  // Number of bits of the byte at InputOffset already consumed
+	window []byte // Sliding window history
+}
+
+// MarshalBinary encodes the checkpoint in a compact binary form.
+func (cp *Checkpoint) MarshalBinary() ([]byte, error) {
+	var b [binary.MaxVarintLen64]byte
+	buf := make([]byte, 0, 2+2*len(b)+len(cp.window))
+	buf = append(buf, checkpointVersion, cp.bits)
+	buf = append(buf, b[:binary.PutUvarint(b[:], uint64(cp.InputOffset))]...)
+	buf = append(buf, b[:binary.PutUvarint(b[:], uint64(cp.OutputOffset))]...)
+	buf = append(buf, cp.window...)
+	return buf, nil
+}
+
+// UnmarshalBinary decodes a checkpoint produced by MarshalBinary.
+func (cp *Checkpoint) UnmarshalBinary(buf []byte) error {
+	if len(buf) < 2 || buf[0] != checkpointVersion || buf[1] >= 8 {
+		return errorf(errors.Corrupted, "invalid checkpoint header")
+	}
+	bits, buf := buf[1], buf[2:]
+	var offs [2]int64
+	for i := range offs {
+		v, n := binary.Uvarint(buf)
+		if n <= 0 || int64(v) < 0 {
+			return errorf(errors.Corrupted, "invalid checkpoint offset")
+		}
+		offs[i], buf = int64(v), buf[n:]
+	}
+	if len(buf) > maxHistSize || int64(len(buf)) > offs[1] {
+		return errorf(errors.Corrupted, "invalid checkpoint window")
+	}
+	*cp = Checkpoint{
+		InputOffset:  offs[0],
+		OutputOffset: offs[1],
+		bits:         bits,
+		window:       append([]byte(nil), buf...),
+	}
+	return nil
+}
+
+// Checkpoint returns a snapshot of the Reader's state, which is only possible
+// when decompression has stopped at a block boundary before the end of the
+// stream. The checkpoint resumes output after all of the data decompressed so
+// far, including any buffered data that has not yet been read.
+func (zr *Reader) Checkpoint() (*Checkpoint, error) {
+	if zr.err != nil || !zr.blkStart {
+		return nil, errNoCheckpoint
+	}
+	pos := zr.rd.BitsRead()
+	return &Checkpoint{
+		InputOffset:  pos / 8,
+		OutputOffset: zr.OutputOffset + int64(len(zr.toRead)+zr.dict.wrPos-zr.dict.rdPos),
+		bits:         uint8(pos % 8),
+		window:       zr.dict.Window(nil),
+	}, nil
+}
+
+// Restore discards the Reader's state and resumes decompression from the
+// checkpoint, reading from r. The caller must position r at cp.InputOffset
+// in the compressed stream. Afterwards, the Reader's offsets are relative to
+// the start of the original stream.
+func (zr *Reader) Restore(r io.Reader, cp *Checkpoint) error {
+	zr.Reset(r)
+	zr.InputOffset, zr.OutputOffset = cp.InputOffset, cp.OutputOffset
+	zr.dict.Preset(cp.window)
+
+	// Skip the bits of the first byte that belong to the prior block.
+	zr.rd.Offset = zr.InputOffset
+	func() {
+		defer errors.Recover(&zr.err)
+		zr.rd.ReadBits(uint(cp.bits))
+	}()
+	var err error
+	if zr.InputOffset, err = zr.rd.Flush(); err != nil {
+		zr.err = err
+	}
+	zr.err = errWrap(zr.err, errors.Corrupted)
+	return zr.err
+}
@@ -0,0 +1,106 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package flate
+
+import (
+	"bufio"
+	"bytes"
+	"compress/flate"
+	"io"
+	"io/ioutil"
+	"testing"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+func TestCheckpoint(t *testing.T) {
+	rand := testutil.NewRand(0)
+	for _, f := range []string{"random.bin", "repeats.bin", "twain.txt"} {
+		for _, lvl := range []int{flate.NoCompression, flate.HuffmanOnly, flate.BestSpeed, flate.BestCompression} {
+			output := testutil.MustLoadFile("../testdata/" + f)[:1<<17]
+			var bb bytes.Buffer
+			zw, _ := flate.NewWriter(&bb, lvl)
+			for i := 0; i < len(output); i += 1 << 13 {
+				zw.Write(output[i : i+1<<13])
+				if rand.Intn(2) == 0 {
+					zw.Flush()
+				}
+			}
+			zw.Close()
+			input := bb.Bytes()
+
+			// Collect checkpoints while reading with small buffers.
+			var cps []*Checkpoint
+			zr, _ := NewReader(bytes.NewReader(input), nil)
+			buf := make([]byte, 1<<12)
+			for {
+				_, err := zr.Read(buf)
+				if err == io.EOF {
+					break
+				}
+				if err != nil {
+					t.Fatalf("%s/%d: Read() = %v", f, lvl, err)
+				}
+				if cp, err := zr.Checkpoint(); err == nil {
+					cps = append(cps, cp)
+				} else if err != errNoCheckpoint {
+					t.Fatalf("%s/%d: Checkpoint() = %v", f, lvl, err)
+				}
+			}
+			if len(cps) < 2 {
+				t.Errorf("%s/%d: got %d checkpoints, want at least 2", f, lvl, len(cps))
+			}
+
+			// Resume from each checkpoint after a round-trip through its
+			// binary encoding, using both buffered and unbuffered inputs.
+			for i, cp := range cps {
+				b, _ := cp.MarshalBinary()
+				cp = new(Checkpoint)
+				if err := cp.UnmarshalBinary(b); err != nil {
+					t.Fatalf("%s/%d, checkpoint %d: UnmarshalBinary() = %v", f, lvl, i, err)
+				}
+				var r io.Reader = struct{ io.Reader }{bytes.NewReader(input[cp.InputOffset:])}
+				if i%2 == 1 {
+					r = bufio.NewReader(r)
+				}
+				zr := new(Reader)
+				if err := zr.Restore(r, cp); err != nil {
+					t.Fatalf("%s/%d, checkpoint %d: Restore() = %v", f, lvl, i, err)
+				}
+				got, err := ioutil.ReadAll(zr)
+				if err != nil {
+					t.Errorf("%s/%d, checkpoint %d: ReadAll() = %v", f, lvl, i, err)
+				}
+				if !bytes.Equal(got, output[cp.OutputOffset:]) {
+					t.Errorf("%s/%d, checkpoint %d: output mismatch", f, lvl, i)
+				}
+				if zr.InputOffset != int64(len(input)) || zr.OutputOffset != int64(len(output)) {
+					t.Errorf("%s/%d, checkpoint %d: offsets = (%d, %d), want (%d, %d)",
+						f, lvl, i, zr.InputOffset, zr.OutputOffset, len(input), len(output))
+				}
+			}
+		}
+	}
+
+	// Checkpoints are not possible in the middle of a block.
+	var bb bytes.Buffer
+	zw, _ := flate.NewWriter(&bb, flate.NoCompression)
+	zw.Write(make([]byte, 1<<14))
+	zw.Close()
+	zr, _ := NewReader(&bb, nil)
+	if _, err := zr.Read(make([]byte, 1)); err != nil {
+		t.Fatalf("Read() = %v", err)
+	}
+	if _, err := zr.Checkpoint(); err != errNoCheckpoint {
+		t.Errorf("Checkpoint() = %v, want %v", err, errNoCheckpoint)
+	}
+
+	// Malformed checkpoints are rejected.
+	for _, b := range [][]byte{nil, {0, 0, 0, 0}, {checkpointVersion, 8, 0, 0}, {checkpointVersion, 0, 0, 0, 'x'}} {
+		if err := new(Checkpoint).UnmarshalBinary(b); err == nil {
+			t.Errorf("UnmarshalBinary(%x) = nil, want error", b)
+		}
+	}
+}
@@ -0,0 +1,126 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package flate
+
+import (
+	"io"
+
+	"github.com/dsnet/compress/internal"
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// pushStepSize is the maximum amount of data decompressed by a single step of
+// a Decompressor. Since a step that runs out of input is rolled back and
+// retried later, this bounds the amount of redundant work and the amount of
+// history that must be saved before each step.
+const pushStepSize = 1 << 10
+
+// Decompressor is a push-style DEFLATE decompressor. Rather than pulling input
+// from an io.Reader, the caller provides both the input and the output buffer
+// on each call to Decompress, which never blocks. This allows many streams to
+// be multiplexed on a few goroutines.
+type Decompressor struct {
+	InputOffset  int64 // Total number of bytes consumed from the input
+	OutputOffset int64 // Total number of bytes produced as output
+
+	zr   Reader
+	src  internal.PushReader
+	hist []byte // Copy of the history that a step may overwrite
+}
+
+// NewDecompressor returns a new Decompressor.
+//
+// The WorkBudget of conf is validated but otherwise unused, since each step of
+// a Decompressor is already limited to pushStepSize bytes of output and each
+// call to Decompress produces at most len(out) bytes.
+func NewDecompressor(conf *ReaderConfig) (*Decompressor, error) {
+	zd := new(Decompressor)
+	if conf != nil {
+		if conf.WorkBudget < 0 {
+			return nil, errorf(errors.Invalid, "invalid work budget: %d", conf.WorkBudget)
+		}
+	}
+	zd.Reset()
+	return zd, nil
+}
+
+func (zd *Decompressor) Reset() error {
+	*zd = Decompressor{zr: zd.zr, src: zd.src, hist: zd.hist}
+	zd.src.Reset()
+	zd.zr.Reset(&zd.src)
+	zd.zr.dict.SetMaxWrite(pushStepSize)
+	return nil
+}
+
+// Decompress decompresses data from in into out, returning the number of
+// bytes consumed from in and the number of bytes produced into out.
+//
+// Input that has been consumed, but cannot be decoded yet (such as a partial
+// prefix code), is retained internally. Thus, the caller must resubmit only
+// in[consumed:] on the next call, which is only non-empty if out was filled or
+// the end of the stream was reached.
+//
+// It returns io.EOF once the entire stream has been decompressed and emitted,
+// in which case in[consumed:] is any data that follows the stream.
+// A nil error with produced < len(out) means that more input is needed.
+// Any other error is persistent.
+func (zd *Decompressor) Decompress(in, out []byte) (consumed, produced int, err error) {
+	zr := &zd.zr
+	zd.src.Begin(in)
+	var needInput bool
+	for {
+		if len(zr.toRead) > 0 {
+			cnt := copy(out[produced:], zr.toRead)
+			zr.toRead = zr.toRead[cnt:]
+			produced += cnt
+			if len(zr.toRead) > 0 {
+				break
+			}
+		}
+		if zr.err != nil || produced == len(out) {
+			break
+		}
+		if !zd.step() && !zd.src.More() {
+			needInput = true
+			break
+		}
+	}
+	consumed = zd.src.End(needInput)
+	zd.InputOffset += int64(consumed)
+	zd.OutputOffset += int64(produced)
+	if len(zr.toRead) == 0 {
+		err = zr.err
+	}
+	return consumed, produced, err
+}
+
+// step performs the next step of decompression. If the step runs out of
+// input, then all of its effects are undone and it reports false.
+func (zd *Decompressor) step() bool {
+	zr := &zd.zr
+	saved, pos := *zr, zd.src.Mark()
+	end := zr.dict.wrLimit + histSlop // Wide copies may write past wrLimit
+	if end > len(zr.dict.hist) {
+		end = len(zr.dict.hist)
+	}
+	zd.hist = append(zd.hist[:0], zr.dict.hist[zr.dict.wrPos:end]...)
+	zr.doStep()
+	if zr.err != internal.ErrNeedInput {
+		return true
+	}
+	*zr = saved
+	copy(zr.dict.hist[zr.dict.wrPos:], zd.hist)
+	zd.src.Rewind(pos)
+	return false
+}
+
+// Close reports io.ErrUnexpectedEOF if the end of the stream has not been
+// reached, otherwise it returns the persistent error (if any).
+func (zd *Decompressor) Close() error {
+	if zd.zr.err == nil {
+		zd.zr.err = io.ErrUnexpectedEOF
+	}
+	return zd.zr.Close()
+}
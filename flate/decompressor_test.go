@@ -0,0 +1,119 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package flate
+
+import (
+	"bytes"
+	"compress/flate"
+	"io"
+	"testing"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+func TestDecompressor(t *testing.T) {
+	lf := testutil.MustLoadFile
+	var vectors []struct {
+		desc   string
+		input  []byte
+		output []byte
+	}
+	for _, f := range []string{"zeros.bin", "random.bin", "repeats.bin", "twain.txt"} {
+		for _, lvl := range []int{flate.NoCompression, flate.HuffmanOnly, flate.BestSpeed, flate.BestCompression} {
+			output := lf("../testdata/" + f)[:1<<16] // Larger than the window
+			var bb bytes.Buffer
+			zw, _ := flate.NewWriter(&bb, lvl)
+			zw.Write(output[:len(output)/2])
+			zw.Flush() // Produce an empty raw block
+			zw.Write(output[len(output)/2:])
+			zw.Close()
+			vectors = append(vectors, struct {
+				desc   string
+				input  []byte
+				output []byte
+			}{f, bb.Bytes(), output})
+		}
+	}
+
+	rand := testutil.NewRand(0)
+	trailer := []byte("trailer")
+	for i, v := range vectors {
+		for _, max := range []struct{ in, out int }{{1, 1 << 16}, {7, 3}, {1 << 10, 1 << 10}, {1 << 20, 1 << 20}} {
+			zd, _ := NewDecompressor(nil)
+			input := append(append([]byte(nil), v.input...), trailer...)
+			output, consumed, err := testutil.PushDecompress(zd, input, rand, max.in, max.out)
+			if err != io.EOF {
+				t.Errorf("test %d (%s), max %v: Decompress() = %v, want io.EOF", i, v.desc, max, err)
+			}
+			if !bytes.Equal(output, v.output) {
+				t.Errorf("test %d (%s), max %v: output mismatch", i, v.desc, max)
+			}
+			if consumed != len(v.input) || zd.InputOffset != int64(len(v.input)) {
+				t.Errorf("test %d (%s), max %v: consumed = (%d, %d), want %d", i, v.desc, max, consumed, zd.InputOffset, len(v.input))
+			}
+			if err := zd.Close(); err != nil {
+				t.Errorf("test %d (%s), max %v: Close() = %v", i, v.desc, max, err)
+			}
+		}
+
+		// Truncated streams are only detected by Close.
+		zd, _ := NewDecompressor(nil)
+		output, _, err := testutil.PushDecompress(zd, v.input[:len(v.input)-1], rand, 1<<10, 1<<10)
+		if err != nil {
+			t.Errorf("test %d (%s): Decompress() = %v, want nil", i, v.desc, err)
+		}
+		if !bytes.HasPrefix(v.output, output) {
+			t.Errorf("test %d (%s): output is not a prefix", i, v.desc)
+		}
+		if err := zd.Close(); err != io.ErrUnexpectedEOF {
+			t.Errorf("test %d (%s): Close() = %v, want io.ErrUnexpectedEOF", i, v.desc, err)
+		}
+	}
+
+	// Corrupt streams report a persistent error.
+	zd, _ := NewDecompressor(nil)
+	if _, _, err := zd.Decompress([]byte{0x07}, make([]byte, 10)); err == nil || err == io.EOF {
+		t.Errorf("Decompress() = %v, want corruption error", err)
+	}
+	if err := zd.Close(); err == nil {
+		t.Errorf("Close() = nil, want corruption error")
+	}
+
+	if _, err := NewDecompressor(&ReaderConfig{WorkBudget: -1}); err == nil {
+		t.Errorf("NewDecompressor(WorkBudget: -1) = nil, want error")
+	}
+}
+
+func BenchmarkDecompressor(b *testing.B) {
+	output := testutil.MustLoadFile("../testdata/twain.txt")
+	var bb bytes.Buffer
+	zw, _ := flate.NewWriter(&bb, flate.DefaultCompression)
+	zw.Write(output)
+	zw.Close()
+	input := bb.Bytes()
+	zd, _ := NewDecompressor(nil)
+	out := make([]byte, 1<<14)
+
+	b.SetBytes(int64(len(output)))
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		zd.Reset()
+		for in := input; ; {
+			n := 1 << 12
+			if n > len(in) {
+				n = len(in)
+			}
+			nc, _, err := zd.Decompress(in[:n], out)
+			in = in[nc:]
+			if err == io.EOF {
+				break
+			}
+			if err != nil {
+				b.Fatalf("Decompress() = %v", err)
+			}
+		}
+	}
+}
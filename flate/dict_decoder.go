@@ -4,6 +4,8 @@
 
 package flate
 
+import "github.com/dsnet/compress/internal"
+
 // The dictDecoder implements the LZ77 sliding dictionary that is commonly used
 // in various compression formats. For performance reasons, this implementation
 // performs little to no sanity checks about the arguments. As such, the
@@ -14,37 +16,49 @@ package flate
 const (
 	initSize   = 4096 // Initial size allocated for sliding dictionary
 	growFactor = 4    // Rate the dictionary is grown to match expected size
+
+	// The wide copies used in unsafe builds may overwrite up to histSlop bytes
+	// past the end of a copy. To ensure that those bytes are never referenced,
+	// the ring buffer is histSlop bytes longer than the window size, and
+	// hist always has at least histSlop bytes of spare capacity.
+	histSlop = internal.WideCopySlop
 )
 
 type dictDecoder struct {
-	// Invariant: len(hist) <= size
+	// Invariant: len(hist) <= size+histSlop <= cap(hist)
 	size int    // Sliding window size
 	hist []byte // Sliding window history, dynamically grown to match size
 
-	// Invariant: 0 <= rdPos <= wrPos <= len(hist)
-	wrPos int  // Current output position in buffer
-	rdPos int  // Have emitted hist[:rdPos] already
-	full  bool // Has a full window length been written yet?
+	// Invariant: 0 <= rdPos <= wrPos <= wrLimit <= len(hist)
+	wrPos   int  // Current output position in buffer
+	rdPos   int  // Have emitted hist[:rdPos] already
+	wrLimit int  // Limit on wrPos until the next ReadFlush
+	full    bool // Has a full window length been written yet?
+
+	// If non-zero, this limits the amount of data written between calls to
+	// ReadFlush, which bounds how much of hist is modified at a time.
+	maxWrite int
 }
 
 func (dd *dictDecoder) Init(size int) {
-	*dd = dictDecoder{hist: dd.hist}
+	*dd = dictDecoder{hist: dd.hist, maxWrite: dd.maxWrite}
 
 	// Regardless of what size claims, start with a small dictionary to avoid
 	// denial-of-service attacks with large memory allocation.
 	dd.size = size
 	if dd.hist == nil {
-		dd.hist = make([]byte, initSize)
+		dd.hist = make([]byte, initSize, initSize+histSlop)
 	}
-	dd.hist = dd.hist[:cap(dd.hist)]
-	if len(dd.hist) > dd.size {
-		dd.hist = dd.hist[:dd.size]
+	dd.hist = dd.hist[:cap(dd.hist)-histSlop]
+	if len(dd.hist) > dd.size+histSlop {
+		dd.hist = dd.hist[:dd.size+histSlop]
 	}
+	dd.setLimit()
 }
 
 // HistSize reports the total amount of historical data in the dictionary.
 func (dd *dictDecoder) HistSize() int {
-	if dd.full {
+	if dd.full || dd.wrPos > dd.size {
 		return dd.size
 	}
 	return dd.wrPos
@@ -52,14 +66,14 @@ func (dd *dictDecoder) HistSize() int {
 
 // AvailSize reports the available amount of output buffer space.
 func (dd *dictDecoder) AvailSize() int {
-	return len(dd.hist) - dd.wrPos
+	return dd.wrLimit - dd.wrPos
 }
 
 // WriteSlice returns a slice of the available buffer to write data to.
 //
 // This invariant will be kept: len(s) <= AvailSize()
 func (dd *dictDecoder) WriteSlice() []byte {
-	return dd.hist[dd.wrPos:]
+	return dd.hist[dd.wrPos:dd.wrLimit]
 }
 
 // WriteMark advances the write pointer by cnt.
@@ -86,9 +100,14 @@ func (dd *dictDecoder) WriteByte(c byte) {
 func (dd *dictDecoder) TryWriteCopy(dist, length int) int {
 	wrPos := dd.wrPos
 	wrEnd := wrPos + length
-	if wrPos < dist || wrEnd > len(dd.hist) {
+	if wrPos < dist || wrEnd > dd.wrLimit {
 		return 0
 	}
+	if internal.Unsafe && dist >= 8 {
+		internal.WideCopy(dd.hist, wrPos, wrPos-dist, wrEnd)
+		dd.wrPos = wrEnd
+		return length
+	}
 
 	// Copy overlapping section before destination.
 	wrBase := wrPos
@@ -112,8 +131,8 @@ func (dd *dictDecoder) WriteCopy(dist, length int) int {
 	wrPos := wrBase
 	rdPos := wrPos - dist
 	wrEnd := wrPos + length
-	if wrEnd > len(dd.hist) {
-		wrEnd = len(dd.hist)
+	if wrEnd > dd.wrLimit {
+		wrEnd = dd.wrLimit
 	}
 
 	// Copy non-overlapping section after destination.
@@ -124,6 +143,10 @@ func (dd *dictDecoder) WriteCopy(dist, length int) int {
 	}
 
 	// Copy overlapping section before destination.
+	if internal.Unsafe && wrPos-rdPos >= 8 {
+		internal.WideCopy(dd.hist, wrPos, rdPos, wrEnd)
+		wrPos = wrEnd
+	}
 	for wrPos < wrEnd {
 		wrPos += copy(dd.hist[wrPos:wrEnd], dd.hist[rdPos:wrPos])
 	}
@@ -138,19 +161,61 @@ func (dd *dictDecoder) ReadFlush() []byte {
 	toRead := dd.hist[dd.rdPos:dd.wrPos]
 	dd.rdPos = dd.wrPos
 	if dd.wrPos == len(dd.hist) {
-		if len(dd.hist) == dd.size {
+		if len(dd.hist) == dd.size+histSlop {
 			dd.wrPos, dd.rdPos = 0, 0
 			dd.full = true
 		} else {
 			// Allocate a larger history buffer.
-			size := cap(dd.hist) * growFactor
-			if size > dd.size {
-				size = dd.size
+			size := len(dd.hist) * growFactor
+			if size > dd.size+histSlop {
+				size = dd.size + histSlop
 			}
-			hist := make([]byte, size)
+			hist := make([]byte, size, size+histSlop)
 			copy(hist, dd.hist)
 			dd.hist = hist
 		}
 	}
+	dd.setLimit()
 	return toRead
 }
+
+// SetMaxWrite limits the amount of data that may be written between calls to
+// ReadFlush to n bytes, where zero means no limit other than len(hist).
+func (dd *dictDecoder) SetMaxWrite(n int) {
+	dd.maxWrite = n
+	dd.setLimit()
+}
+
+func (dd *dictDecoder) setLimit() {
+	dd.wrLimit = len(dd.hist)
+	if dd.maxWrite > 0 && dd.wrLimit-dd.wrPos > dd.maxWrite {
+		dd.wrLimit = dd.wrPos + dd.maxWrite
+	}
+}
+
+// Window appends the historical data in the dictionary to buf in the order
+// that it was written. At most size bytes are appended.
+func (dd *dictDecoder) Window(buf []byte) []byte {
+	if dd.full {
+		// Skip the oldest histSlop bytes, which are beyond the window size.
+		i := dd.wrPos + histSlop
+		if i > len(dd.hist) {
+			return append(buf, dd.hist[i-len(dd.hist):dd.wrPos]...)
+		}
+		buf = append(buf, dd.hist[i:]...)
+	}
+	return append(buf, dd.hist[:dd.wrPos]...)
+}
+
+// Preset writes buf into the dictionary as historical data that will not be
+// emitted by ReadFlush.
+//
+// This invariant must be kept: HistSize() == 0
+func (dd *dictDecoder) Preset(buf []byte) {
+	for len(buf) > 0 {
+		cnt := copy(dd.WriteSlice(), buf)
+		dd.WriteMark(cnt)
+		dd.ReadFlush()
+		buf = buf[cnt:]
+	}
+}
@@ -14,6 +14,7 @@ import (
 	// round-trip test.
 	"compress/flate"
 
+	"github.com/dsnet/compress"
 	"github.com/dsnet/compress/internal/testutil"
 )
 
@@ -93,6 +94,28 @@ func TestRoundTrip(t *testing.T) {
 	}
 }
 
+func TestBufferedOutput(t *testing.T) {
+	var _ compress.BufferedReader = (*Reader)(nil)
+	for i, v := range testdata {
+		var buf bytes.Buffer
+		wr, _ := flate.NewWriter(&buf, flate.DefaultCompression)
+		wr.Write(v.data)
+		wr.Close()
+
+		rd, _ := NewReader(&buf, nil)
+		output, err := testutil.ReadAllBuffered(rd, i)
+		if err != nil {
+			t.Errorf("test %d, ReadAllBuffered() = %v, want nil", i, err)
+		}
+		if got, want, ok := testutil.BytesCompare(output, v.data); !ok {
+			t.Errorf("test %d, output data mismatch:\ngot  %s\nwant %s", i, got, want)
+		}
+		if rd.OutputOffset != int64(len(v.data)) {
+			t.Errorf("test %d, output offset mismatch: got %d, want %d", i, rd.OutputOffset, len(v.data))
+		}
+	}
+}
+
 // syncBuffer is a special reader that records whether the Reader ever tried to
 // read past the io.EOF. Since the flate Writer and Reader should be in sync,
 // the reader should never attempt to read past the sync marker, otherwise the
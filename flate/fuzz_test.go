@@ -0,0 +1,69 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+// +build go1.18
+
+package flate
+
+import (
+	"bytes"
+	"compress/flate"
+	"io"
+	"io/ioutil"
+	"testing"
+	"time"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+// maxFuzzOutput is the maximum number of bytes decompressed for any input.
+const maxFuzzOutput = 1 << 22
+
+// fuzzCost is the maximum cost that decoding a single input may incur.
+var fuzzCost = testutil.CostBound{
+	TimeFixed:    100 * time.Millisecond,
+	TimePerByte:  1 * time.Microsecond,
+	AllocFixed:   1 << 20,
+	AllocPerByte: 16,
+}
+
+// FuzzReader checks that the Reader does not panic, that it agrees with the
+// standard library on which inputs are valid, and that the cost of decoding
+// any input is proportional to the size of the input and output.
+func FuzzReader(f *testing.F) {
+	for _, v := range testdata {
+		if len(v.data) > 1<<12 {
+			v.data = v.data[:1<<12]
+		}
+		var buf bytes.Buffer
+		wr, _ := flate.NewWriter(&buf, flate.DefaultCompression)
+		wr.Write(v.data)
+		wr.Close()
+		f.Add(buf.Bytes())
+	}
+
+	f.Fuzz(func(t *testing.T, data []byte) {
+		var got []byte
+		var gerr error
+		c := testutil.MeasureCost(func() int64 {
+			rd, _ := NewReader(bytes.NewReader(data), nil)
+			got, gerr = ioutil.ReadAll(io.LimitReader(rd, maxFuzzOutput))
+			if err := rd.Close(); gerr == nil && len(got) < maxFuzzOutput {
+				gerr = err
+			}
+			return int64(len(data) + len(got))
+		})
+		if err := fuzzCost.Check(c); err != nil {
+			t.Error(err)
+		}
+
+		want, werr := ioutil.ReadAll(io.LimitReader(flate.NewReader(bytes.NewReader(data)), maxFuzzOutput))
+		if (gerr == nil) != (werr == nil) {
+			t.Fatalf("mismatching error: got %v, want %v", gerr, werr)
+		}
+		if gerr == nil && !bytes.Equal(got, want) {
+			t.Fatalf("mismatching output")
+		}
+	})
+}
@@ -20,15 +20,20 @@ const (
 )
 
 // RFC section 3.2.5.
-var lenRanges = func() prefix.RangeCodes {
-	return append(prefix.MakeRangeCodes(3, []uint{
+//
+// These are fixed-size arrays indexed by the symbol so that lookups in the
+// decoder are provably in bounds. The first 257 entries of lenRanges are unused.
+var lenRanges = func() (rcs [maxNumLitSyms]prefix.RangeCode) {
+	copy(rcs[257:], append(prefix.MakeRangeCodes(3, []uint{
 		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5,
-	}), prefix.RangeCode{Base: 258, Len: 0})
+	}), prefix.RangeCode{Base: 258, Len: 0}))
+	return rcs
 }()
-var distRanges = func() prefix.RangeCodes {
-	return prefix.MakeRangeCodes(1, []uint{
+var distRanges = func() (rcs [maxNumDistSyms]prefix.RangeCode) {
+	copy(rcs[:], prefix.MakeRangeCodes(1, []uint{
 		0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
-	})
+	}))
+	return rcs
 }()
 
 // RFC section 3.2.6.
@@ -14,14 +14,19 @@ import (
 type Reader struct {
 	InputOffset  int64 // Total number of bytes read from underlying io.Reader
 	OutputOffset int64 // Total number of bytes emitted from Read
+	NumSymbols   int64 // Total number of literal and length symbols decoded
 
-	rd     prefixReader // Input source
-	toRead []byte       // Uncompressed data ready to be emitted from Read
-	dist   int          // The current distance
-	blkLen int          // Uncompressed bytes left to read in meta-block
-	cpyLen int          // Bytes left to backward dictionary copy
-	last   bool         // Last block bit detected
-	err    error        // Persistent error
+	rd      prefixReader // Input source
+	toRead  []byte       // Uncompressed data ready to be emitted from Read
+	peekBuf []byte       // Buffer to accumulate data for Peek
+	dist    int          // The current distance
+	blkLen  int          // Uncompressed bytes left to read in meta-block
+	cpyLen  int          // Bytes left to backward dictionary copy
+	last    bool         // Last block bit detected
+	err     error        // Persistent error
+	budget  int          // Maximum work per call to Read (zero means unlimited)
+
+	blkStart bool // The next step reads a block header
 
 	step      func(*Reader) // Single step of decompression work (can panic)
 	stepState int           // The sub-step state for certain steps
@@ -33,29 +38,51 @@ type Reader struct {
 }
 
 type ReaderConfig struct {
+	// WorkBudget is a soft limit on the work performed by a single call to
+	// Read, as measured in bytes of output produced. Read decodes until some
+	// output is available and then returns at most the budget, which allows
+	// a long stream to yield cooperatively. Input that produces no output,
+	// such as a run of empty blocks, is always decoded within the same call.
+	// If zero, Read decodes until output is available.
+	WorkBudget int
+
 	_ struct{} // Blank field to prevent unkeyed struct literals
 }
 
 func NewReader(r io.Reader, conf *ReaderConfig) (*Reader, error) {
 	zr := new(Reader)
+	if conf != nil {
+		if conf.WorkBudget < 0 {
+			return nil, errorf(errors.Invalid, "invalid work budget: %d", conf.WorkBudget)
+		}
+		zr.budget = conf.WorkBudget
+	}
 	zr.Reset(r)
 	return zr, nil
 }
 
 func (zr *Reader) Reset(r io.Reader) error {
 	*zr = Reader{
-		rd:   zr.rd,
-		step: (*Reader).readBlockHeader,
-		dict: zr.dict,
-		pd1:  zr.pd1,
-		pd2:  zr.pd2,
+		rd:      zr.rd,
+		step:    (*Reader).readBlockHeader,
+		dict:    zr.dict,
+		pd1:     zr.pd1,
+		pd2:     zr.pd2,
+		peekBuf: zr.peekBuf[:0],
+		budget:  zr.budget,
+
+		blkStart: true,
 	}
 	zr.rd.Init(r)
 	zr.dict.Init(maxHistSize)
+	zr.dict.SetMaxWrite(zr.budget)
 	return nil
 }
 
 func (zr *Reader) Read(buf []byte) (int, error) {
+	// The dictionary limits each step to budget bytes of output. Steps that
+	// produce no output are never interrupted, so that Read always makes
+	// progress unless an error occurs.
 	for {
 		if len(zr.toRead) > 0 {
 			cnt := copy(buf, zr.toRead)
@@ -69,21 +96,80 @@ func (zr *Reader) Read(buf []byte) (int, error) {
 		if zr.err != nil {
 			return 0, zr.err
 		}
+		zr.doStep()
+	}
+}
+
+// Buffered reports the number of decompressed bytes that can be obtained from
+// Peek or Discard without performing further decompression work.
+func (zr *Reader) Buffered() int {
+	return len(zr.toRead)
+}
+
+// Peek returns the next n decompressed bytes without advancing the reader.
+// If n <= Buffered(), then the returned slice aliases the sliding window and
+// no copy is made. Otherwise, the decompressed output is accumulated into an
+// internal buffer until n bytes are available.
+//
+// The result is only valid until the next call to Read, Peek, or Discard.
+func (zr *Reader) Peek(n int) ([]byte, error) {
+	if n < 0 {
+		return nil, errorf(errors.Invalid, "negative count")
+	}
+	for len(zr.toRead) < n {
+		if zr.err != nil {
+			return zr.toRead, zr.err
+		}
+		zr.peekBuf = append(zr.peekBuf[:0], zr.toRead...)
+		zr.toRead = nil
+		zr.doStep()
+		zr.peekBuf = append(zr.peekBuf, zr.toRead...)
+		zr.toRead = zr.peekBuf
+	}
+	return zr.toRead[:n], nil
+}
 
-		// Perform next step in decompression process.
-		zr.rd.Offset = zr.InputOffset
-		func() {
-			defer errors.Recover(&zr.err)
-			zr.step(zr)
-		}()
-		var err error
-		if zr.InputOffset, err = zr.rd.Flush(); err != nil {
-			zr.err = err
+// Discard skips the next n decompressed bytes, returning the number of bytes
+// discarded. If Discard skips fewer than n bytes, it also returns an error.
+func (zr *Reader) Discard(n int) (int, error) {
+	if n < 0 {
+		return 0, errorf(errors.Invalid, "negative count")
+	}
+	var cnt int
+	for cnt < n {
+		if len(zr.toRead) == 0 {
+			if zr.err != nil {
+				return cnt, zr.err
+			}
+			zr.doStep()
+			continue
 		}
-		zr.err = errWrap(zr.err, errors.Corrupted)
-		if zr.err != nil && len(zr.toRead) == 0 {
-			zr.toRead = zr.dict.ReadFlush() // Flush what's left in case of error
+		m := n - cnt
+		if m > len(zr.toRead) {
+			m = len(zr.toRead)
 		}
+		zr.toRead = zr.toRead[m:]
+		zr.OutputOffset += int64(m)
+		cnt += m
+	}
+	return cnt, nil
+}
+
+// doStep performs the next step in the decompression process.
+// It may only be called when all of toRead has been consumed.
+func (zr *Reader) doStep() {
+	zr.rd.Offset = zr.InputOffset
+	func() {
+		defer errors.Recover(&zr.err)
+		zr.step(zr)
+	}()
+	var err error
+	if zr.InputOffset, err = zr.rd.Flush(); err != nil {
+		zr.err = err
+	}
+	zr.err = errWrap(zr.err, errors.Corrupted)
+	if zr.err != nil && len(zr.toRead) == 0 {
+		zr.toRead = zr.dict.ReadFlush() // Flush what's left in case of error
 	}
 }
 
@@ -98,6 +184,7 @@ func (zr *Reader) Close() error {
 
 // readBlockHeader reads the block header according to RFC section 3.2.3.
 func (zr *Reader) readBlockHeader() {
+	zr.blkStart = false
 	zr.last = zr.rd.ReadBits(1) == 1
 	switch zr.rd.ReadBits(2) {
 	case 0:
@@ -187,6 +274,7 @@ readLiteral:
 		if !ok {
 			litSym = zr.rd.ReadSymbol(zr.litTree)
 		}
+		zr.NumSymbols++
 		switch {
 		case litSym < endBlockSym:
 			zr.dict.WriteByte(byte(litSym))
@@ -197,7 +285,7 @@ readLiteral:
 			return
 		case litSym < maxNumLitSyms:
 			// Decode the copy length.
-			rec := lenRanges[litSym-257]
+			rec := lenRanges[litSym]
 			extra, ok := zr.rd.TryReadBits(uint(rec.Len))
 			if !ok {
 				extra = zr.rd.ReadBits(uint(rec.Len))
@@ -211,6 +299,7 @@ readLiteral:
 			}
 			if distSym >= maxNumDistSyms {
 				panicf(errors.Corrupted, "invalid distance symbol: %d", distSym)
+				return // Unreachable, but proves that distSym is in bounds
 			}
 
 			// Decode the copy distance.
@@ -256,4 +345,5 @@ func (zr *Reader) finishBlock() {
 		zr.err = io.EOF
 	}
 	zr.step = (*Reader).readBlockHeader
+	zr.blkStart = true
 }
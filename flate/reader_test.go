@@ -5,6 +5,7 @@
 package flate
 
 import (
+	"bufio"
 	"bytes"
 	"compress/flate"
 	"flag"
@@ -979,6 +980,63 @@ func TestReaderReset(t *testing.T) {
 	}
 }
 
+func TestReaderWorkBudget(t *testing.T) {
+	const budget = 1000
+	input := testutil.MustLoadFile("../testdata/twain.txt")
+	var bb bytes.Buffer
+	wr, _ := flate.NewWriter(&bb, flate.DefaultCompression)
+	wr.Write(input)
+	wr.Close()
+
+	rd, err := NewReader(bytes.NewReader(bb.Bytes()), &ReaderConfig{WorkBudget: budget})
+	if err != nil {
+		t.Fatalf("unexpected NewReader error: %v", err)
+	}
+	var output []byte
+	buf := make([]byte, 1<<16)
+	for {
+		n, err := rd.Read(buf)
+		if n > budget {
+			t.Fatalf("Read() = %d, want at most %d", n, budget)
+		}
+		output = append(output, buf[:n]...)
+		if err == io.EOF {
+			break
+		}
+		if err != nil {
+			t.Fatalf("unexpected Read error: %v", err)
+		}
+	}
+	if !bytes.Equal(output, input) {
+		t.Errorf("output mismatch")
+	}
+	if rd.NumSymbols == 0 || rd.NumSymbols >= int64(len(input)) {
+		t.Errorf("NumSymbols = %d, want within (0, %d)", rd.NumSymbols, len(input))
+	}
+
+	// Many empty blocks consume input without producing any output.
+	// Read must not return zero bytes with a nil error, since bufio.Reader
+	// gives up with io.ErrNoProgress after a number of such calls.
+	empty := strings.Repeat("\x00\x00\x00\xff\xff", 1000) + "\x01\x00\x00\xff\xff"
+	rd, _ = NewReader(strings.NewReader(empty), &ReaderConfig{WorkBudget: 100})
+	if n, err := rd.Read(buf); n != 0 || err != io.EOF {
+		t.Errorf("Read() = (%d, %v), want (0, EOF)", n, err)
+	}
+	stream := empty[:len(empty)-5] + string(bb.Bytes())
+	rd, _ = NewReader(strings.NewReader(stream), &ReaderConfig{WorkBudget: 10})
+	output, err = ioutil.ReadAll(bufio.NewReaderSize(rd, 16))
+	if err != nil {
+		t.Errorf("unexpected ReadAll error: %v", err)
+	}
+	if !bytes.Equal(output, input) {
+		t.Errorf("output mismatch")
+	}
+
+	if _, err := NewReader(nil, &ReaderConfig{WorkBudget: -1}); err == nil {
+		t.Errorf("NewReader(WorkBudget: -1) = nil, want error")
+	}
+}
+
 func BenchmarkDecode(b *testing.B) {
 	runBenchmarks(b, func(b *testing.B, data []byte, lvl int) {
 		b.StopTimer()
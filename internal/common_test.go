@@ -5,6 +5,7 @@
 package internal
 
 import (
+	"bytes"
 	"encoding/hex"
 	"testing"
 )
@@ -211,3 +212,41 @@ func TestMoveToFront(t *testing.T) {
 		}
 	}
 }
+
+func TestWideCopy(t *testing.T) {
+	const size = 256
+	for dist := 8; dist <= 40; dist++ {
+		for length := 0; length <= 100; length += 3 {
+			want := make([]byte, size)
+			for i := range want {
+				want[i] = byte(i*7 + 1)
+			}
+			got := make([]byte, size, size+WideCopySlop)
+			copy(got, want)
+
+			dst := size - WideCopySlop - length - 1
+			if dst < dist {
+				continue
+			}
+			for i := dst; i < dst+length; i++ {
+				want[i] = want[i-dist]
+			}
+			WideCopy(got, dst, dst-dist, dst+length)
+
+			// Bytes in the slop after the copy are allowed to differ.
+			end := dst + length + WideCopySlop
+			if !bytes.Equal(got[:dst+length], want[:dst+length]) || !bytes.Equal(got[end:], want[end:]) {
+				t.Errorf("WideCopy(dist:%d, length:%d) mismatch", dist, length)
+			}
+		}
+	}
+
+	var b [16]byte
+	StoreUint64LE(b[3:], 0x0102030405060708)
+	if got, want := hex.EncodeToString(b[:]), "00000008070605040302010000000000"; got != want {
+		t.Errorf("StoreUint64LE: got %s, want %s", got, want)
+	}
+	if got, want := LoadUint64LE(b[2:]), uint64(0x0203040506070800); got != want {
+		t.Errorf("LoadUint64LE = %#x, want %#x", got, want)
+	}
+}
@@ -152,7 +152,6 @@ func (pe Encoder) String() string {
 		}
 		ss = append(ss, "\t},")
 	}
-	ss = append(ss, fmt.Sprintf("\tchunkMask: %b,", pe.chunkMask))
 	ss = append(ss, fmt.Sprintf("\tNumSyms:   %d,", pe.NumSyms))
 	ss = append(ss, "}")
 	return strings.Join(ss, "\n")
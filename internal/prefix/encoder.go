@@ -10,9 +10,12 @@ import (
 	"github.com/dsnet/compress/internal"
 )
 
+// Encoder maps symbols to prefix codes. The codes are kept in a dense table
+// indexed directly by symbol, where each entry holds the bit-reversed value of
+// the code together with its bit-length, such that encoding a symbol is a
+// single table lookup.
 type Encoder struct {
-	chunks    []uint32 // First-level lookup map
-	chunkMask uint32   // Mask the length of the chunks table
+	chunks []uint32 // Table of codes indexed by symbol
 
 	NumSyms uint32 // Number of symbols
 }
@@ -25,8 +28,12 @@ func (pe *Encoder) Init(codes PrefixCodes) {
 		case len(codes) == 0: // Empty tree (should error if used later)
 			*pe = Encoder{chunks: pe.chunks[:0], NumSyms: 0}
 		case len(codes) == 1 && codes[0].Len == 0: // Single code tree (bit-length of zero)
-			pe.chunks = append(pe.chunks[:0], codes[0].Val<<countBits|0)
-			*pe = Encoder{chunks: pe.chunks[:1], NumSyms: 1}
+			chunks := allocUint32s(pe.chunks, int(codes[0].Sym)+1)
+			for i := range chunks {
+				chunks[i] = 0
+			}
+			chunks[codes[0].Sym] = codes[0].Val<<countBits | 0
+			*pe = Encoder{chunks: chunks, NumSyms: 1}
 		default:
 			panic("invalid codes")
 		}
@@ -39,28 +46,15 @@ func (pe *Encoder) Init(codes PrefixCodes) {
 		panic("detected incomplete or overlapping codes")
 	}
 
-	// Enough chunks to contain all the symbols.
-	numChunks := 1
-	for n := len(codes) - 1; n > 0; n >>= 1 {
-		numChunks <<= 1
-	}
-	pe.NumSyms = uint32(len(codes))
-
-retry:
-	// Allocate and reset chunks.
-	pe.chunks = allocUint32s(pe.chunks, numChunks)
-	pe.chunkMask = uint32(numChunks - 1)
+	// Enough chunks to contain all the symbols. Since the codes are sorted,
+	// the last one has the largest symbol. Symbols without a code are left
+	// with a zero entry, which encodes to nothing.
+	pe.chunks = allocUint32s(pe.chunks, int(codes[len(codes)-1].Sym)+1)
 	for i := range pe.chunks {
-		pe.chunks[i] = 0 // Logic below relies on zero value as uninitialized
+		pe.chunks[i] = 0
 	}
-
-	// Insert each symbol, checking that there are no conflicts.
 	for _, c := range codes {
-		if pe.chunks[c.Sym&pe.chunkMask] > 0 {
-			// Collision found our "hash" table, so grow and try again.
-			numChunks <<= 1
-			goto retry
-		}
-		pe.chunks[c.Sym&pe.chunkMask] = c.Val<<countBits | c.Len
+		pe.chunks[c.Sym] = c.Val<<countBits | c.Len
 	}
+	pe.NumSyms = uint32(len(codes))
 }
@@ -752,8 +752,12 @@ func TestPrefix(t *testing.T) {
 		rd.Init(rdwr, false)
 		wr.Init(rdwr, false)
 
-		// Write some symbols.
-		for _, sym := range syms {
+		// Write some symbols, with extra bits following every other symbol.
+		for i, sym := range syms {
+			if i%2 == 1 {
+				wr.WriteSymbolBits(sym, &pe, uint(i)&0x1fff, 13)
+				continue
+			}
 			ok := wr.TryWriteSymbol(sym, &pe)
 			if !ok {
 				wr.WriteSymbol(sym, &pe)
@@ -784,6 +788,11 @@ func TestPrefix(t *testing.T) {
 			if sym != syms[i] {
 				t.Errorf("test %d, read back wrong symbol: got %d, want %d", i, sym, syms[i])
 			}
+			if i%2 == 1 {
+				if v := rd.ReadBits(13); v != uint(i)&0x1fff {
+					t.Errorf("test %d, read back wrong extra bits: got %d, want %d", i, v, uint(i)&0x1fff)
+				}
+			}
 			if rd.numBits >= 8 {
 				t.Errorf("test %d, residual bits remaining: got %d, want < 8", i, rd.numBits)
 			}
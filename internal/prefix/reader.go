@@ -7,7 +7,6 @@ package prefix
 import (
 	"bufio"
 	"bytes"
-	"encoding/binary"
 	"io"
 	"strings"
 
@@ -181,10 +180,11 @@ func (pr *Reader) ReadBits(nb uint) uint {
 //
 // This method is designed to be inlined for performance reasons.
 func (pr *Reader) TryReadSymbol(pd *Decoder) (uint, bool) {
-	if pr.numBits < uint(pd.MinBits) || len(pd.chunks) == 0 {
+	chunks := pd.chunks
+	if pr.numBits < uint(pd.MinBits) || len(chunks) == 0 {
 		return 0, false
 	}
-	chunk := pd.chunks[uint32(pr.bufBits)&pd.chunkMask]
+	chunk := chunks[int(pr.bufBits)&(len(chunks)-1)] // len(chunks) is a power of two
 	nb := uint(chunk & countMask)
 	if nb > pr.numBits || nb > uint(pd.chunkBits) {
 		return 0, false
@@ -196,8 +196,10 @@ func (pr *Reader) TryReadSymbol(pd *Decoder) (uint, bool) {
 
 // ReadSymbol reads the next symbol using the provided prefix Decoder.
 func (pr *Reader) ReadSymbol(pd *Decoder) uint {
-	if len(pd.chunks) == 0 {
+	chunks := pd.chunks
+	if len(chunks) == 0 {
 		panicf(errors.Invalid, "decode with empty prefix tree")
+		return 0 // Unreachable, but proves that len(chunks) > 0
 	}
 
 	nb := uint(pd.MinBits)
@@ -205,11 +207,11 @@ func (pr *Reader) ReadSymbol(pd *Decoder) uint {
 		if err := pr.PullBits(nb); err != nil {
 			errors.Panic(err)
 		}
-		chunk := pd.chunks[uint32(pr.bufBits)&pd.chunkMask]
+		chunk := chunks[int(pr.bufBits)&(len(chunks)-1)]
 		nb = uint(chunk & countMask)
 		if nb > uint(pd.chunkBits) {
-			linkIdx := chunk >> countBits
-			chunk = pd.links[linkIdx][uint32(pr.bufBits>>pd.chunkBits)&pd.linkMask]
+			links := pd.links[chunk>>countBits]
+			chunk = links[int(pr.bufBits>>pd.chunkBits)&(len(links)-1)]
 			nb = uint(chunk & countMask)
 		}
 		if nb <= pr.numBits {
@@ -284,7 +286,7 @@ func (pr *Reader) PullBits(nb uint) error {
 			if len(pr.bufPeek) >= 8 {
 				// Starting with Go 1.7, the compiler should use a wide integer
 				// load here if the architecture supports it.
-				u := binary.LittleEndian.Uint64(pr.bufPeek)
+				u := internal.LoadUint64LE(pr.bufPeek)
 				if pr.bigEndian {
 					// Swap all the bits within each byte.
 					u = (u&0xaaaaaaaaaaaaaaaa)>>1 | (u&0x5555555555555555)<<1
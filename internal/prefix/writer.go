@@ -63,12 +63,12 @@ func (pw *Writer) Write(buf []byte) (cnt int, err error) {
 }
 
 // WriteOffset writes ofs in a (sym, extra) fashion using the provided prefix
-// Encoder and RangeEncoder.
+// Encoder and RangeEncoder. The symbol and its extra bits are emitted together
+// as a single write to the bit buffer.
 func (pw *Writer) WriteOffset(ofs uint, pe *Encoder, re *RangeEncoder) {
 	sym := re.Encode(ofs)
-	pw.WriteSymbol(sym, pe)
 	rc := re.rcs[sym]
-	pw.WriteBits(ofs-uint(rc.Base), uint(rc.Len))
+	pw.WriteSymbolBits(sym, pe, ofs-uint(rc.Base), uint(rc.Len))
 }
 
 // TryWriteBits attempts to write nb bits using the contents of the bit buffer
@@ -98,7 +98,7 @@ func (pw *Writer) WriteBits(v, nb uint) {
 //
 // This method is designed to be inlined for performance reasons.
 func (pw *Writer) TryWriteSymbol(sym uint, pe *Encoder) bool {
-	chunk := pe.chunks[uint32(sym)&pe.chunkMask]
+	chunk := pe.chunks[sym]
 	nb := uint(chunk & countMask)
 	if 64-pw.numBits < nb {
 		return false
@@ -113,12 +113,25 @@ func (pw *Writer) WriteSymbol(sym uint, pe *Encoder) {
 	if _, err := pw.PushBits(); err != nil {
 		errors.Panic(err)
 	}
-	chunk := pe.chunks[uint32(sym)&pe.chunkMask]
+	chunk := pe.chunks[sym]
 	nb := uint(chunk & countMask)
 	pw.bufBits |= uint64(chunk>>countBits) << pw.numBits
 	pw.numBits += nb
 }
 
+// WriteSymbolBits writes the symbol using the provided prefix Encoder,
+// immediately followed by nb bits of v. Both are merged into a single write to
+// the bit buffer, so the code length plus nb must not exceed 56 bits.
+func (pw *Writer) WriteSymbolBits(sym uint, pe *Encoder, v, nb uint) {
+	if _, err := pw.PushBits(); err != nil {
+		errors.Panic(err)
+	}
+	chunk := pe.chunks[sym]
+	cnb := uint(chunk & countMask)
+	pw.bufBits |= (uint64(chunk>>countBits) | uint64(v)<<cnb) << pw.numBits
+	pw.numBits += cnb + nb
+}
+
 // Flush flushes all complete bytes from the bit buffer to the byte buffer, and
 // then flushes all bytes in the byte buffer to the underlying writer.
 // After this call, the bit Writer is will only withhold 7 bits at most.
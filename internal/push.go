@@ -0,0 +1,153 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package internal
+
+import (
+	"errors"
+	"io"
+)
+
+// ErrNeedInput is reported by PushReader when a read cannot be satisfied by
+// the input that has been pushed so far.
+var ErrNeedInput = errors.New("compress: more input is needed")
+
+// PushReader is a compress.BufferedReader over input that is pushed by the
+// caller in discrete slices, rather than pulled from an io.Reader.
+// Instead of blocking once the input is exhausted, it reports ErrNeedInput,
+// allowing a decompressor to roll back to the start of its current step and
+// retry once more input is available.
+//
+// Each call to a push-style Decompress method is bracketed by Begin and End.
+// Input is read directly from the slice passed to Begin. Only if the previous
+// call ended in the middle of a step is the unread remainder retained in an
+// internal buffer, in which case the start of the next input is appended to
+// that buffer piecemeal until the decompressor reads past the retained bytes.
+type PushReader struct {
+	buf  []byte // Retained input, followed by in[:nin]
+	in   []byte // Input for the current call
+	nin  int    // Number of bytes of in appended to buf
+	data []byte // Either buf or in
+	pos  int    // Read offset into data
+}
+
+func (pr *PushReader) Reset() {
+	*pr = PushReader{buf: pr.buf[:0]}
+}
+
+// Begin starts a call with the input in, which is logically appended to any
+// input retained from the previous call.
+func (pr *PushReader) Begin(in []byte) {
+	pr.in, pr.nin = in, 0
+	pr.data, pr.pos = pr.buf, 0
+	pr.normalize()
+}
+
+// End ends the current call and returns the number of bytes consumed from in.
+// If retain is set, then all of the unread input is retained for the next
+// call. Otherwise, unread bytes of in may be left to the caller.
+func (pr *PushReader) End(retain bool) (n int) {
+	pr.normalize()
+	buffered := len(pr.buf) > 0
+	switch {
+	case retain && buffered:
+		pr.buf = append(pr.buf[:0], pr.buf[pr.pos:]...)
+		pr.buf = append(pr.buf, pr.in[pr.nin:]...)
+		n = len(pr.in)
+	case retain:
+		pr.buf = append(pr.buf, pr.in[pr.pos:]...)
+		n = len(pr.in)
+	case buffered:
+		// The decompressor may hold bits from any byte appended to buf,
+		// so none of them can be handed back to the caller.
+		pr.buf = append(pr.buf[:0], pr.buf[pr.pos:]...)
+		n = pr.nin
+	default:
+		n = pr.pos
+	}
+	pr.in, pr.data, pr.pos = nil, pr.buf, 0 // Buffered reports retained input
+	return n
+}
+
+// Mark returns the current read position for use with Rewind.
+// It must only be called between steps of the decompressor.
+func (pr *PushReader) Mark() int {
+	pr.normalize()
+	return pr.pos
+}
+
+// Rewind restores the read position to that returned by Mark.
+// There must be no intervening calls to Mark, More, or End.
+func (pr *PushReader) Rewind(pos int) {
+	pr.pos = pos
+}
+
+// More makes more of the current input available after a read failed with
+// ErrNeedInput. It reports false if all of the input is already available.
+func (pr *PushReader) More() bool {
+	const minChunk = 64
+	n := len(pr.in) - pr.nin
+	if len(pr.buf) == 0 || n == 0 {
+		return false
+	}
+	if m := 2*(len(pr.buf)-pr.pos) + minChunk; n > m {
+		n = m // Grow geometrically to bound the cost of retries
+	}
+	pr.buf = append(pr.buf, pr.in[pr.nin:pr.nin+n]...)
+	pr.data, pr.nin = pr.buf, pr.nin+n
+	return true
+}
+
+// normalize switches to reading directly from in once all of the retained
+// input has been read, since the remainder of buf is identical to in.
+func (pr *PushReader) normalize() {
+	if old := len(pr.buf) - pr.nin; pr.pos >= old {
+		pr.data, pr.pos = pr.in, pr.pos-old
+		pr.buf, pr.nin = pr.buf[:0], 0
+	}
+}
+
+func (pr *PushReader) Read(buf []byte) (int, error) {
+	if len(buf) == 0 {
+		return 0, nil
+	}
+	if pr.pos == len(pr.data) {
+		return 0, ErrNeedInput
+	}
+	n := copy(buf, pr.data[pr.pos:])
+	pr.pos += n
+	return n, nil
+}
+
+func (pr *PushReader) ReadByte() (byte, error) {
+	if pr.pos == len(pr.data) {
+		return 0, ErrNeedInput
+	}
+	c := pr.data[pr.pos]
+	pr.pos++
+	return c, nil
+}
+
+func (pr *PushReader) Buffered() int {
+	return len(pr.data) - pr.pos
+}
+
+func (pr *PushReader) Peek(n int) ([]byte, error) {
+	if n > len(pr.data)-pr.pos {
+		return pr.data[pr.pos:], ErrNeedInput
+	}
+	return pr.data[pr.pos : pr.pos+n], nil
+}
+
+func (pr *PushReader) Discard(n int) (int, error) {
+	if n > len(pr.data)-pr.pos {
+		n = len(pr.data) - pr.pos
+		pr.pos += n
+		return n, ErrNeedInput
+	}
+	pr.pos += n
+	return n, nil
+}
+
+var _ io.ByteReader = (*PushReader)(nil)
@@ -0,0 +1,82 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package testutil
+
+import (
+	"fmt"
+	"runtime"
+	"time"
+)
+
+// CostBound specifies the maximum resources that an operation may consume.
+// It is used to detect inputs that trigger algorithmic complexity attacks,
+// where an input is not invalid, but merely expensive to process.
+//
+// The bounds are amortized over the number of bytes processed (typically the
+// sum of the input and output lengths), with a fixed allowance to account for
+// per-stream setup costs such as table initialization and buffer allocation.
+type CostBound struct {
+	TimeFixed   time.Duration // Fixed allowance of time
+	TimePerByte time.Duration // Allowance of time per byte processed
+
+	AllocFixed   int64 // Fixed allowance of bytes allocated
+	AllocPerByte int64 // Allowance of bytes allocated per byte processed
+}
+
+// Cost records the resources consumed by an operation.
+//
+// Time is the CPU time of the OS thread that ran the operation, such that it
+// is unaffected by other load on the machine. On platforms where the CPU time
+// of a thread is unavailable, it is the wall-clock time instead.
+//
+// Alloc is measured using runtime.MemStats, which counts the allocations of
+// every goroutine. Thus, the operation should not run concurrently with others
+// that allocate, which holds for the seed corpus of a fuzz target.
+type Cost struct {
+	Time  time.Duration // CPU time consumed
+	Alloc int64         // Total number of bytes allocated
+	Bytes int64         // Number of bytes processed
+}
+
+func (c Cost) String() string {
+	return fmt.Sprintf("%d bytes processed in %v with %d bytes allocated", c.Bytes, c.Time, c.Alloc)
+}
+
+// MeasureCost runs f and reports the resources it consumed.
+// The function f must return the number of bytes it processed and must not
+// start other goroutines to do its work.
+func MeasureCost(f func() int64) Cost {
+	// Pin the goroutine so that the CPU time of the thread is that of f.
+	runtime.LockOSThread()
+	defer runtime.UnlockOSThread()
+
+	var ms runtime.MemStats
+	runtime.ReadMemStats(&ms)
+	alloc := ms.TotalAlloc
+	start := time.Now()
+	cpu0, ok0 := threadCPUTime()
+
+	n := f()
+
+	elapsed := time.Since(start)
+	if cpu1, ok1 := threadCPUTime(); ok0 && ok1 {
+		elapsed = cpu1 - cpu0
+	}
+	runtime.ReadMemStats(&ms)
+	return Cost{Time: elapsed, Alloc: int64(ms.TotalAlloc - alloc), Bytes: n}
+}
+
+// Check reports an error if the cost exceeds the bound.
+// The time bound is not checked when the race detector is enabled, since it
+// slows down execution by an amount that depends heavily on the code run.
+func (cb CostBound) Check(c Cost) error {
+	if maxTime := cb.TimeFixed + time.Duration(c.Bytes)*cb.TimePerByte; c.Time > maxTime && !raceEnabled {
+		return fmt.Errorf("time bound exceeded: %v > %v (%v)", c.Time, maxTime, c)
+	}
+	if maxAlloc := cb.AllocFixed + c.Bytes*cb.AllocPerByte; c.Alloc > maxAlloc {
+		return fmt.Errorf("allocation bound exceeded: %d > %d (%v)", c.Alloc, maxAlloc, c)
+	}
+	return nil
+}
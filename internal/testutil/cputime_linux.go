@@ -0,0 +1,22 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+// +build linux
+
+package testutil
+
+import (
+	"syscall"
+	"time"
+)
+
+// threadCPUTime reports the user and system CPU time consumed by the current
+// OS thread. The caller must hold runtime.LockOSThread.
+func threadCPUTime() (time.Duration, bool) {
+	var ru syscall.Rusage
+	if err := syscall.Getrusage(syscall.RUSAGE_THREAD, &ru); err != nil {
+		return 0, false
+	}
+	return time.Duration(ru.Utime.Nano() + ru.Stime.Nano()), true
+}
@@ -0,0 +1,12 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+// +build !linux
+
+package testutil
+
+import "time"
+
+// threadCPUTime is not supported on this platform.
+func threadCPUTime() (time.Duration, bool) { return 0, false }
@@ -0,0 +1,53 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package testutil
+
+import (
+	"fmt"
+	"io"
+)
+
+// Decompressor is the push-style API implemented by the decompressors.
+type Decompressor interface {
+	Decompress(in, out []byte) (consumed, produced int, err error)
+}
+
+// PushDecompress decompresses input with zd by pushing it in pieces of
+// random size up to maxIn bytes, while providing output buffers of random
+// size up to maxOut bytes. It returns the decompressed output, the total
+// number of input bytes consumed, and the final error from Decompress.
+//
+// It verifies that each call obeys the contract of Decompress: all of the
+// provided input is consumed unless the output buffer is filled or the stream
+// ends, and progress is always made when possible.
+func PushDecompress(zd Decompressor, input []byte, r *Rand, maxIn, maxOut int) (output []byte, consumed int, err error) {
+	var in []byte
+	var n int
+	for {
+		if len(in) == 0 && n < len(input) {
+			m := 1 + r.Intn(maxIn)
+			if m > len(input)-n {
+				m = len(input) - n
+			}
+			in, n = input[n:n+m], n+m
+		}
+		out := make([]byte, 1+r.Intn(maxOut))
+		nc, np, err := zd.Decompress(in, out)
+		in, consumed = in[nc:], consumed+nc
+		output = append(output, out[:np]...)
+		if err == io.EOF && len(in) == 0 && n < len(input) {
+			continue // EOF is not persistent for concatenated bzip2 streams
+		}
+		if err != nil {
+			return output, consumed, err
+		}
+		if len(in) > 0 && np < len(out) {
+			return output, consumed, fmt.Errorf("input left unconsumed without filling output")
+		}
+		if len(in) == 0 && n == len(input) && np < len(out) {
+			return output, consumed, nil // Input exhausted
+		}
+	}
+}
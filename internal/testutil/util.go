@@ -12,6 +12,8 @@ import (
 	"io"
 	"io/ioutil"
 	"strings"
+
+	"github.com/dsnet/compress"
 )
 
 // ResizeData resizes the input. If n < 0, then the original input will be
@@ -178,3 +180,52 @@ func (bw *BuggyWriter) Write(buf []byte) (int, error) {
 	}
 	return n, err
 }
+
+// ReadAllBuffered reads r until io.EOF using a pseudo-random mix of Read,
+// Peek, and Discard calls, where every byte skipped by Discard is first
+// obtained through Peek. It verifies that Peek never advances the reader and
+// that Discard and Buffered are consistent with Peek.
+func ReadAllBuffered(r compress.BufferedReader, seed int) ([]byte, error) {
+	rand := NewRand(seed)
+	sizes := []int{0, 1, 7, 8, 64, 4096, 100000}
+	var out []byte
+	for {
+		n := sizes[rand.Intn(len(sizes))]
+		switch rand.Intn(3) {
+		case 0:
+			buf := make([]byte, n)
+			cnt, err := r.Read(buf)
+			out = append(out, buf[:cnt]...)
+			if err == io.EOF {
+				return out, nil
+			} else if err != nil {
+				return out, err
+			}
+		case 1, 2:
+			buf, err := r.Peek(n)
+			if err == nil && len(buf) != n {
+				return out, fmt.Errorf("Peek(%d) returned %d bytes without error", n, len(buf))
+			}
+			if err != nil && err != io.EOF {
+				return out, err
+			}
+			if r.Buffered() < len(buf) {
+				return out, fmt.Errorf("Buffered() = %d, want >= %d", r.Buffered(), len(buf))
+			}
+			buf2, _ := r.Peek(len(buf))
+			if !bytes.Equal(buf, buf2) {
+				return out, fmt.Errorf("Peek(%d) not idempotent", len(buf))
+			}
+			out = append(out, buf...)
+			if cnt, err := r.Discard(len(buf)); cnt != len(buf) || err != nil {
+				return out, fmt.Errorf("Discard(%d) = (%d, %v)", len(buf), cnt, err)
+			}
+			if len(buf) < n {
+				if cnt, err := r.Discard(1); cnt != 0 || err != io.EOF {
+					return out, fmt.Errorf("Discard(1) = (%d, %v), want (0, EOF)", cnt, err)
+				}
+				return out, nil
+			}
+		}
+	}
+}
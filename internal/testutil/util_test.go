@@ -4,7 +4,10 @@
 
 package testutil
 
-import "testing"
+import (
+	"testing"
+	"time"
+)
 
 func TestCompare(t *testing.T) {
 	vectors := []struct {
@@ -71,3 +74,25 @@ func TestCompare(t *testing.T) {
 		}
 	}
 }
+
+func TestMeasureCost(t *testing.T) {
+	// Time spent blocked does not count towards the CPU time of the thread.
+	c := MeasureCost(func() int64 {
+		time.Sleep(100 * time.Millisecond)
+		return 1
+	})
+	if _, ok := threadCPUTime(); ok && c.Time >= 50*time.Millisecond {
+		t.Errorf("Time = %v, want less than 50ms", c.Time)
+	}
+
+	c = MeasureCost(func() int64 {
+		b := make([]byte, 1<<20)
+		for start := time.Now(); time.Since(start) < 20*time.Millisecond; {
+			b[0]++
+		}
+		return int64(len(b))
+	})
+	if c.Time <= 0 || c.Alloc < 1<<20 || c.Bytes != 1<<20 {
+		t.Errorf("MeasureCost() = %v, want positive time and at least 1MiB allocated", c)
+	}
+}
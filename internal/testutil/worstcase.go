@@ -0,0 +1,47 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package testutil
+
+// FibonacciWord returns the first n bytes of the infinite Fibonacci word
+// over the alphabet {'a', 'b'}. Fibonacci words are maximally repetitive
+// without being periodic, making them a degenerate input for suffix sorting
+// algorithms (such as SA-IS) and for LZ77 match finders.
+func FibonacciWord(n int) []byte {
+	b := make([]byte, 0, n+1)
+	s0, s1 := []byte("a"), []byte("ab")
+	for len(s1) < n {
+		s0, s1 = s1, append(append([]byte(nil), s1...), s0...)
+	}
+	return append(b, s1[:n]...)
+}
+
+// FibonacciFreqs returns n bytes of data where the frequency of each symbol is
+// proportional to the Fibonacci sequence. Such a distribution produces the
+// deepest possible Huffman trees, which exercises the length-limiting logic
+// of encoders and the slow multi-level lookup paths of decoders.
+//
+// The symbols are shuffled so that they are not trivially compressed by LZ77.
+func FibonacciFreqs(n int) []byte {
+	var freqs []int
+	var sum int
+	for a, b := 1, 1; len(freqs) < 256 && sum+a <= n; a, b = b, a+b {
+		freqs = append(freqs, a)
+		sum += a
+	}
+	b := make([]byte, 0, n)
+	for len(b) < n {
+		for sym, f := range freqs {
+			for i := 0; i < f && len(b) < n; i++ {
+				b = append(b, byte(sym))
+			}
+		}
+	}
+	r := NewRand(0)
+	for i := len(b) - 1; i > 0; i-- {
+		j := r.Intn(i + 1)
+		b[i], b[j] = b[j], b[i]
+	}
+	return b
+}
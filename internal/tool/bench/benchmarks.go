@@ -57,12 +57,7 @@ func BenchmarkEncoderSuite(ft Format, encs []string, files []file, levels, sizes
 	return benchmarkSuite(encs, files, levels, sizes, tick,
 		func(input []byte, enc string, lvl int) Result {
 			result := BenchmarkEncoder(input, encoders[ft][enc], lvl)
-			if result.N == 0 {
-				return Result{}
-			}
-			us := (float64(result.T.Nanoseconds()) / 1e3) / float64(result.N)
-			rate := float64(result.Bytes) / us
-			return Result{R: rate}
+			return rateResult(result)
 		})
 }
 
@@ -99,23 +94,151 @@ func BenchmarkDecoder(input []byte, dec Decoder) testing.BenchmarkResult {
 func BenchmarkDecoderSuite(ft Format, decs []string, files []file, levels, sizes []int, ref Encoder, tick func()) (results [][]Result, names []string) {
 	return benchmarkSuite(decs, files, levels, sizes, tick,
 		func(input []byte, dec string, lvl int) Result {
-			buf := new(bytes.Buffer)
-			wr := ref(buf, lvl)
-			if _, err := io.Copy(wr, bytes.NewReader(input)); err != nil {
+			output, err := compress(input, ref, lvl)
+			if err != nil {
 				return Result{}
 			}
-			if wr.Close() != nil {
-				return Result{}
+			result := BenchmarkDecoder(output, decoders[ft][dec])
+			return rateResult(result)
+		})
+}
+
+// BenchmarkDecoderMatrix runs the benchmarks of BenchmarkDecoderSuite once
+// for every encoder, such that every decoder is measured on the streams
+// produced by every encoder. This shows how the choices made by an encoder
+// (e.g., block sizes, tree shapes, and match distributions) affect the speed
+// of each decoder.
+//
+// The values returned have the following structure:
+//	results: [len(files)*len(levels)*len(sizes)*len(encs)][len(decs)]Result
+//	names:   [len(files)*len(levels)*len(sizes)*len(encs)]string
+//
+// The results for the same input are adjacent, and the name of each row
+// is suffixed by the name of the encoder that produced the stream.
+func BenchmarkDecoderMatrix(ft Format, encs, decs []string, files []file, levels, sizes []int, tick func()) (results [][]Result, names []string) {
+	return interleaveSuites(len(encs),
+		func(k int) ([][]Result, []string) {
+			ref := encoders[ft][encs[k]]
+			return BenchmarkDecoderSuite(ft, decs, files, levels, sizes, ref, tick)
+		},
+		func(k int) string { return encs[k] })
+}
+
+// BenchmarkEncoderIO is like BenchmarkEncoder, but writes the input using
+// Write calls of bufSize bytes.
+func BenchmarkEncoderIO(input []byte, enc Encoder, lvl, bufSize int) testing.BenchmarkResult {
+	return testing.Benchmark(func(b *testing.B) {
+		b.StopTimer()
+		if enc == nil {
+			b.Fatalf("unexpected error: nil Encoder")
+		}
+		runtime.GC()
+		b.StartTimer()
+		for i := 0; i < b.N; i++ {
+			wr := enc(ioutil.Discard, lvl)
+			for buf := input; len(buf) > 0; {
+				n := bufSize
+				if n > len(buf) {
+					n = len(buf)
+				}
+				if _, err := wr.Write(buf[:n]); err != nil {
+					b.Fatalf("unexpected error: %v", err)
+				}
+				buf = buf[n:]
+			}
+			if err := wr.Close(); err != nil {
+				b.Fatalf("unexpected error: %v", err)
 			}
-			output := buf.Bytes()
+			b.SetBytes(int64(len(input)))
+		}
+	})
+}
 
-			result := BenchmarkDecoder(output, decoders[ft][dec])
-			if result.N == 0 {
-				return Result{}
+// BenchmarkEncoderSweep runs the benchmarks of BenchmarkEncoderSuite for
+// every buffer size, where the input is written to each encoder using Write
+// calls of that size.
+//
+// The values returned have the following structure:
+//	results: [len(files)*len(levels)*len(sizes)*len(bufSizes)][len(encs)]Result
+//	names:   [len(files)*len(levels)*len(sizes)*len(bufSizes)]string
+//
+// The name of each row is suffixed by the buffer size.
+func BenchmarkEncoderSweep(ft Format, encs []string, files []file, levels, sizes, bufSizes []int, tick func()) (results [][]Result, names []string) {
+	return interleaveSuites(len(bufSizes),
+		func(k int) ([][]Result, []string) {
+			return benchmarkSuite(encs, files, levels, sizes, tick,
+				func(input []byte, enc string, lvl int) Result {
+					result := BenchmarkEncoderIO(input, encoders[ft][enc], lvl, bufSizes[k])
+					return rateResult(result)
+				})
+		},
+		func(k int) string { return intName(int64(bufSizes[k])) })
+}
+
+// BenchmarkDecoderIO is like BenchmarkDecoder, but provides the input through
+// the named input wrapper and reads the output using Read calls of
+// bufSize bytes.
+func BenchmarkDecoderIO(input []byte, dec Decoder, wrap string, bufSize int) testing.BenchmarkResult {
+	return testing.Benchmark(func(b *testing.B) {
+		b.StopTimer()
+		if dec == nil {
+			b.Fatalf("unexpected error: nil Decoder")
+		}
+		newReader := inputWrappers[wrap]
+		if newReader == nil {
+			b.Fatalf("unexpected error: unknown input wrapper: %s", wrap)
+		}
+		buf := make([]byte, bufSize)
+		runtime.GC()
+		b.StartTimer()
+		for i := 0; i < b.N; i++ {
+			rd := dec(newReader(input))
+			var cnt int64
+			for {
+				n, err := rd.Read(buf)
+				cnt += int64(n)
+				if err == io.EOF {
+					break
+				}
+				if err != nil {
+					b.Fatalf("unexpected error: %v", err)
+				}
 			}
-			us := (float64(result.T.Nanoseconds()) / 1e3) / float64(result.N)
-			rate := float64(result.Bytes) / us
-			return Result{R: rate}
+			if err := rd.Close(); err != nil {
+				b.Fatalf("unexpected error: %v", err)
+			}
+			b.SetBytes(cnt)
+		}
+	})
+}
+
+// BenchmarkDecoderSweep runs the benchmarks of BenchmarkDecoderSuite for
+// every input wrapper and buffer size, where the compressed input is provided
+// to each decoder through that wrapper and the output is read using Read
+// calls of that size.
+//
+// The values returned have the following structure:
+//	results: [len(files)*len(levels)*len(sizes)*len(wraps)*len(bufSizes)][len(decs)]Result
+//	names:   [len(files)*len(levels)*len(sizes)*len(wraps)*len(bufSizes)]string
+//
+// The name of each row is suffixed by the wrapper name and buffer size.
+func BenchmarkDecoderSweep(ft Format, decs []string, files []file, levels, sizes []int, wraps []string, bufSizes []int, ref Encoder, tick func()) (results [][]Result, names []string) {
+	return interleaveSuites(len(wraps)*len(bufSizes),
+		func(k int) ([][]Result, []string) {
+			wrap, bufSize := wraps[k/len(bufSizes)], bufSizes[k%len(bufSizes)]
+			return benchmarkSuite(decs, files, levels, sizes, tick,
+				func(input []byte, dec string, lvl int) Result {
+					output, err := compress(input, ref, lvl)
+					if err != nil {
+						return Result{}
+					}
+					result := BenchmarkDecoderIO(output, decoders[ft][dec], wrap, bufSize)
+					return rateResult(result)
+				})
+		},
+		func(k int) string {
+			wrap, bufSize := wraps[k/len(bufSizes)], bufSizes[k%len(bufSizes)]
+			return wrap + ":" + intName(int64(bufSize))
 		})
 }
 
@@ -128,15 +251,10 @@ func BenchmarkDecoderSuite(ft Format, decs []string, files []file, levels, sizes
 func BenchmarkRatioSuite(ft Format, encs []string, files []file, levels, sizes []int, tick func()) (results [][]Result, names []string) {
 	return benchmarkSuite(encs, files, levels, sizes, tick,
 		func(input []byte, enc string, lvl int) Result {
-			buf := new(bytes.Buffer)
-			wr := encoders[ft][enc](buf, lvl)
-			if _, err := io.Copy(wr, bytes.NewReader(input)); err != nil {
-				return Result{}
-			}
-			if wr.Close() != nil {
+			output, err := compress(input, encoders[ft][enc], lvl)
+			if err != nil {
 				return Result{}
 			}
-			output := buf.Bytes()
 			ratio := float64(len(input)) / float64(len(output))
 			return Result{R: ratio}
 		})
@@ -181,3 +299,46 @@ func benchmarkSuite(codecs []string, files []file, levels, sizes []int, tick fun
 	}
 	return results, names
 }
+
+// interleaveSuites runs n benchmark suites over the same inputs and merges
+// their results such that the rows for the same input are adjacent.
+// The name of each row is suffixed by the name of the suite that produced it.
+func interleaveSuites(n int, suite func(k int) ([][]Result, []string), suffix func(k int) string) ([][]Result, []string) {
+	var results [][]Result
+	var names []string
+	for k := 0; k < n; k++ {
+		rs, ns := suite(k)
+		if results == nil {
+			results = make([][]Result, len(rs)*n)
+			names = make([]string, len(ns)*n)
+		}
+		for i := range rs {
+			results[i*n+k] = rs[i]
+			names[i*n+k] = ns[i] + ":" + suffix(k)
+		}
+	}
+	return results, names
+}
+
+// compress compresses the input with the given encoder and level.
+func compress(input []byte, enc Encoder, lvl int) ([]byte, error) {
+	buf := new(bytes.Buffer)
+	wr := enc(buf, lvl)
+	if _, err := io.Copy(wr, bytes.NewReader(input)); err != nil {
+		return nil, err
+	}
+	if err := wr.Close(); err != nil {
+		return nil, err
+	}
+	return buf.Bytes(), nil
+}
+
+// rateResult converts the benchmark result into a rate in MB/s.
+func rateResult(result testing.BenchmarkResult) Result {
+	if result.N == 0 {
+		return Result{}
+	}
+	us := (float64(result.T.Nanoseconds()) / 1e3) / float64(result.N)
+	rate := float64(result.Bytes) / us
+	return Result{R: rate}
+}
@@ -5,6 +5,8 @@
 package main
 
 import (
+	"bufio"
+	"bytes"
 	"fmt"
 	"go/build"
 	"io"
@@ -33,6 +35,9 @@ const (
 	TestEncodeRate Test = iota
 	TestDecodeRate
 	TestCompressRatio
+	TestDecodeMatrix
+	TestEncodeSweep
+	TestDecodeSweep
 )
 
 var (
@@ -51,17 +56,42 @@ var (
 		FormatZstd:   "zstd",
 	}
 	testToEnum = map[string]Test{
-		"encRate": TestEncodeRate,
-		"decRate": TestDecodeRate,
-		"ratio":   TestCompressRatio,
+		"encRate":   TestEncodeRate,
+		"decRate":   TestDecodeRate,
+		"ratio":     TestCompressRatio,
+		"decMatrix": TestDecodeMatrix,
+		"encSweep":  TestEncodeSweep,
+		"decSweep":  TestDecodeSweep,
 	}
 	enumToTest = map[Test]string{
 		TestEncodeRate:    "encRate",
 		TestDecodeRate:    "decRate",
 		TestCompressRatio: "ratio",
+		TestDecodeMatrix:  "decMatrix",
+		TestEncodeSweep:   "encSweep",
+		TestDecodeSweep:   "decSweep",
 	}
 )
 
+// Section: Input wrappers
+//
+// Decoders may special-case the type of the input io.Reader (e.g., to avoid
+// reading past the end of the stream), so the input wrappers provide the same
+// compressed data through readers with different sets of methods.
+
+// byteReader is an io.Reader that only also implements io.ByteReader.
+type byteReader struct{ r *bytes.Reader }
+
+func (br byteReader) Read(buf []byte) (int, error) { return br.r.Read(buf) }
+func (br byteReader) ReadByte() (byte, error)      { return br.r.ReadByte() }
+
+var inputWrappers = map[string]func([]byte) io.Reader{
+	"bytes":  func(b []byte) io.Reader { return bytes.NewReader(b) },
+	"bufio":  func(b []byte) io.Reader { return bufio.NewReader(bytes.NewReader(b)) },
+	"reader": func(b []byte) io.Reader { return struct{ io.Reader }{bytes.NewReader(b)} },
+	"byte":   func(b []byte) io.Reader { return byteReader{bytes.NewReader(b)} },
+}
+
 // Section: Encoders and Decoders
 //
 // In order for new encoders and decoders (also called codecs) to be added,
@@ -112,6 +142,8 @@ var (
 	globs   varStrings
 	levels  varInts
 	sizes   varInts
+	wraps   varStrings
+	bufs    varInts
 )
 
 // setDefaults configures the top-level parameters with default values.
@@ -125,6 +157,8 @@ func setDefaults() {
 	globs = []string{"*.txt", "*.bin"}
 	levels = []int{1, 6, 9}
 	sizes = []int{1e4, 1e5, 1e6}
+	wraps = []string{"bytes", "bufio", "reader", "byte"}
+	bufs = []int{1, 16, 256, 4 << 10, 64 << 10, 1 << 20}
 }
 
 func defaultFormats() []Format {
@@ -147,10 +181,14 @@ func defaultFormats() []Format {
 	return fs
 }
 
+// defaultTests returns the basic tests. The matrix and sweep tests take many
+// times longer to run and must be explicitly selected.
 func defaultTests() []Test {
 	var d []int
 	for k := range enumToTest {
-		d = append(d, int(k))
+		if k <= TestCompressRatio {
+			d = append(d, int(k))
+		}
 	}
 	sort.Ints(d)
 	var ts []Test
@@ -12,6 +12,7 @@ import (
 	"github.com/dsnet/compress/brotli"
 	"github.com/dsnet/compress/bzip2"
 	"github.com/dsnet/compress/flate"
+	"github.com/dsnet/compress/zstd"
 )
 
 func init() {
@@ -47,4 +48,12 @@ func init() {
 			}
 			return zr
 		})
+	RegisterEncoder(FormatZstd, "ds",
+		func(w io.Writer, lvl int) io.WriteCloser {
+			zw, err := zstd.NewWriter(w, &zstd.WriterConfig{Level: lvl})
+			if err != nil {
+				panic(err)
+			}
+			return zw
+		})
 }
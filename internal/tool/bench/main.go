@@ -5,6 +5,19 @@
 // Benchmark tool to compare performance between multiple compression
 // implementations. Individual implementations are referred to as codecs.
 //
+// The decRate test measures every decoder on streams produced by a single
+// reference encoder, while the decMatrix test measures every decoder on
+// streams produced by every encoder. Each row of the decMatrix results is
+// suffixed by the name of the encoder that produced the stream.
+//
+// The encSweep test writes the input to every encoder using Write calls of
+// each of the sizes in -bufsizes. The decSweep test provides the compressed
+// input to every decoder through each of the readers in -wrappers and reads
+// the output using Read calls of each of the sizes in -bufsizes. The wrappers
+// are a bytes.Reader (bytes), a bufio.Reader (bufio), a plain io.Reader
+// (reader), and an io.Reader that also implements io.ByteReader (byte).
+// The matrix and sweep tests are only run when selected with -tests.
+//
 // Example usage:
 //	$ go build
 //	$ ./bench \
@@ -76,12 +89,14 @@ func main() {
 	flag.Var(&globs, "globs", "List of globs to match for test files")
 	flag.Var(&levels, "levels", "List of compression levels to benchmark")
 	flag.Var(&sizes, "sizes", "List of input sizes to benchmark")
+	flag.Var(&wraps, "wrappers", "List of input wrappers to sweep (bytes, bufio, reader, byte)")
+	flag.Var(&bufs, "bufsizes", "List of Read and Write buffer sizes to sweep")
 	flag.Parse()
 
 	files := getFiles(paths, globs)
 
 	ts := time.Now()
-	runBenchmarks(files, codecs, formats, tests, levels, sizes)
+	runBenchmarks(files, codecs, formats, tests, levels, sizes, wraps, bufs)
 	te := time.Now()
 	fmt.Printf("RUNTIME: %v\n", te.Sub(ts))
 }
@@ -107,7 +122,7 @@ func getFiles(paths []string, globs []string) []file {
 	return fs
 }
 
-func runBenchmarks(files []file, codecs []string, formats []Format, tests []Test, levels, sizes []int) {
+func runBenchmarks(files []file, codecs []string, formats []Format, tests []Test, levels, sizes []int, wraps []string, bufs []int) {
 	for _, f := range formats {
 		// Get lists of encoders and decoders that exist.
 		var encs, decs []string
@@ -134,7 +149,7 @@ func runBenchmarks(files []file, codecs []string, formats []Format, tests []Test
 				fmt.Println("")
 				continue
 			}
-			if len(decs) == 0 && t == TestDecodeRate {
+			if len(decs) == 0 && (t == TestDecodeRate || t == TestDecodeMatrix || t == TestDecodeSweep) {
 				fmt.Println("\tSKIP: There are no decoders available.")
 				fmt.Println("")
 				continue
@@ -142,8 +157,9 @@ func runBenchmarks(files []file, codecs []string, formats []Format, tests []Test
 
 			// Progress ticker.
 			var cnt int
+			runs := 1 // Number of times each codec is run per input
 			tick := func() {
-				total := len(codecs) * len(files) * len(levels) * len(sizes)
+				total := runs * len(codecs) * len(files) * len(levels) * len(sizes)
 				pct := 100.0 * float64(cnt) / float64(total)
 				fmt.Printf("\t[%6.2f%%] %d of %d\r", pct, cnt, total)
 				cnt++
@@ -161,6 +177,16 @@ func runBenchmarks(files []file, codecs []string, formats []Format, tests []Test
 			case TestCompressRatio:
 				codecs, title, suffix = encs, "ratio", "x"
 				results, names = BenchmarkRatioSuite(f, encs, files, levels, sizes, tick)
+			case TestDecodeMatrix:
+				codecs, title, suffix, runs = decs, "MB/s", "", len(encs)
+				results, names = BenchmarkDecoderMatrix(f, encs, decs, files, levels, sizes, tick)
+			case TestEncodeSweep:
+				codecs, title, suffix, runs = encs, "MB/s", "", len(bufs)
+				results, names = BenchmarkEncoderSweep(f, encs, files, levels, sizes, bufs, tick)
+			case TestDecodeSweep:
+				ref := getReferenceEncoder(f)
+				codecs, title, suffix, runs = decs, "MB/s", "", len(wraps)*len(bufs)
+				results, names = BenchmarkDecoderSweep(f, decs, files, levels, sizes, wraps, bufs, ref, tick)
 			default:
 				panic("unknown test")
 			}
@@ -7,6 +7,8 @@ cd "$(dirname "${BASH_SOURCE[0]}")"
 if [ $# == 0 ]; then
 	echo "Usage: $0 PKG"
 	echo
+	echo "Set TAGS to pass additional build tags (e.g., TAGS=compress_unsafe)."
+	echo
 	echo -e "Valid packages:\n\t$(ls -d */ | sed 's/\/*$//g' | tr '\n' ' ')"
 	exit 1
 fi
@@ -29,7 +31,7 @@ PKG_PATH="github.com/dsnet/compress/internal/tool/fuzz"
 shift
 
 echo "Building..."
-go-fuzz-build -o=".work/$PKG-fuzz.zip" $PKG_PATH/$PKG
+go-fuzz-build ${TAGS:+-tags="$TAGS"} -o=".work/$PKG-fuzz.zip" $PKG_PATH/$PKG
 
 echo "Fuzzing..."
 go-fuzz -bin=".work/$PKG-fuzz.zip" -workdir=".work/$PKG" "$@"
@@ -0,0 +1,48 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+// +build !compress_unsafe !386,!amd64,!arm64,!ppc64le
+
+package internal
+
+import "encoding/binary"
+
+// Unsafe indicates whether the compress_unsafe build tag was set on an
+// architecture that permits unaligned little-endian memory accesses.
+//
+// If set, the helpers below use package unsafe to perform wide loads, stores,
+// and copies without bounds checks. The caller is then solely responsible for
+// upholding the documented invariants; violating them corrupts memory instead
+// of panicking. The safe versions are the default.
+const Unsafe = false
+
+// WideCopySlop is the number of bytes past the end of the destination that
+// WideCopy may overwrite. The underlying array of the buffer must have at
+// least this much capacity beyond the end of the copy.
+const WideCopySlop = 0
+
+// LoadUint64LE loads a little-endian uint64 from the start of b.
+//
+// This invariant must be kept: len(b) >= 8
+func LoadUint64LE(b []byte) uint64 {
+	return binary.LittleEndian.Uint64(b)
+}
+
+// StoreUint64LE stores v as a little-endian uint64 at the start of b.
+//
+// This invariant must be kept: len(b) >= 8
+func StoreUint64LE(b []byte, v uint64) {
+	binary.LittleEndian.PutUint64(b, v)
+}
+
+// WideCopy performs the LZ77 copy of b[src:src+n] to b[dst:dst+n], where
+// n is end-dst, such that bytes written early in the copy may be read again
+// later in the copy.
+//
+// This invariant must be kept: 8 <= dst-src && end+WideCopySlop <= cap(b)
+func WideCopy(b []byte, dst, src, end int) {
+	for dst < end {
+		dst += copy(b[dst:end], b[src:dst])
+	}
+}
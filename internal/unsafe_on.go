@@ -0,0 +1,52 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+// +build compress_unsafe
+// +build 386 amd64 arm64 ppc64le
+
+package internal
+
+import "unsafe"
+
+const (
+	Unsafe       = true
+	WideCopySlop = 16
+)
+
+// base returns a pointer to the first element of the underlying array of b
+// without checking that the slice is non-empty.
+func base(b []byte) unsafe.Pointer {
+	return *(*unsafe.Pointer)(unsafe.Pointer(&b))
+}
+
+// word returns a pointer to the 8 bytes at offset i from p.
+func word(p unsafe.Pointer, i int) *uint64 {
+	return (*uint64)(unsafe.Pointer(uintptr(p) + uintptr(i)))
+}
+
+func LoadUint64LE(b []byte) uint64 {
+	return *word(base(b), 0)
+}
+
+func StoreUint64LE(b []byte, v uint64) {
+	*word(base(b), 0) = v
+}
+
+func WideCopy(b []byte, dst, src, end int) {
+	p := base(b)
+	if dst-src >= 16 {
+		// Neither word of the source can overlap with the destination, so
+		// copy 16 bytes at a time and allow the last step to overrun end.
+		for dst < end {
+			*word(p, dst) = *word(p, src)
+			*word(p, dst+8) = *word(p, src+8)
+			dst, src = dst+16, src+16
+		}
+		return
+	}
+	for dst < end {
+		*word(p, dst) = *word(p, src)
+		dst, src = dst+8, src+8
+	}
+}
@@ -0,0 +1,213 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package compress
+
+import (
+	"io"
+	"os"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// AccessPattern is a hint for how the contents of a MappedReader will be
+// accessed. It is forwarded to the operating system (via madvise on Linux)
+// and otherwise has no effect on the semantics of the MappedReader.
+type AccessPattern int
+
+const (
+	// AccessNormal uses the default read-ahead behavior of the OS.
+	AccessNormal AccessPattern = iota
+
+	// AccessSequential hints that the file is read once from start to end,
+	// which is the common case for decompressing an entire file.
+	AccessSequential
+
+	// AccessRandom hints that the file is read at random offsets,
+	// which is the common case for seeking within an XFLATE file.
+	AccessRandom
+)
+
+var errMappedClosed = errors.Error{Code: errors.Closed, Pkg: "compress"}
+
+// MappedReader is a BufferedReader over the contents of a memory-mapped file.
+// Since the entire file is "buffered", Peek may be called with arbitrarily
+// large values and decompressors read their input directly from the OS page
+// cache without first copying it into an intermediate buffer.
+//
+// On platforms where memory-mapping is not supported, the file is read into
+// memory in its entirety instead.
+//
+// The slices returned by Peek alias the mapped memory and become invalid
+// after Close is called.
+//
+// The file must not be truncated while it is mapped. Accessing a page that
+// is no longer backed by the file raises SIGBUS, which the Go runtime treats
+// as a fatal fault (see runtime/debug.SetPanicOnFault) rather than reporting
+// it as an error from Read or Peek.
+type MappedReader struct {
+	data  []byte // Contents of the mapped file
+	pos   int    // Current read offset into data
+	unmap func([]byte) error
+	err   error // Persistent error after Close
+}
+
+var (
+	_ BufferedReader = (*MappedReader)(nil)
+	_ ByteReader     = (*MappedReader)(nil)
+)
+
+// OpenMapped opens the named file and returns a MappedReader over it.
+// The file descriptor is not retained after the mapping is established.
+func OpenMapped(name string, access AccessPattern) (*MappedReader, error) {
+	f, err := os.Open(name)
+	if err != nil {
+		return nil, err
+	}
+	defer f.Close()
+	return NewMappedReader(f, access)
+}
+
+// NewMappedReader maps the contents of f, starting at offset 0, and returns a
+// MappedReader over it. The mapping remains valid even if f is closed.
+func NewMappedReader(f *os.File, access AccessPattern) (*MappedReader, error) {
+	fi, err := f.Stat()
+	if err != nil {
+		return nil, err
+	}
+	size := fi.Size()
+	if size < 0 || int64(int(size)) != size {
+		return nil, errors.Error{Code: errors.Invalid, Pkg: "compress", Msg: "file too large to map"}
+	}
+	if size == 0 {
+		return &MappedReader{}, nil // Mapping an empty file is an error
+	}
+	data, unmap, err := mapFile(f, int(size), access)
+	if err != nil {
+		return nil, err
+	}
+	return &MappedReader{data: data, unmap: unmap}, nil
+}
+
+// Size reports the total size of the mapped file.
+func (mr *MappedReader) Size() int64 { return int64(len(mr.data)) }
+
+// Bytes returns the unread portion of the mapped file.
+func (mr *MappedReader) Bytes() []byte { return mr.data[mr.pos:] }
+
+// Read reads up to len(buf) bytes from the mapped file.
+func (mr *MappedReader) Read(buf []byte) (int, error) {
+	if mr.err != nil {
+		return 0, mr.err
+	}
+	if mr.pos >= len(mr.data) && len(buf) > 0 {
+		return 0, io.EOF
+	}
+	cnt := copy(buf, mr.data[mr.pos:])
+	mr.pos += cnt
+	return cnt, nil
+}
+
+// ReadByte reads the next byte from the mapped file.
+func (mr *MappedReader) ReadByte() (byte, error) {
+	if mr.err != nil {
+		return 0, mr.err
+	}
+	if mr.pos >= len(mr.data) {
+		return 0, io.EOF
+	}
+	c := mr.data[mr.pos]
+	mr.pos++
+	return c, nil
+}
+
+// Buffered returns the number of unread bytes in the mapped file.
+func (mr *MappedReader) Buffered() int { return len(mr.data) - mr.pos }
+
+// Peek returns the next n bytes without advancing the reader.
+// If fewer than n bytes remain, it returns what is left along with io.EOF.
+func (mr *MappedReader) Peek(n int) ([]byte, error) {
+	if mr.err != nil {
+		return nil, mr.err
+	}
+	if n < 0 {
+		return nil, errors.Error{Code: errors.Invalid, Pkg: "compress", Msg: "negative count"}
+	}
+	if n > len(mr.data)-mr.pos {
+		return mr.data[mr.pos:], io.EOF
+	}
+	return mr.data[mr.pos : mr.pos+n], nil
+}
+
+// Discard skips the next n bytes, returning the number of bytes discarded.
+// If fewer than n bytes remain, it discards what is left and returns io.EOF.
+func (mr *MappedReader) Discard(n int) (int, error) {
+	if mr.err != nil {
+		return 0, mr.err
+	}
+	if n < 0 {
+		return 0, errors.Error{Code: errors.Invalid, Pkg: "compress", Msg: "negative count"}
+	}
+	if n > len(mr.data)-mr.pos {
+		n = len(mr.data) - mr.pos
+		mr.pos += n
+		return n, io.EOF
+	}
+	mr.pos += n
+	return n, nil
+}
+
+// Seek implements io.Seeker, allowing the MappedReader to be used as the
+// input to xflate.Reader.
+func (mr *MappedReader) Seek(offset int64, whence int) (int64, error) {
+	if mr.err != nil {
+		return 0, mr.err
+	}
+	switch whence {
+	case io.SeekStart:
+	case io.SeekCurrent:
+		offset += int64(mr.pos)
+	case io.SeekEnd:
+		offset += int64(len(mr.data))
+	default:
+		return 0, errors.Error{Code: errors.Invalid, Pkg: "compress", Msg: "invalid whence"}
+	}
+	if offset < 0 || offset > int64(len(mr.data)) {
+		return 0, errors.Error{Code: errors.Invalid, Pkg: "compress", Msg: "invalid offset"}
+	}
+	mr.pos = int(offset)
+	return offset, nil
+}
+
+// ReadAt implements io.ReaderAt.
+func (mr *MappedReader) ReadAt(buf []byte, off int64) (int, error) {
+	if mr.err != nil {
+		return 0, mr.err
+	}
+	if off < 0 {
+		return 0, errors.Error{Code: errors.Invalid, Pkg: "compress", Msg: "invalid offset"}
+	}
+	if off >= int64(len(mr.data)) {
+		return 0, io.EOF
+	}
+	cnt := copy(buf, mr.data[off:])
+	if cnt < len(buf) {
+		return cnt, io.EOF
+	}
+	return cnt, nil
+}
+
+// Close unmaps the file. All slices previously returned by Peek and Bytes
+// become invalid and must not be accessed.
+func (mr *MappedReader) Close() error {
+	if mr.err != nil {
+		return nil
+	}
+	var err error
+	if mr.unmap != nil {
+		err = mr.unmap(mr.data)
+	}
+	*mr = MappedReader{err: errMappedClosed}
+	return err
+}
@@ -0,0 +1,28 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+// +build linux
+
+package compress
+
+import (
+	"os"
+	"syscall"
+)
+
+func mapFile(f *os.File, size int, access AccessPattern) ([]byte, func([]byte) error, error) {
+	data, err := syscall.Mmap(int(f.Fd()), 0, size, syscall.PROT_READ, syscall.MAP_SHARED)
+	if err != nil {
+		return nil, nil, &os.PathError{Op: "mmap", Path: f.Name(), Err: err}
+	}
+
+	// The advice is only a hint, so failures are ignored.
+	switch access {
+	case AccessSequential:
+		syscall.Madvise(data, syscall.MADV_SEQUENTIAL)
+	case AccessRandom:
+		syscall.Madvise(data, syscall.MADV_RANDOM)
+	}
+	return data, syscall.Munmap, nil
+}
@@ -0,0 +1,62 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package compress
+
+import (
+	"bytes"
+	"io"
+	"io/ioutil"
+	"os"
+	"testing"
+)
+
+func TestMappedReader(t *testing.T) {
+	want := bytes.Repeat([]byte("the quick brown fox jumped over the lazy dog\n"), 1000)
+
+	f, err := ioutil.TempFile("", "mmap")
+	if err != nil {
+		t.Fatalf("unexpected TempFile error: %v", err)
+	}
+	defer os.Remove(f.Name())
+	if _, err := f.Write(want); err != nil {
+		t.Fatalf("unexpected Write error: %v", err)
+	}
+	f.Close()
+
+	for _, access := range []AccessPattern{AccessNormal, AccessSequential, AccessRandom} {
+		mr, err := OpenMapped(f.Name(), access)
+		if err != nil {
+			t.Fatalf("unexpected OpenMapped error: %v", err)
+		}
+		if n := mr.Buffered(); n != len(want) {
+			t.Errorf("Buffered() = %d, want %d", n, len(want))
+		}
+		if buf, err := mr.Peek(len(want)); err != nil || !bytes.Equal(buf, want) {
+			t.Errorf("Peek(%d) = (%d bytes, %v), want (%d bytes, nil)", len(want), len(buf), err, len(want))
+		}
+		if buf, err := mr.Peek(len(want) + 1); err != io.EOF || len(buf) != len(want) {
+			t.Errorf("Peek(%d) = (%d bytes, %v), want (%d bytes, EOF)", len(want)+1, len(buf), err, len(want))
+		}
+		if n, err := mr.Discard(100); n != 100 || err != nil {
+			t.Errorf("Discard(100) = (%d, %v), want (100, nil)", n, err)
+		}
+		if c, err := mr.ReadByte(); c != want[100] || err != nil {
+			t.Errorf("ReadByte() = (%q, %v), want (%q, nil)", c, err, want[100])
+		}
+		got, err := ioutil.ReadAll(mr)
+		if err != nil || !bytes.Equal(got, want[101:]) {
+			t.Errorf("ReadAll() = (%d bytes, %v), want (%d bytes, nil)", len(got), err, len(want)-101)
+		}
+		if n, err := mr.Discard(1); n != 0 || err != io.EOF {
+			t.Errorf("Discard(1) = (%d, %v), want (0, EOF)", n, err)
+		}
+		if err := mr.Close(); err != nil {
+			t.Errorf("unexpected Close error: %v", err)
+		}
+		if _, err := mr.Read(make([]byte, 1)); err == nil {
+			t.Errorf("unexpected Read success after Close")
+		}
+	}
+}
@@ -33,8 +33,15 @@
 // compression ratio. The default chunk size was chosen so that the compression
 // overhead was about 1% for most workloads.
 //
+// The overhead for small chunk sizes can be reduced by providing a shared
+// dictionary in WriterConfig. The dictionary is stored once at the start of the
+// stream and every chunk is compressed using it as the preset dictionary.
+// However, such streams can no longer be decompressed by a regular DEFLATE
+// decoder, but only by xflate.Reader.
+//
 // Format specification:
 //  https://github.com/dsnet/compress/blob/master/doc/xflate-format.pdf
+//  https://github.com/dsnet/compress/blob/master/doc/xflate-dictionary.md
 package xflate
 
 import (
@@ -42,13 +49,29 @@ import (
 	"fmt"
 
 	"github.com/dsnet/compress/internal/errors"
+	"github.com/dsnet/compress/xflate/internal/meta"
 )
 
 // These are the magic values found in the XFLATE footer.
-//
-// Currently, the flag byte is included as part of the magic since
-// all flag bits are currently reserved to be zero.
-var magic = [3]byte{'X', 'F', 0x00}
+var magic = [2]byte{'X', 'F'}
+
+// Flags stored in the byte following the magic in the XFLATE footer.
+// All other flag bits are reserved to be zero (see doc/xflate-dictionary.md).
+const (
+	// flagDict indicates that the stream starts with a shared dictionary.
+	// The meta encoded size of the dictionary follows the back size.
+	flagDict = 1 << 0
+)
+
+// maxDictSize is the maximum size of a shared dictionary, which is limited by
+// the size of the DEFLATE window.
+const maxDictSize = 1 << 15
+
+// maxDictEncSize is the maximum size of a meta encoded dictionary section.
+// The DEFLATE stream for a dictionary is never much larger than the dictionary
+// itself (stored blocks add 5 bytes each), and the meta Writer always packs at
+// least meta.EnsureRawBytes into every block but the last.
+const maxDictEncSize = (maxDictSize + 64 + 4 + meta.EnsureRawBytes - 1) / meta.EnsureRawBytes * meta.MaxEncBytes
 
 // endBlock is a valid DEFLATE raw block. It is empty and has the final bit set.
 // By appending this to any compressed chunk, a normal DEFLATE decompressor can
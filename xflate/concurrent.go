@@ -0,0 +1,177 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package xflate
+
+import (
+	"bytes"
+	"io"
+	"sync"
+)
+
+// A ConcurrentWriter writes a single XFLATE stream on behalf of many
+// goroutines. Each goroutine writes through its own Producer, which compresses
+// whole chunks independently of all other Producers. Only appending a finished
+// chunk to the output and its record to the index is serialized, such that
+// no compression work happens while holding the lock.
+//
+// Chunks are appended in the order that Producers finish them. Thus, data
+// written by a single Producer appears in order, but may be interleaved at
+// chunk boundaries with data from other Producers.
+type ConcurrentWriter struct {
+	mu   sync.Mutex
+	xw   *Writer   // Sequencer that appends finished chunks
+	pool sync.Pool // Pool of *flateWriter for Producers
+}
+
+// NewConcurrentWriter creates a new ConcurrentWriter writing to the given
+// writer. The configuration is interpreted as for NewWriter, where ChunkSize
+// is the uncompressed size of the chunks produced by each Producer.
+// It is the caller's responsibility to call Close to complete the stream.
+func NewConcurrentWriter(wr io.Writer, conf *WriterConfig) (*ConcurrentWriter, error) {
+	xw, err := NewWriter(wr, conf)
+	if err != nil {
+		return nil, err
+	}
+	return &ConcurrentWriter{xw: xw}, nil
+}
+
+// NewProducer creates a new Producer for writing to the stream.
+// A Producer is not safe for concurrent use, such that each goroutine should
+// use its own Producer. It is the caller's responsibility to call Close on
+// the Producer to flush its data.
+//
+// Since each Producer holds a DEFLATE compressor, Producers should be kept for
+// as long as the goroutine writes to the stream. The compressors of closed
+// Producers are reused by new Producers.
+func (cw *ConcurrentWriter) NewProducer() (*Producer, error) {
+	p := &Producer{cw: cw, nchk: cw.xw.nchk}
+	if zw, _ := cw.pool.Get().(*flateWriter); zw != nil {
+		p.zw = zw
+		p.zw.Reset(&p.buf)
+		return p, nil
+	}
+	zw, err := newFlateWriter(&p.buf, cw.xw.lvl, cw.xw.dict)
+	if err != nil {
+		return nil, err
+	}
+	p.zw = zw
+	return p, nil
+}
+
+// Close ends the XFLATE stream and flushes all appended chunks.
+// All Producers must be closed beforehand, otherwise any of their data that
+// is not yet flushed is lost.
+func (cw *ConcurrentWriter) Close() error {
+	cw.mu.Lock()
+	defer cw.mu.Unlock()
+	return cw.xw.Close()
+}
+
+// appendChunk appends a compressed chunk holding rsize uncompressed bytes to
+// the output stream.
+func (cw *ConcurrentWriter) appendChunk(chunk []byte, rsize int64) error {
+	cw.mu.Lock()
+	defer cw.mu.Unlock()
+	xw := cw.xw
+	if xw.err != nil {
+		return xw.err
+	}
+	if err := xw.startChunk(); err != nil {
+		return err
+	}
+	n, err := xw.wr.Write(chunk)
+	xw.OutputOffset += int64(n)
+	if err != nil {
+		xw.err = err
+		return err
+	}
+	return xw.endChunk(int64(n), rsize)
+}
+
+// A Producer is an io.Writer that compresses data into chunks on its own and
+// appends each finished chunk to the stream of a ConcurrentWriter.
+type Producer struct {
+	cw   *ConcurrentWriter
+	zw   *flateWriter
+	buf  bytes.Buffer // Compressed data of the current chunk
+	nchk int64        // Raw size of each chunk
+	err  error        // Persistent error
+}
+
+// Write compresses buf into the current chunk. A chunk is appended to the
+// stream whenever it reaches the configured chunk size, such that buf may be
+// split across several chunks.
+func (p *Producer) Write(buf []byte) (int, error) {
+	var cnt int
+	for len(buf) > 0 && p.err == nil {
+		remain := p.nchk - p.zw.InputOffset
+		if remain <= 0 {
+			p.err = p.Flush()
+			continue
+		}
+		if remain > int64(len(buf)) {
+			remain = int64(len(buf))
+		}
+		var n int
+		n, p.err = p.zw.Write(buf[:remain])
+		buf = buf[n:]
+		cnt += n
+	}
+	return cnt, p.err
+}
+
+// WriteRecord compresses rec into the current chunk, such that rec is never
+// split across multiple chunks. Thus, a record is never interleaved with data
+// from other Producers. If rec does not fit in the remainder of the current
+// chunk, then the current chunk is appended to the stream first. Records larger
+// than the chunk size are written as a single chunk.
+func (p *Producer) WriteRecord(rec []byte) (int, error) {
+	if p.err != nil {
+		return 0, p.err
+	}
+	if p.zw.InputOffset > 0 && p.zw.InputOffset+int64(len(rec)) > p.nchk {
+		if p.err = p.Flush(); p.err != nil {
+			return 0, p.err
+		}
+	}
+	var n int
+	if n, p.err = p.zw.Write(rec); p.err == nil && p.zw.InputOffset >= p.nchk {
+		p.err = p.Flush()
+	}
+	return n, p.err
+}
+
+// Flush appends the current chunk to the stream, if it holds any data.
+func (p *Producer) Flush() error {
+	if p.err != nil {
+		return p.err
+	}
+	if p.zw.InputOffset == 0 {
+		return nil
+	}
+	if p.err = p.zw.Flush(); p.err != nil {
+		return p.err
+	}
+	if p.err = p.cw.appendChunk(p.buf.Bytes(), p.zw.InputOffset); p.err != nil {
+		return p.err
+	}
+	p.buf.Reset()
+	p.zw.Reset(&p.buf)
+	return nil
+}
+
+// Close flushes the current chunk and releases the compressor of the Producer
+// for reuse by other Producers. The Producer cannot be used afterwards.
+func (p *Producer) Close() error {
+	if p.err == errClosed {
+		return nil
+	}
+	if err := p.Flush(); err != nil {
+		return err
+	}
+	p.cw.pool.Put(p.zw)
+	p.zw, p.err = nil, errClosed
+	return nil
+}
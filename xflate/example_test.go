@@ -246,3 +246,76 @@ func Example_gzipFile() {
 	// got:  "ver, white with foam, the driving spray of spume-flakes, the dim\noutlines of the"
 	// want: "ver, white with foam, the driving spray of spume-flakes, the dim\noutlines of the"
 }
+
+// Since the chunks of an XFLATE stream are independent of each other, streams
+// can be concatenated or sliced without decompressing most of the data.
+// In this example, we join two XFLATE files and then extract a range of the
+// result as a new file, where only the chunks at the boundaries of the range
+// are compressed again.
+func ExampleWriter_CopyRange() {
+	// Compress the test data as two separate XFLATE files.
+	twain := testutil.MustLoadFile("../testdata/twain.txt")
+	var files [][]byte
+	for _, data := range [][]byte{twain[:1<<17], twain[1<<17:]} {
+		buffer := new(bytes.Buffer)
+		xw, err := xflate.NewWriter(buffer, &xflate.WriterConfig{ChunkSize: 1 << 14})
+		if err != nil {
+			log.Fatal(err)
+		}
+		if _, err := xw.Write(data); err != nil {
+			log.Fatal(err)
+		}
+		if err := xw.Close(); err != nil {
+			log.Fatal(err)
+		}
+		files = append(files, buffer.Bytes())
+	}
+
+	// Concatenate both files by copying every chunk verbatim.
+	joined := new(bytes.Buffer)
+	xw, err := xflate.NewWriter(joined, nil)
+	if err != nil {
+		log.Fatal(err)
+	}
+	for _, file := range files {
+		xr, err := xflate.NewReader(bytes.NewReader(file), nil)
+		if err != nil {
+			log.Fatal(err)
+		}
+		if _, err := xw.Append(xr); err != nil {
+			log.Fatal(err)
+		}
+	}
+	if err := xw.Close(); err != nil {
+		log.Fatal(err)
+	}
+
+	// Extract a range that crosses the boundary between the original files.
+	sliced := new(bytes.Buffer)
+	xr, err := xflate.NewReader(bytes.NewReader(joined.Bytes()), nil)
+	if err != nil {
+		log.Fatal(err)
+	}
+	xw.Reset(sliced)
+	start, end := int64(1<<17-40), int64(1<<17+40)
+	if _, err := xw.CopyRange(xr, start, end); err != nil {
+		log.Fatal(err)
+	}
+	if err := xw.Close(); err != nil {
+		log.Fatal(err)
+	}
+
+	// Read the new file.
+	xr, err = xflate.NewReader(bytes.NewReader(sliced.Bytes()), nil)
+	if err != nil {
+		log.Fatal(err)
+	}
+	buf, err := ioutil.ReadAll(xr)
+	if err != nil {
+		log.Fatal(err)
+	}
+	fmt.Println(bytes.Equal(buf, twain[start:end]))
+
+	// Output:
+	// true
+}
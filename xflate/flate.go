@@ -31,9 +31,10 @@ type flateReader struct {
 	InputOffset  int64 // Total number of bytes read from underlying io.Reader
 	OutputOffset int64 // Total number of bytes emitted from Read
 
-	zr io.ReadCloser
-	br *bufio.Reader
-	cr countReader
+	zr   io.ReadCloser
+	br   *bufio.Reader
+	cr   countReader
+	dict []byte // Preset dictionary used upon every Reset
 }
 
 func newFlateReader(rd io.Reader) (*flateReader, error) {
@@ -45,10 +46,10 @@ func newFlateReader(rd io.Reader) (*flateReader, error) {
 }
 
 func (fr *flateReader) Reset(rd io.Reader) {
-	*fr = flateReader{zr: fr.zr, br: fr.br}
+	*fr = flateReader{zr: fr.zr, br: fr.br, dict: fr.dict}
 	fr.cr = countReader{R: rd}
 	fr.br.Reset(&fr.cr)
-	fr.zr.(flate.Resetter).Reset(fr.br, nil)
+	fr.zr.(flate.Resetter).Reset(fr.br, fr.dict)
 }
 
 func (fr *flateReader) Read(buf []byte) (int, error) {
@@ -80,7 +81,9 @@ type flateWriter struct {
 	cw countWriter
 }
 
-func newFlateWriter(wr io.Writer, lvl int) (*flateWriter, error) {
+// newFlateWriter creates a flateWriter that uses dict as the preset
+// dictionary upon every Reset.
+func newFlateWriter(wr io.Writer, lvl int, dict []byte) (*flateWriter, error) {
 	var err error
 	fw := new(flateWriter)
 	switch lvl {
@@ -90,7 +93,11 @@ func newFlateWriter(wr io.Writer, lvl int) (*flateWriter, error) {
 		lvl = flate.NoCompression
 	}
 	fw.cw = countWriter{W: wr}
-	fw.zw, err = flate.NewWriter(&fw.cw, lvl)
+	if dict != nil {
+		fw.zw, err = flate.NewWriterDict(&fw.cw, lvl, dict)
+	} else {
+		fw.zw, err = flate.NewWriter(&fw.cw, lvl)
+	}
 	return fw, errWrap(err)
 }
 
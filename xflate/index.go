@@ -4,21 +4,49 @@
 
 package xflate
 
+import (
+	"encoding/binary"
+	"math"
+	"math/bits"
+)
+
 const (
 	unknownType = iota
 	deflateType
 	indexType
 	footerType
+	dictType
 )
 
+// The records of an index are stored in blocks of idxBlockSize records.
+// Each offset is stored as a 32-bit delta from the first offset in its block,
+// so that searching within a block only touches a single cache line.
+const idxBlockSize = 16
+
 type index struct {
-	// Records is a list of records that indicate the location of all chunks
+	// The index is a list of records that indicate the location of all chunks
 	// in the stream. However, rather than recording the starting offset of
 	// each chunk, only the ending offsets are recorded.
 	//
 	// The starting record {0, 0} is not included since it is implied.
 	// The last record effectively holds the total size of the stream.
-	Records []record
+	//
+	// The records are stored as separate columns of compressed offsets,
+	// raw offsets, and types. All columns are stored as little-endian bytes
+	// such that a persisted index can be used in place (see unmarshal).
+	numRecs int
+	comp    offsetColumn
+	raw     offsetColumn
+	types   []byte
+
+	// To reduce cache misses when searching large indexes, the raw offset of
+	// the first record in each block is also stored in Eytzinger order,
+	// where the children of node k are at 2k and 2k+1. The tree is built
+	// lazily by Search and treeBlks holds the block number of each node.
+	tree     []byte // Of int64 values, where tree[0] is unused
+	treeBlks []byte // Of uint32 values, where treeBlks[0] is unused
+
+	aliased bool // Whether the columns alias external memory
 
 	BackSize  int64 // Size of previous index when encoded
 	IndexSize int64 // Size of this index when encoded
@@ -30,9 +58,125 @@ type record struct {
 	Type       int   // Type of the record
 }
 
+// offsetColumn stores a non-decreasing sequence of offsets.
+//
+// Offsets are stored in blocks of idxBlockSize values as a 64-bit base
+// and 32-bit deltas from it. If any delta does not fit in 32 bits, then the
+// column switches to storing every offset as a 64-bit value.
+type offsetColumn struct {
+	isWide bool
+	bases  []byte // Of int64 values, one for each block
+	deltas []byte // Of uint32 values, one for each offset
+	wide   []byte // Of int64 values, one for each offset (only if isWide)
+}
+
+func (c *offsetColumn) Reset(aliased bool) {
+	if aliased {
+		*c = offsetColumn{} // Never write to external memory
+		return
+	}
+	*c = offsetColumn{bases: c.bases[:0], deltas: c.deltas[:0], wide: c.wide[:0]}
+}
+
+// Get returns the ith offset.
+func (c *offsetColumn) Get(i int) int64 {
+	if c.isWide {
+		return int64(binary.LittleEndian.Uint64(c.wide[8*i:]))
+	}
+	return c.base(i/idxBlockSize) + int64(binary.LittleEndian.Uint32(c.deltas[4*i:]))
+}
+
+func (c *offsetColumn) base(blk int) int64 {
+	return int64(binary.LittleEndian.Uint64(c.bases[8*blk:]))
+}
+
+// Append appends v as the ith offset, where i is the current length.
+func (c *offsetColumn) Append(i int, v int64) {
+	var buf [8]byte
+	if !c.isWide {
+		if i%idxBlockSize == 0 {
+			binary.LittleEndian.PutUint64(buf[:], uint64(v))
+			c.bases = append(c.bases, buf[:8]...)
+		}
+		if d := v - c.base(i/idxBlockSize); d <= math.MaxUint32 {
+			binary.LittleEndian.PutUint32(buf[:], uint32(d))
+			c.deltas = append(c.deltas, buf[:4]...)
+			return
+		}
+
+		// Switch to the wide representation.
+		wide := c.wide[:0]
+		for j := 0; j < i; j++ {
+			binary.LittleEndian.PutUint64(buf[:], uint64(c.Get(j)))
+			wide = append(wide, buf[:8]...)
+		}
+		c.isWide, c.wide, c.deltas = true, wide, c.deltas[:0]
+	}
+	binary.LittleEndian.PutUint64(buf[:], uint64(v))
+	c.wide = append(c.wide, buf[:8]...)
+}
+
+// Count reports the number of offsets in the range [lo, hi) that are <= v.
+// The range must be within a single block and offset lo must be <= v.
+func (c *offsetColumn) Count(lo, hi int, v int64) int {
+	var n int
+	if c.isWide {
+		for i := lo; i < hi; i++ {
+			n += b2i(c.Get(i) <= v)
+		}
+		return n
+	}
+	d := v - c.base(lo/idxBlockSize)
+	if d > math.MaxUint32 {
+		return hi - lo
+	}
+	deltas := c.deltas[4*lo : 4*hi]
+	for len(deltas) >= 4 {
+		n += b2i(binary.LittleEndian.Uint32(deltas) <= uint32(d))
+		deltas = deltas[4:]
+	}
+	return n
+}
+
+func b2i(b bool) int {
+	if b {
+		return 1
+	}
+	return 0
+}
+
+// Len reports the number of records.
+func (idx *index) Len() int {
+	return idx.numRecs
+}
+
+// Record returns the ith record.
+func (idx *index) Record(i int) record {
+	return record{
+		CompOffset: idx.comp.Get(i),
+		RawOffset:  idx.raw.Get(i),
+		Type:       int(idx.types[i]),
+	}
+}
+
 // Reset resets the index.
 func (idx *index) Reset() {
-	*idx = index{Records: idx.Records[:0]}
+	// Columns that alias external memory are dropped rather than resliced,
+	// since appending to them would write into that memory.
+	aliased := idx.aliased
+	idx.comp.Reset(aliased)
+	idx.raw.Reset(aliased)
+	if aliased {
+		idx.types, idx.tree, idx.treeBlks = nil, nil, nil
+	}
+	*idx = index{
+		comp: idx.comp,
+		raw:  idx.raw,
+
+		types:    idx.types[:0],
+		tree:     idx.tree[:0],
+		treeBlks: idx.treeBlks[:0],
+	}
 }
 
 // AppendRecord appends a new record to the end of the index and reports whether
@@ -51,7 +195,10 @@ func (idx *index) AppendRecord(compSize, rawSize int64, typ int) bool {
 	if rec.CompOffset < lastRec.CompOffset || rec.RawOffset < lastRec.RawOffset {
 		return false // Overflow detected
 	}
-	idx.Records = append(idx.Records, rec)
+	idx.comp.Append(idx.numRecs, rec.CompOffset)
+	idx.raw.Append(idx.numRecs, rec.RawOffset)
+	idx.types = append(idx.types, uint8(rec.Type))
+	idx.numRecs++
 	return true
 }
 
@@ -59,10 +206,11 @@ func (idx *index) AppendRecord(compSize, rawSize int64, typ int) bool {
 // and reports whether the operation was successful or not.
 func (idx *index) AppendIndex(other *index) bool {
 	var preRec record
-	for i, rec := range other.Records {
+	for i := 0; i < other.Len(); i++ {
+		rec := other.Record(i)
 		csize, rsize := rec.CompOffset-preRec.CompOffset, rec.RawOffset-preRec.RawOffset
 		if !idx.AppendRecord(csize, rsize, rec.Type) {
-			idx.Records = idx.Records[:len(idx.Records)-i] // Ensure atomic append
+			idx.truncate(idx.numRecs - i) // Ensure atomic append
 			return false
 		}
 		preRec = rec
@@ -70,6 +218,22 @@ func (idx *index) AppendIndex(other *index) bool {
 	return true
 }
 
+// truncate discards all records after the first n.
+func (idx *index) truncate(n int) {
+	recs := make([]record, n)
+	for i := range recs {
+		recs[i] = idx.Record(i)
+	}
+	backSize, indexSize := idx.BackSize, idx.IndexSize
+	idx.Reset()
+	idx.BackSize, idx.IndexSize = backSize, indexSize
+	var preRec record
+	for _, rec := range recs {
+		idx.AppendRecord(rec.CompOffset-preRec.CompOffset, rec.RawOffset-preRec.RawOffset, rec.Type)
+		preRec = rec
+	}
+}
+
 // Search searches for the record that best matches the raw offset given.
 // This search will return the location of the record with the lowest
 // RawOffset that is still greater than the given offset.
@@ -92,21 +256,57 @@ func (idx *index) AppendIndex(other *index) bool {
 //	rawSize := curr.RawOffset - prev.RawOffset
 //
 func (idx *index) Search(offset int64) int {
-	recs := idx.Records
-	i, imin, imax := -1, 0, len(recs)-1
-	for imax >= imin && i == -1 {
-		imid := (imin + imax) / 2
-		gteCurr := bool(offset >= recs[imid].RawOffset)
-		ltNext := bool(imid+1 >= len(recs) || offset < recs[imid+1].RawOffset)
-		if gteCurr && ltNext {
-			i = imid
-		} else if gteCurr {
-			imin = imid + 1
-		} else {
-			imax = imid - 1
+	numBlks := (idx.numRecs + idxBlockSize - 1) / idxBlockSize
+	if numBlks == 0 {
+		return 0
+	}
+	if len(idx.tree) != 8*(numBlks+1) {
+		idx.buildTree(numBlks)
+	}
+
+	// Find the number of blocks that start at or before offset.
+	// The descent uses no data-dependent branches and the final position
+	// is recovered from the path taken, as described in "Array Layouts for
+	// Comparison-Based Searching" by Khuong and Morin.
+	k := 1
+	for k <= numBlks {
+		k = 2*k + b2i(int64(binary.LittleEndian.Uint64(idx.tree[8*k:])) <= offset)
+	}
+	k >>= uint(bits.TrailingZeros(uint(^k)) + 1)
+	blk := numBlks
+	if k > 0 {
+		blk = int(binary.LittleEndian.Uint32(idx.treeBlks[4*k:]))
+	}
+	if blk == 0 {
+		return 0 // The offset is before the first record
+	}
+
+	// Count the records within the block that are at or before offset.
+	lo := (blk - 1) * idxBlockSize
+	hi := lo + idxBlockSize
+	if hi > idx.numRecs {
+		hi = idx.numRecs
+	}
+	return lo + idx.raw.Count(lo, hi, offset)
+}
+
+// buildTree builds the Eytzinger layout of the first raw offset in each block.
+func (idx *index) buildTree(numBlks int) {
+	idx.tree = append(idx.tree[:0], make([]byte, 8*(numBlks+1))...)
+	idx.treeBlks = append(idx.treeBlks[:0], make([]byte, 4*(numBlks+1))...)
+	var blk int
+	var build func(k int)
+	build = func(k int) {
+		if k > numBlks {
+			return
 		}
+		build(2 * k)
+		binary.LittleEndian.PutUint64(idx.tree[8*k:], uint64(idx.raw.Get(blk*idxBlockSize)))
+		binary.LittleEndian.PutUint32(idx.treeBlks[4*k:], uint32(blk))
+		blk++
+		build(2*k + 1)
 	}
-	return i + 1
+	build(1)
 }
 
 // GetRecords returns the previous and current records at the given position.
@@ -114,15 +314,14 @@ func (idx *index) Search(offset int64) int {
 // of the index. Thus, this will return zero value records if the position is
 // too low, and the last record if the value is too high.
 func (idx *index) GetRecords(i int) (prev, curr record) {
-	recs := idx.Records
-	if i > len(recs) {
-		i = len(recs)
+	if i > idx.numRecs {
+		i = idx.numRecs
 	}
-	if i-1 >= 0 && i-1 < len(recs) {
-		prev = recs[i-1]
+	if i-1 >= 0 && i-1 < idx.numRecs {
+		prev = idx.Record(i - 1)
 	}
-	if i >= 0 && i < len(recs) {
-		curr = recs[i]
+	if i >= 0 && i < idx.numRecs {
+		curr = idx.Record(i)
 	} else {
 		curr = prev
 		curr.Type = unknownType
@@ -133,8 +332,142 @@ func (idx *index) GetRecords(i int) (prev, curr record) {
 // LastRecord returns the last record if it exists, otherwise the zero value.
 func (idx *index) LastRecord() record {
 	var rec record
-	if len(idx.Records) > 0 {
-		rec = idx.Records[len(idx.Records)-1]
+	if idx.numRecs > 0 {
+		rec = idx.Record(idx.numRecs - 1)
 	}
 	return rec
 }
+
+// The persisted form of an index is the following sequence, where all integers
+// are little-endian and the columns are exactly as they are stored in memory:
+//
+//	magic    [8]byte  // "XFLTIDX\x01"
+//	numRecs  uint64   // Number of records
+//	flags    uint64   // Bit 0: comp is wide, bit 1: raw is wide
+//	comp     column   // Either bases and deltas, or wide
+//	raw      column   // Either bases and deltas, or wide
+//	types    [numRecs]uint8
+//	tree     [numBlks+1]int64
+//	treeBlks [numBlks+1]uint32
+const idxMagic = "XFLTIDX\x01"
+
+// appendBinary appends the persisted form of the index to buf.
+// The index must not be empty.
+func (idx *index) appendBinary(buf []byte) []byte {
+	numBlks := (idx.numRecs + idxBlockSize - 1) / idxBlockSize
+	if len(idx.tree) != 8*(numBlks+1) {
+		idx.buildTree(numBlks)
+	}
+	var hdr [24]byte
+	copy(hdr[:8], idxMagic)
+	binary.LittleEndian.PutUint64(hdr[8:], uint64(idx.numRecs))
+	binary.LittleEndian.PutUint64(hdr[16:], uint64(b2i(idx.comp.isWide)|b2i(idx.raw.isWide)<<1))
+	buf = append(buf, hdr[:]...)
+	for _, c := range []*offsetColumn{&idx.comp, &idx.raw} {
+		if c.isWide {
+			buf = append(buf, c.wide...)
+		} else {
+			buf = append(buf, c.bases...)
+			buf = append(buf, c.deltas...)
+		}
+	}
+	buf = append(buf, idx.types...)
+	buf = append(buf, idx.tree...)
+	buf = append(buf, idx.treeBlks...)
+	return buf
+}
+
+// unmarshal sets the index to the persisted form in buf. The index aliases buf
+// and never modifies it, so buf may be read-only memory (e.g., from mmap).
+// The contents are fully validated without allocating any memory.
+func (idx *index) unmarshal(buf []byte) bool {
+	idx.Reset()
+	if len(buf) < 24 || string(buf[:8]) != idxMagic {
+		return false
+	}
+	n := binary.LittleEndian.Uint64(buf[8:])
+	flags := binary.LittleEndian.Uint64(buf[16:])
+	if n == 0 || n > uint64(len(buf)) || flags > 3 {
+		return false
+	}
+	numRecs := int(n)
+	numBlks := (numRecs + idxBlockSize - 1) / idxBlockSize
+	buf = buf[24:]
+
+	// Slice out each section with its capacity limited to its length,
+	// so that any subsequent append allocates rather than writing to buf.
+	var ok = true
+	next := func(size int) []byte {
+		if len(buf) < size {
+			ok = false
+			return nil
+		}
+		b := buf[:size:size]
+		buf = buf[size:]
+		return b
+	}
+	var comp, raw offsetColumn
+	for i, c := range []*offsetColumn{&comp, &raw} {
+		if c.isWide = flags&(1<<uint(i)) != 0; c.isWide {
+			c.wide = next(8 * numRecs)
+		} else {
+			c.bases = next(8 * numBlks)
+			c.deltas = next(4 * numRecs)
+		}
+	}
+	types := next(numRecs)
+	tree := next(8 * (numBlks + 1))
+	treeBlks := next(4 * (numBlks + 1))
+	if !ok || len(buf) != 0 {
+		return false
+	}
+
+	// Verify that the offsets are non-decreasing and that the tree is
+	// consistent with the raw offsets.
+	var prev record
+	for i := 0; i < numRecs; i++ {
+		rec := record{comp.Get(i), raw.Get(i), int(types[i])}
+		if i%idxBlockSize == 0 && !comp.isWide && !raw.isWide {
+			if comp.Get(i) != comp.base(i/idxBlockSize) || raw.Get(i) != raw.base(i/idxBlockSize) {
+				return false // First delta of each block must be zero
+			}
+		}
+		if rec.CompOffset < prev.CompOffset || rec.RawOffset < prev.RawOffset {
+			return false
+		}
+		if rec.Type < deflateType || rec.Type > dictType {
+			return false
+		}
+		prev = rec
+	}
+	var blk int
+	var check func(k int) bool
+	check = func(k int) bool {
+		if k > numBlks {
+			return true
+		}
+		if !check(2 * k) {
+			return false
+		}
+		if binary.LittleEndian.Uint32(treeBlks[4*k:]) != uint32(blk) ||
+			int64(binary.LittleEndian.Uint64(tree[8*k:])) != raw.Get(blk*idxBlockSize) {
+			return false
+		}
+		blk++
+		return check(2*k + 1)
+	}
+	if !check(1) {
+		return false
+	}
+
+	*idx = index{
+		numRecs:  numRecs,
+		comp:     comp,
+		raw:      raw,
+		types:    types,
+		tree:     tree,
+		treeBlks: treeBlks,
+		aliased:  true,
+	}
+	return true
+}
@@ -6,28 +6,49 @@ package xflate
 
 import (
 	"bytes"
+	"encoding/binary"
 	"math"
+	"math/rand"
 	"reflect"
+	"sort"
 	"testing"
 )
 
+// makeIndex creates an index from a list of records.
+func makeIndex(backSize int64, recs ...record) index {
+	idx := index{BackSize: backSize}
+	var preRec record
+	for _, rec := range recs {
+		if !idx.AppendRecord(rec.CompOffset-preRec.CompOffset, rec.RawOffset-preRec.RawOffset, rec.Type) {
+			panic("invalid record")
+		}
+		preRec = rec
+	}
+	return idx
+}
+
+// records returns all of the records in the index.
+func (idx *index) records() []record {
+	var recs []record
+	for i := 0; i < idx.Len(); i++ {
+		recs = append(recs, idx.Record(i))
+	}
+	return recs
+}
+
+func equalIndexes(x, y *index) bool {
+	return reflect.DeepEqual(x.records(), y.records()) &&
+		x.BackSize == y.BackSize && x.IndexSize == y.IndexSize
+}
+
 func TestIndexRoundTrip(t *testing.T) {
-	vectors := []index{{
-		Records:  nil,
-		BackSize: 0,
-	}, {
-		Records:  []record{{10, 41, 1}, {52, 73, 1}, {84, 95, 1}},
-		BackSize: 1234,
-	}, {
-		Records:  []record{{162, 1024, 1}, {325, 2048, 1}, {524, 3072, 1}},
-		BackSize: 251,
-	}, {
-		Records:  []record{{math.MaxInt64, math.MaxInt64, 1}},
-		BackSize: math.MaxInt64,
-	}, {
-		Records:  []record{{5, 0, 1}, {10, 1, 1}, {15, 2, 1}, {math.MaxInt64, math.MaxInt64, 1}},
-		BackSize: 1337,
-	}}
+	vectors := []index{
+		makeIndex(0),
+		makeIndex(1234, record{10, 41, 1}, record{52, 73, 1}, record{84, 95, 1}),
+		makeIndex(251, record{162, 1024, 1}, record{325, 2048, 1}, record{524, 3072, 1}),
+		makeIndex(math.MaxInt64, record{math.MaxInt64, math.MaxInt64, 1}),
+		makeIndex(1337, record{5, 0, 1}, record{10, 1, 1}, record{15, 2, 1}, record{math.MaxInt64, math.MaxInt64, 1}),
+	}
 
 	for i, idx1 := range vectors {
 		var idx2 index
@@ -48,8 +69,8 @@ func TestIndexRoundTrip(t *testing.T) {
 			t.Errorf("test %d, unexpected error: decodeIndex() = %v", i, err)
 		}
 
-		if !reflect.DeepEqual(idx1, idx2) {
-			t.Errorf("test %d, mismatching indexes:\ngot  %v\nwant %v", i, idx2, idx1)
+		if !equalIndexes(&idx1, &idx2) {
+			t.Errorf("test %d, mismatching indexes:\ngot  %v\nwant %v", i, idx2.records(), idx1.records())
 		}
 	}
 }
@@ -88,13 +109,13 @@ func TestIndex(t *testing.T) {
 		idx index
 		ok  bool
 	}{
-		{index{Records: []record{}}, true},
-		{index{Records: []record{{1, 4, 1}, {3, 9, 2}, {13, 153, 3}}}, true},
-		{index{Records: []record{{1, 4, 4}, {3, 9, 5}, {13, 8, 6}}}, false},
+		{makeIndex(0), true},
+		{makeIndex(0, record{1, 4, 1}, record{3, 9, 2}, record{13, 153, 3}), true},
+		{makeIndex(0, record{1, 4, 4}, record{3, 9, 5}, record{math.MaxInt64, 10, 6}), false},
 	}
 	for _, v := range idxs {
 		if ok := idx.AppendIndex(&v.idx); ok != v.ok {
-			t.Errorf("unexpected result: AppendIndex(%v) = %v, want %v", v.idx, ok, v.ok)
+			t.Errorf("unexpected result: AppendIndex(%v) = %v, want %v", v.idx.records(), ok, v.ok)
 		}
 	}
 	if want := (record{53, 233, 3}); idx.LastRecord() != want {
@@ -102,11 +123,12 @@ func TestIndex(t *testing.T) {
 	}
 
 	// Final check.
-	want := index{Records: []record{
-		{0, 0, 0}, {3, 5, 0}, {34, 67, 0}, {40, 80, 0}, {41, 84, 1}, {43, 89, 2}, {53, 233, 3},
-	}}
-	if !reflect.DeepEqual(idx, want) {
-		t.Errorf("mismatching index:\ngot  %v\nwant %v", idx, want)
+	want := makeIndex(0,
+		record{0, 0, 0}, record{3, 5, 0}, record{34, 67, 0}, record{40, 80, 0},
+		record{41, 84, 1}, record{43, 89, 2}, record{53, 233, 3},
+	)
+	if !equalIndexes(&idx, &want) {
+		t.Errorf("mismatching index:\ngot  %v\nwant %v", idx.records(), want.records())
 	}
 }
 
@@ -125,7 +147,7 @@ func TestIndexSearch(t *testing.T) {
 			{5, record{}, record{}},
 		},
 	}, {
-		idx: index{Records: []record{{2, 14, 0}}},
+		idx: makeIndex(0, record{2, 14, 0}),
 		qs: []query{
 			{0, record{0, 0, 0}, record{2, 14, 0}},
 			{5, record{0, 0, 0}, record{2, 14, 0}},
@@ -134,7 +156,7 @@ func TestIndexSearch(t *testing.T) {
 			{15, record{2, 14, 0}, record{2, 14, 0}},
 		},
 	}, {
-		idx: index{Records: []record{{2, 14, 0}, {3, 17, 0}}},
+		idx: makeIndex(0, record{2, 14, 0}, record{3, 17, 0}),
 		qs: []query{
 			{0, record{0, 0, 0}, record{2, 14, 0}},
 			{5, record{0, 0, 0}, record{2, 14, 0}},
@@ -146,7 +168,7 @@ func TestIndexSearch(t *testing.T) {
 			{18, record{3, 17, 0}, record{3, 17, 0}},
 		},
 	}, {
-		idx: index{Records: []record{{2, 14, 0}, {2, 14, 0}}},
+		idx: makeIndex(0, record{2, 14, 0}, record{2, 14, 0}),
 		qs: []query{
 			{0, record{0, 0, 0}, record{2, 14, 0}},
 			{13, record{0, 0, 0}, record{2, 14, 0}},
@@ -154,11 +176,12 @@ func TestIndexSearch(t *testing.T) {
 			{15, record{2, 14, 0}, record{2, 14, 0}},
 		},
 	}, {
-		idx: index{Records: []record{
-			{17, 5, 0}, {30, 8, 0}, {41, 9, 0}, {53, 11, 0}, {66, 12, 0}, {80, 12, 0},
-			{95, 16, 0}, {111, 16, 0}, {128, 16, 0}, {146, 16, 0}, {165, 16, 0},
-			{185, 16, 0}, {206, 19, 0}, {228, 21, 0}, {251, 22, 0}, {275, 22, 0},
-		}},
+		idx: makeIndex(0,
+			record{17, 5, 0}, record{30, 8, 0}, record{41, 9, 0}, record{53, 11, 0},
+			record{66, 12, 0}, record{80, 12, 0}, record{95, 16, 0}, record{111, 16, 0},
+			record{128, 16, 0}, record{146, 16, 0}, record{165, 16, 0}, record{185, 16, 0},
+			record{206, 19, 0}, record{228, 21, 0}, record{251, 22, 0}, record{275, 22, 0},
+		),
 		qs: []query{
 			{0, record{0, 0, 0}, record{17, 5, 0}},
 			{9, record{41, 9, 0}, record{53, 11, 0}},
@@ -182,3 +205,96 @@ func TestIndexSearch(t *testing.T) {
 		}
 	}
 }
+
+func TestIndexLarge(t *testing.T) {
+	rand := rand.New(rand.NewSource(0))
+	for _, maxSize := range []int64{1 << 10, 1 << 34} {
+		// Generate records with a mix of empty and non-empty chunks.
+		var idx index
+		var recs []record
+		for i := 0; i < 10000; i++ {
+			var csize, rsize int64
+			if rand.Intn(4) > 0 {
+				csize, rsize = rand.Int63n(maxSize), rand.Int63n(maxSize)
+			}
+			typ := deflateType + rand.Intn(3)
+			if !idx.AppendRecord(csize, rsize, typ) {
+				t.Fatalf("unexpected AppendRecord failure")
+			}
+			recs = append(recs, idx.LastRecord())
+		}
+		if wide := maxSize > math.MaxUint32; idx.raw.isWide != wide || idx.comp.isWide != wide {
+			t.Errorf("wide columns = (%v, %v), want %v", idx.comp.isWide, idx.raw.isWide, wide)
+		}
+		if !reflect.DeepEqual(idx.records(), recs) {
+			t.Fatalf("mismatching records")
+		}
+
+		// The persisted form must produce the same index.
+		buf := idx.appendBinary(nil)
+		var idx2 index
+		if !idx2.unmarshal(buf) {
+			t.Fatalf("unexpected unmarshal failure")
+		}
+		if !equalIndexes(&idx, &idx2) {
+			t.Fatalf("mismatching index after unmarshal")
+		}
+		for _, n := range []int{0, 23, len(buf) / 2, len(buf) - 1} {
+			if new(index).unmarshal(buf[:n]) {
+				t.Errorf("unmarshal(buf[:%d]) succeeded, want failure", n)
+			}
+		}
+		// Appending to a reset index must not write to the persisted form.
+		orig := append([]byte(nil), buf...)
+		idx3 := idx2
+		idx3.Reset()
+		for _, rec := range recs[:100] {
+			idx3.AppendRecord(rec.CompOffset, rec.RawOffset, rec.Type)
+		}
+		idx3.Search(0) // Build the search tree
+		if !bytes.Equal(buf, orig) {
+			t.Errorf("persisted index modified by Reset and AppendRecord")
+		}
+
+		bad := append([]byte(nil), buf...)
+		binary.LittleEndian.PutUint64(bad[24:], math.MaxInt64) // First base
+		if new(index).unmarshal(bad) {
+			t.Errorf("unmarshal(corrupted) succeeded, want failure")
+		}
+
+		// Compare Search against a simple binary search.
+		last := recs[len(recs)-1].RawOffset
+		for i := 0; i < 10000; i++ {
+			offset := rand.Int63n(last + 2)
+			if i%2 == 0 {
+				offset = recs[rand.Intn(len(recs))].RawOffset - int64(rand.Intn(2))
+			}
+			want := sort.Search(len(recs), func(i int) bool { return recs[i].RawOffset > offset })
+			if got := idx.Search(offset); got != want {
+				t.Fatalf("Search(%d) = %d, want %d", offset, got, want)
+			}
+			if got := idx2.Search(offset); got != want {
+				t.Fatalf("Search(%d) on persisted index = %d, want %d", offset, got, want)
+			}
+		}
+	}
+}
+
+func BenchmarkIndexSearch(b *testing.B) {
+	rand := rand.New(rand.NewSource(0))
+	var idx index
+	for i := 0; i < 1<<20; i++ {
+		idx.AppendRecord(int64(rand.Intn(1<<16)), int64(rand.Intn(1<<20)), deflateType)
+	}
+	last := idx.LastRecord().RawOffset
+	offsets := make([]int64, 1<<12)
+	for i := range offsets {
+		offsets[i] = rand.Int63n(last)
+	}
+	idx.Search(0) // Build the search tree
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		idx.Search(offsets[i%len(offsets)])
+	}
+}
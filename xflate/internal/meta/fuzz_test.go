@@ -0,0 +1,68 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+// +build go1.18
+
+package meta
+
+import (
+	"bytes"
+	"io/ioutil"
+	"testing"
+	"time"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+// fuzzCost is the maximum cost that processing a single input may incur.
+var fuzzCost = testutil.CostBound{
+	TimeFixed:    50 * time.Millisecond,
+	TimePerByte:  2 * time.Microsecond,
+	AllocFixed:   1 << 20,
+	AllocPerByte: 16,
+}
+
+// FuzzReader checks that the Reader does not panic, that the cost of
+// decoding any input is bounded, and that the input (or the metadata decoded
+// from it) losslessly round-trips through the Writer.
+func FuzzReader(f *testing.F) {
+	for _, s := range []string{"", "a", "hello, world!", "\x00\x00\x00\xff\xff\xff"} {
+		var buf bytes.Buffer
+		mw := NewWriter(&buf)
+		mw.Write([]byte(s))
+		mw.Close()
+		f.Add(buf.Bytes())
+	}
+
+	f.Fuzz(func(t *testing.T, data []byte) {
+		var mdata []byte
+		var merr error
+		c := testutil.MeasureCost(func() int64 {
+			mdata, merr = ioutil.ReadAll(NewReader(bytes.NewReader(data)))
+			return int64(len(data) + len(mdata))
+		})
+		if err := fuzzCost.Check(c); err != nil {
+			t.Error(err)
+		}
+		if merr != nil {
+			mdata = data
+		}
+
+		var buf bytes.Buffer
+		mw := NewWriter(&buf)
+		if n, err := mw.Write(mdata); n != len(mdata) || err != nil {
+			t.Fatalf("Write() = (%d, %v), want (%d, nil)", n, err, len(mdata))
+		}
+		if err := mw.Close(); err != nil {
+			t.Fatalf("Close() = %v, want nil", err)
+		}
+		got, err := ioutil.ReadAll(NewReader(&buf))
+		if err != nil {
+			t.Fatalf("unexpected ReadAll error: %v", err)
+		}
+		if !bytes.Equal(got, mdata) {
+			t.Fatalf("mismatching bytes")
+		}
+	})
+}
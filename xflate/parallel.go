@@ -0,0 +1,157 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package xflate
+
+import (
+	"io"
+	"runtime"
+	"sync"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// chunkWorker decompresses individual chunks on behalf of WriteToAt.
+// Each worker only holds a DEFLATE decompressor and a fixed size copy buffer,
+// such that the memory used is independent of the chunk size.
+type chunkWorker struct {
+	cr  chunkReader
+	zr  *flateReader
+	ow  offsetWriter
+	buf []byte
+}
+
+// offsetWriter is an io.Writer that writes sequentially to an io.WriterAt.
+type offsetWriter struct {
+	wa  io.WriterAt
+	off int64
+}
+
+func (ow *offsetWriter) Write(buf []byte) (int, error) {
+	n, err := ow.wa.WriteAt(buf, ow.off)
+	ow.off += int64(n)
+	return n, err
+}
+
+// decodeChunk decompresses the chunk chk read from rd and writes the output
+// to wr. The chunk is verified in the same way that Reader.Read does.
+func (cw *chunkWorker) decodeChunk(rd io.Reader, wr io.Writer, chk chunk) error {
+	cw.cr.Reset(rd, chk.csize)
+	cw.zr.Reset(&cw.cr)
+
+	// Avoid io.CopyBuffer since it may prefer io.ReaderFrom on the destination,
+	// which would not respect the limit on the chunk size.
+	for {
+		n, err := cw.zr.Read(cw.buf)
+		if cw.zr.OutputOffset > chk.rsize {
+			return errCorrupted
+		}
+		if _, werr := wr.Write(cw.buf[:n]); werr != nil {
+			return werr
+		}
+		if err == io.EOF {
+			break
+		}
+		if err != nil {
+			return err
+		}
+	}
+
+	if chk.typ == deflateType && cw.cr.sync != 0x0000ffff {
+		return errCorrupted
+	}
+	chk.csize += int64(len(endBlock)) // Side effect of using chunkReader
+	if chk.csize != cw.zr.InputOffset || chk.rsize != cw.zr.OutputOffset {
+		return errCorrupted
+	}
+	return nil
+}
+
+// WriteToAt decompresses the entire stream and writes the output to wa,
+// where each chunk is written at its uncompressed offset. Chunks are
+// decompressed concurrently using up to conc goroutines. If conc is zero,
+// then runtime.GOMAXPROCS(0) is used.
+//
+// The underlying io.ReadSeeker must also implement io.ReaderAt (such as
+// os.File or bytes.Reader). Since only ReadAt is used, the current offset of
+// the Reader is unaffected. Each chunk is verified for consistency with the
+// index. If an error occurs, then some arbitrary subset of the chunks may
+// have been written to wa.
+//
+// It returns the total number of uncompressed bytes in the stream.
+func (xr *Reader) WriteToAt(wa io.WriterAt, conc int) (int64, error) {
+	if xr.err != nil && xr.err != io.EOF {
+		return 0, xr.err
+	}
+	ra, ok := xr.rd.(io.ReaderAt)
+	if !ok {
+		return 0, errorf(errors.Invalid, "underlying reader is not an io.ReaderAt")
+	}
+	if conc == 0 {
+		conc = runtime.GOMAXPROCS(0)
+	}
+	if conc < 0 {
+		return 0, errorf(errors.Invalid, "invalid concurrency: %d", conc)
+	}
+
+	var (
+		mu       sync.Mutex
+		wg       sync.WaitGroup
+		firstErr error
+	)
+	recCh := make(chan int)
+	done := make(chan struct{})
+	setErr := func(err error) {
+		mu.Lock()
+		defer mu.Unlock()
+		if firstErr == nil {
+			firstErr = err
+			close(done)
+		}
+	}
+
+	for i := 0; i < conc; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			cw := chunkWorker{buf: make([]byte, 32<<10)}
+			cw.zr, _ = newFlateReader(nil)
+			cw.zr.dict = xr.dict
+			for ri := range recCh {
+				prev, curr := xr.idx.GetRecords(ri)
+				chk := chunk{
+					csize: curr.CompOffset - prev.CompOffset,
+					rsize: curr.RawOffset - prev.RawOffset,
+					typ:   curr.Type,
+				}
+				cw.ow = offsetWriter{wa: wa, off: prev.RawOffset}
+				rd := io.NewSectionReader(ra, prev.CompOffset, chk.csize)
+				if err := cw.decodeChunk(rd, &cw.ow, chk); err != nil {
+					setErr(err)
+				}
+			}
+		}()
+	}
+
+	// Only chunks of compressed data need to be processed since the indexes
+	// and footer were already verified by Reset.
+loop:
+	for ri := 0; ri < xr.idx.Len(); ri++ {
+		if xr.idx.Record(ri).Type != deflateType {
+			continue
+		}
+		select {
+		case recCh <- ri:
+		case <-done:
+			break loop
+		}
+	}
+	close(recCh)
+	wg.Wait()
+
+	if firstErr != nil {
+		return 0, firstErr
+	}
+	return xr.idx.LastRecord().RawOffset, nil
+}
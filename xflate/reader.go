@@ -6,6 +6,7 @@ package xflate
 
 import (
 	"bytes"
+	"compress/flate"
 	"encoding/binary"
 	"hash/crc32"
 	"io"
@@ -80,12 +81,14 @@ type Reader struct {
 	cr chunkReader  // Wraps rd before being passed into zr
 	zr *flateReader // DEFLATE decompressor
 
-	ri      int   // Current record number
-	offset  int64 // Current raw offset
-	discard int64 // Number of bytes to discard to reach offset
-	idx     index // Index table of seekable offsets
-	chk     chunk // Information about the current chunk
-	err     error // Persistent error
+	ri      int    // Current record number
+	offset  int64  // Current raw offset
+	discard int64  // Number of bytes to discard to reach offset
+	idx     index  // Index table of seekable offsets
+	idxData []byte // Persisted index from ReaderConfig
+	dict    []byte // Shared dictionary for all chunks
+	chk     chunk  // Information about the current chunk
+	err     error  // Persistent error
 
 	// The following fields are embedded here to reduce memory allocations.
 	lr     io.LimitedReader
@@ -95,8 +98,15 @@ type Reader struct {
 }
 
 // ReaderConfig configures the Reader.
-// There are currently no configuration options for Reader.
 type ReaderConfig struct {
+	// Index is a persisted index previously obtained from MarshalIndex for
+	// the same stream. If set, the Reader uses it instead of decoding the
+	// index from the stream, which avoids reading each index fragment.
+	//
+	// The Reader uses Index in place and never modifies it. Thus, it may be
+	// memory-mapped from a file and it must not be modified while in use.
+	Index []byte
+
 	_ struct{} // Blank field to prevent unkeyed struct literals
 }
 
@@ -112,6 +122,9 @@ type ReaderConfig struct {
 // all configuration values as necessary and does not store conf.
 func NewReader(rs io.ReadSeeker, conf *ReaderConfig) (*Reader, error) {
 	xr := new(Reader)
+	if conf != nil {
+		xr.idxData = conf.Index
+	}
 	err := xr.Reset(rs)
 	return xr, err
 }
@@ -128,6 +141,9 @@ func (xr *Reader) Reset(rs io.ReadSeeker) error {
 		zr:  xr.zr,
 		idx: xr.idx,
 
+		idxData: xr.idxData,
+		dict:    xr.dict[:0],
+
 		br:     xr.br,
 		bw:     xr.bw,
 		idxs:   xr.idxs,
@@ -136,20 +152,53 @@ func (xr *Reader) Reset(rs io.ReadSeeker) error {
 	if xr.zr == nil {
 		xr.zr, _ = newFlateReader(nil)
 	}
+	xr.zr.dict = nil
 	xr.idx.Reset()
 
+	// Use the persisted index if available.
+	if xr.idxData != nil {
+		var size int64
+		if size, xr.err = rs.Seek(0, io.SeekEnd); xr.err != nil {
+			return xr.err
+		}
+		if !xr.idx.unmarshal(xr.idxData) || xr.idx.LastRecord().CompOffset != size {
+			xr.err = errorf(errors.Corrupted, "persisted index does not match stream")
+			return xr.err
+		}
+		if xr.idx.Len() > 0 && xr.idx.Record(0).Type == dictType {
+			if xr.idx.Record(0).CompOffset > maxDictEncSize {
+				xr.err = errorf(errors.Corrupted, "persisted index does not match stream")
+				return xr.err
+			}
+			if xr.err = xr.decodeDict(xr.idx.Record(0).CompOffset); xr.err != nil {
+				return xr.err
+			}
+		}
+		_, xr.err = xr.Seek(0, io.SeekStart)
+		return xr.err
+	}
+
 	// Read entire index.
-	var backSize, footSize int64
-	if backSize, footSize, xr.err = xr.decodeFooter(); xr.err != nil {
+	var backSize, footSize, dictSize int64
+	if backSize, footSize, dictSize, xr.err = xr.decodeFooter(); xr.err != nil {
 		return xr.err
 	}
-	if xr.err = xr.decodeIndexes(backSize); xr.err != nil {
+	if dictSize > 0 && !xr.idx.AppendRecord(dictSize, 0, dictType) {
+		xr.err = errCorrupted
+		return xr.err
+	}
+	if xr.err = xr.decodeIndexes(backSize, dictSize); xr.err != nil {
 		return xr.err
 	}
 	if !xr.idx.AppendRecord(footSize, 0, footerType) {
 		xr.err = errCorrupted
 		return xr.err
 	}
+	if dictSize > 0 {
+		if xr.err = xr.decodeDict(dictSize); xr.err != nil {
+			return xr.err
+		}
+	}
 
 	// Setup initial chunk reader.
 	_, xr.err = xr.Seek(0, io.SeekStart)
@@ -257,8 +306,8 @@ func (xr *Reader) Seek(offset int64, whence int) (int64, error) {
 		prev, curr = xr.idx.GetRecords(xr.ri)
 	}
 	xr.ri++
-	if xr.ri > len(xr.idx.Records) {
-		xr.ri = len(xr.idx.Records)
+	if xr.ri > xr.idx.Len() {
+		xr.ri = xr.idx.Len()
 	}
 
 	// Setup a chunk reader at the given position.
@@ -278,6 +327,19 @@ func (xr *Reader) Seek(offset int64, whence int) (int64, error) {
 	return pos, xr.err
 }
 
+// MarshalIndex returns the index of the entire stream in a persistent form.
+// It may be passed as ReaderConfig.Index when reading the same stream again.
+//
+// The persisted index stores offsets as 32-bit deltas where possible and is
+// laid out for efficient searching, such that it can be memory-mapped and
+// used without decoding it into memory first.
+func (xr *Reader) MarshalIndex() ([]byte, error) {
+	if xr.err != nil && xr.err != io.EOF {
+		return nil, xr.err
+	}
+	return xr.idx.appendBinary(nil), nil
+}
+
 // Close ends the XFLATE stream.
 func (xr *Reader) Close() error {
 	if xr.err == errClosed {
@@ -292,8 +354,9 @@ func (xr *Reader) Close() error {
 
 // decodeIndexes iteratively decodes all of the indexes in the XFLATE stream.
 // Even if the index is fragmented in the source stream, this method will merge
-// all of the index fragments into a single index table.
-func (xr *Reader) decodeIndexes(backSize int64) error {
+// all of the index fragments into a single index table. The first chunk must
+// start at offset start, which follows the shared dictionary (if any).
+func (xr *Reader) decodeIndexes(backSize, start int64) error {
 	pos, err := xr.rd.Seek(0, io.SeekCurrent)
 	if err != nil {
 		return err
@@ -329,7 +392,7 @@ func (xr *Reader) decodeIndexes(backSize int64) error {
 		}
 		backSize, compSize = idx.BackSize, idx.LastRecord().CompOffset
 	}
-	if pos != 0 {
+	if pos != start {
 		return errCorrupted
 	}
 
@@ -348,7 +411,7 @@ func (xr *Reader) decodeIndexes(backSize int64) error {
 
 // decodeIndex decodes the index from a meta encoded stream.
 // The current offset must be set to the start of the encoded index and
-// index.IndexSize must be populated. If successful, the index.Records and
+// index.IndexSize must be populated. If successful, the index records and
 // index.BackSize fields will be populated. This method will attempt to reset
 // the read offset to the start of the index.
 func (xr *Reader) decodeIndex(idx *index) error {
@@ -425,59 +488,119 @@ func (xr *Reader) decodeIndex(idx *index) error {
 
 // decodeFooter seeks to the end of the stream, searches for the footer
 // and decodes it. If successful, it will return the backSize for the preceding
-// index and the size of the footer itself. This method will attempt to reset
-// the read offset to the start of the footer.
-func (xr *Reader) decodeFooter() (backSize, footSize int64, err error) {
+// index, the size of the footer itself, and the size of the shared dictionary
+// (or zero if there is none). This method will attempt to reset the read
+// offset to the start of the footer.
+func (xr *Reader) decodeFooter() (backSize, footSize, dictSize int64, err error) {
 	// Read the last few bytes of the stream.
 	end, err := xr.rd.Seek(0, io.SeekEnd)
 	if err != nil {
-		return 0, 0, err
+		return 0, 0, 0, err
 	}
 	if end > meta.MaxEncBytes {
 		end = meta.MaxEncBytes
 	}
 	if _, err := xr.rd.Seek(-end, io.SeekEnd); err != nil {
-		return 0, 0, err
+		return 0, 0, 0, err
 	}
 
 	xr.br.Reset()
 	if _, err := io.Copy(&xr.br, xr.rd); err != nil {
-		return 0, 0, err
+		return 0, 0, 0, err
 	}
 
 	// Search for and read the meta block.
 	idx := meta.ReverseSearch(xr.br.Bytes())
 	if idx < 0 {
-		return 0, 0, errCorrupted
+		return 0, 0, 0, errCorrupted
 	}
 	xr.br.Next(idx) // Skip data until magic marker
 
 	xr.bw.Reset()
 	xr.mr.Reset(&xr.br)
 	if _, err := io.Copy(&xr.bw, &xr.mr); err != nil {
-		return 0, 0, errWrap(err)
+		return 0, 0, 0, errWrap(err)
 	}
 	if xr.br.Len() != 0 || xr.mr.NumBlocks != 1 {
-		return 0, 0, errCorrupted
+		return 0, 0, 0, errCorrupted
 	}
 	if xr.mr.FinalMode != meta.FinalStream {
-		return 0, 0, errCorrupted
+		return 0, 0, 0, errCorrupted
 	}
 	if _, err := xr.rd.Seek(-xr.mr.InputOffset, io.SeekCurrent); err != nil {
-		return 0, 0, err
+		return 0, 0, 0, err
 	}
 
 	// Parse the footer.
 	bufRaw := xr.bw.Bytes()
-	if len(bufRaw) < 3 || !bytes.Equal(bufRaw[:3], magic[:]) {
-		return 0, 0, errCorrupted // Magic value mismatch
+	if len(bufRaw) < 3 || !bytes.Equal(bufRaw[:2], magic[:]) {
+		return 0, 0, 0, errCorrupted // Magic value mismatch
+	}
+	flags := bufRaw[2]
+	if flags&^flagDict != 0 {
+		return 0, 0, 0, errCorrupted // Reserved flags must be zero
+	}
+	bufRaw = bufRaw[3:]
+	backSizeU64, cnt := binary.Uvarint(bufRaw)
+	if cnt <= 0 || backSizeU64 > math.MaxInt64 {
+		return 0, 0, 0, errCorrupted // Integer overflow for VLI
+	}
+	bufRaw = bufRaw[cnt:]
+	var dictSizeU64 uint64
+	if flags&flagDict != 0 {
+		dictSizeU64, cnt = binary.Uvarint(bufRaw)
+		if cnt <= 0 || dictSizeU64 == 0 || dictSizeU64 > math.MaxInt64 {
+			return 0, 0, 0, errCorrupted // Integer overflow for VLI
+		}
+		if dictSizeU64 > maxDictEncSize {
+			return 0, 0, 0, errCorrupted // Dictionary section is too large
+		}
+		bufRaw = bufRaw[cnt:]
 	}
-	backSizeU64, cnt := binary.Uvarint(bufRaw[3:])
-	if cnt <= 0 {
-		return 0, 0, errCorrupted // Integer overflow for VLI
+	if len(bufRaw) > 0 {
+		return 0, 0, 0, errCorrupted // Trailing unread bytes
 	}
-	if len(bufRaw[3+cnt:]) > 0 {
-		return 0, 0, errCorrupted // Trailing unread bytes
+	return int64(backSizeU64), xr.mr.InputOffset, int64(dictSizeU64), nil
+}
+
+// decodeDict decodes the shared dictionary from the meta encoded section of
+// the given size at the start of the stream. The dictionary is then used as
+// the preset dictionary for every chunk.
+func (xr *Reader) decodeDict(size int64) error {
+	if _, err := xr.rd.Seek(0, io.SeekStart); err != nil {
+		return err
+	}
+	xr.br.Reset()
+	xr.lr = io.LimitedReader{R: xr.rd, N: size}
+	if _, err := io.Copy(&xr.br, &xr.lr); err != nil {
+		return err
+	}
+
+	xr.bw.Reset()
+	xr.mr.Reset(&xr.br)
+	if _, err := io.Copy(&xr.bw, &xr.mr); err != nil {
+		return errWrap(err)
 	}
-	return int64(backSizeU64), xr.mr.InputOffset, nil
+	if xr.mr.FinalMode != meta.FinalMeta || xr.mr.InputOffset != size {
+		return errCorrupted
+	}
+
+	// The dictionary is compressed as a single DEFLATE stream and is followed
+	// by the CRC-32 checksum of the uncompressed dictionary.
+	rd := bytes.NewReader(xr.bw.Bytes())
+	zr := flate.NewReader(rd)
+	xr.br.Reset()
+	if _, err := io.Copy(&xr.br, io.LimitReader(zr, maxDictSize+1)); err != nil {
+		return errWrap(err)
+	}
+	var crc [4]byte
+	if n, _ := rd.Read(crc[:]); n != 4 || rd.Len() != 0 || xr.br.Len() > maxDictSize {
+		return errCorrupted
+	}
+	if crc32.ChecksumIEEE(xr.br.Bytes()) != binary.LittleEndian.Uint32(crc[:]) {
+		return errCorrupted
+	}
+	xr.dict = append(xr.dict[:0], xr.br.Bytes()...)
+	xr.zr.dict = xr.dict
+	return nil
 }
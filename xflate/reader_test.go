@@ -10,6 +10,7 @@ import (
 	"io/ioutil"
 	"math"
 	"math/rand"
+	"sync"
 	"testing"
 
 	"github.com/dsnet/compress/internal/errors"
@@ -46,6 +47,18 @@ func TestReader(t *testing.T) {
 		input: dh("" +
 			"0d008705000048c82a51e8ff37dbf1",
 		),
+	}, {
+		desc: "empty stream with unknown footer flag",
+		input: dh("" +
+			"3d008705000048c82a5188feffb20df0",
+		),
+		errf: "IsCorrupted",
+	}, {
+		desc: "empty stream with dictionary and unknown footer flags",
+		input: dh("" +
+			"35c0860500204956894232b3a5ffef6aef0df8",
+		),
+		errf: "IsCorrupted",
 	}, {
 		desc: "empty stream with empty chunk",
 		input: dh("" +
@@ -506,6 +519,135 @@ func TestReaderSeek(t *testing.T) {
 	}
 }
 
+// writerAt is an in-memory io.WriterAt.
+type writerAt struct {
+	mu  sync.Mutex
+	buf []byte
+}
+
+func (w *writerAt) WriteAt(buf []byte, off int64) (int, error) {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	if n := int(off) + len(buf); n > len(w.buf) {
+		w.buf = append(w.buf, make([]byte, n-len(w.buf))...)
+	}
+	return copy(w.buf[off:], buf), nil
+}
+
+func TestReaderWriteToAt(t *testing.T) {
+	twain := testutil.MustLoadFile("../testdata/twain.txt")
+	input := append(twain, testutil.MustLoadFile("../testdata/random.bin")...)
+
+	// Create the stream with multiple chunks and index fragments.
+	var bb bytes.Buffer
+	xw, err := NewWriter(&bb, &WriterConfig{ChunkSize: 1 << 14, IndexSize: 1 << 4})
+	if err != nil {
+		t.Fatalf("unexpected error: NewWriter() = %v", err)
+	}
+	if _, err := xw.Write(input); err != nil {
+		t.Fatalf("unexpected error: Write() = %v", err)
+	}
+	if err := xw.Close(); err != nil {
+		t.Fatalf("unexpected error: Close() = %v", err)
+	}
+
+	for _, conc := range []int{0, 1, 3} {
+		xr, err := NewReader(bytes.NewReader(bb.Bytes()), nil)
+		if err != nil {
+			t.Fatalf("unexpected error: NewReader() = %v", err)
+		}
+		wa := new(writerAt)
+		n, err := xr.WriteToAt(wa, conc)
+		if err != nil {
+			t.Errorf("concurrency %d, unexpected error: WriteToAt() = %v", conc, err)
+		}
+		if n != int64(len(input)) || !bytes.Equal(wa.buf, input) {
+			t.Errorf("concurrency %d, output mismatch: WriteToAt() = %d, want %d", conc, n, len(input))
+		}
+
+		// The Reader offset must be unaffected.
+		got, err := ioutil.ReadAll(xr)
+		if err != nil || !bytes.Equal(got, input) {
+			t.Errorf("concurrency %d, mismatching ReadAll() = (%d, %v), want (%d, nil)", conc, len(got), err, len(input))
+		}
+	}
+
+	// Test on corrupt chunks.
+	badData := testutil.MustDecodeHex("" +
+		"4a4c4a4e494d4bcfc8cccacec9cdcb2f282c2a2e292d2baf000002000000ffff" +
+		"048086058044b2e98190b285148a844a0b95a4f7db7bef3dfc15c08605002021" +
+		"ab44219ba8ff2f6bef5df8",
+	)
+	xr, err := NewReader(bytes.NewReader(badData), nil)
+	if err != nil {
+		t.Fatalf("unexpected error: NewReader() = %v", err)
+	}
+	if _, err := xr.WriteToAt(new(writerAt), 2); !errors.IsCorrupted(err) {
+		t.Errorf("mismatching error: WriteToAt() = %v, want IsCorrupted(err) == true", err)
+	}
+}
+
+func TestReaderPersistedIndex(t *testing.T) {
+	rand := rand.New(rand.NewSource(0))
+	twain := testutil.MustLoadFile("../testdata/twain.txt")
+
+	var bb bytes.Buffer
+	xw, err := NewWriter(&bb, &WriterConfig{ChunkSize: 1 << 10, IndexSize: 1 << 4})
+	if err != nil {
+		t.Fatalf("unexpected error: NewWriter() = %v", err)
+	}
+	if _, err := xw.Write(twain); err != nil {
+		t.Fatalf("unexpected error: Write() = %v", err)
+	}
+	if err := xw.Close(); err != nil {
+		t.Fatalf("unexpected error: Close() = %v", err)
+	}
+
+	xr, err := NewReader(bytes.NewReader(bb.Bytes()), nil)
+	if err != nil {
+		t.Fatalf("unexpected error: NewReader() = %v", err)
+	}
+	idxData, err := xr.MarshalIndex()
+	if err != nil {
+		t.Fatalf("unexpected error: MarshalIndex() = %v", err)
+	}
+
+	// The persisted index avoids reading any of the index fragments.
+	rs := &countReadSeeker{ReadSeeker: bytes.NewReader(bb.Bytes())}
+	xr2, err := NewReader(rs, &ReaderConfig{Index: idxData})
+	if err != nil {
+		t.Fatalf("unexpected error: NewReader() = %v", err)
+	}
+	if rs.N != 0 {
+		t.Errorf("read %d bytes with persisted index, want 0", rs.N)
+	}
+	if !equalIndexes(&xr.idx, &xr2.idx) {
+		t.Errorf("mismatching indexes:\ngot  %v\nwant %v", xr2.idx.records(), xr.idx.records())
+	}
+	buf := make([]byte, 1<<11)
+	for i := 0; i < 100; i++ {
+		pos := rand.Int63n(int64(len(twain)))
+		if _, err := xr2.Seek(pos, io.SeekStart); err != nil {
+			t.Fatalf("unexpected error: Seek() = %v", err)
+		}
+		n, err := io.ReadFull(xr2, buf[:rand.Intn(len(buf))])
+		if err != nil && err != io.ErrUnexpectedEOF {
+			t.Fatalf("unexpected error: ReadFull() = %v", err)
+		}
+		if !bytes.Equal(buf[:n], twain[pos:pos+int64(n)]) {
+			t.Fatalf("mismatching data at offset %d", pos)
+		}
+	}
+
+	// The persisted index must match the stream.
+	if _, err := NewReader(bytes.NewReader(bb.Bytes()[1:]), &ReaderConfig{Index: idxData}); !errors.IsCorrupted(err) {
+		t.Errorf("mismatching error: NewReader() = %v, want IsCorrupted(err) == true", err)
+	}
+	if _, err := NewReader(bytes.NewReader(bb.Bytes()), &ReaderConfig{Index: idxData[1:]}); !errors.IsCorrupted(err) {
+		t.Errorf("mismatching error: NewReader() = %v, want IsCorrupted(err) == true", err)
+	}
+}
+
 func TestRecursiveReader(t *testing.T) {
 	twain := testutil.MustLoadFile("../testdata/twain.txt")
 
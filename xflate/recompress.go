@@ -0,0 +1,186 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package xflate
+
+import (
+	"bytes"
+	"io"
+	"runtime"
+	"sync"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// RecompressConfig configures Writer.Recompress.
+// The zero value for any field uses the default value for that field type.
+type RecompressConfig struct {
+	// Concurrency is the number of chunks to compress in parallel.
+	// If zero, then runtime.GOMAXPROCS(0) is used.
+	Concurrency int
+
+	// MinSavings is the fraction of the compressed size of a chunk that must
+	// be saved for the recompressed chunk to be used. Otherwise, the original
+	// chunk is kept as is. For example, a value of 0.05 only replaces chunks
+	// that become at least 5% smaller. If zero, any chunk that becomes smaller
+	// is replaced.
+	//
+	// Original chunks can only be kept if the Writer uses the same shared
+	// dictionary as the Reader, otherwise every chunk is replaced.
+	MinSavings float64
+
+	_ struct{} // Blank field to prevent unkeyed struct literals
+}
+
+// recompressJob holds the state for recompressing a single chunk.
+type recompressJob struct {
+	cw   chunkWorker
+	zw   *flateWriter
+	comp []byte       // Original compressed chunk
+	raw  bytes.Buffer // Uncompressed chunk
+	out  bytes.Buffer // Recompressed chunk
+	data []byte       // Chunk to write; either comp or out
+	err  error
+}
+
+// run recompresses the chunk between the prev and curr records of ra.
+// If keep is set, then the original chunk is kept unless the recompressed
+// chunk saves at least the minSavings fraction of its size.
+func (job *recompressJob) run(ra io.ReaderAt, prev, curr record, keep bool, minSavings float64) error {
+	chk := chunk{
+		csize: curr.CompOffset - prev.CompOffset,
+		rsize: curr.RawOffset - prev.RawOffset,
+		typ:   curr.Type,
+	}
+	if int64(cap(job.comp)) < chk.csize {
+		job.comp = make([]byte, chk.csize)
+	}
+	job.comp = job.comp[:chk.csize]
+	if n, err := ra.ReadAt(job.comp, prev.CompOffset); n < len(job.comp) {
+		if err == io.EOF {
+			err = io.ErrUnexpectedEOF
+		}
+		return err
+	}
+
+	job.raw.Reset()
+	if err := job.cw.decodeChunk(bytes.NewReader(job.comp), &job.raw, chk); err != nil {
+		return err
+	}
+	job.out.Reset()
+	job.zw.Reset(&job.out)
+	if _, err := job.zw.Write(job.raw.Bytes()); err != nil {
+		return err
+	}
+	if err := job.zw.Flush(); err != nil {
+		return err
+	}
+
+	job.data = job.out.Bytes()
+	if keep && float64(len(job.data)) > (1-minSavings)*float64(len(job.comp)) {
+		job.data = job.comp
+	}
+	return nil
+}
+
+// Recompress writes the entire uncompressed content of the stream read by xr,
+// where every chunk is decompressed and compressed again using the
+// compression level and shared dictionary of the Writer. Chunks are
+// compressed concurrently, while the output is written sequentially.
+// It returns the number of uncompressed bytes written.
+//
+// Every chunk of xr is written as a single chunk, such that the chunk
+// boundaries and raw offsets of the output are identical to those of xr,
+// except when data was written prior to calling Recompress. The index of the
+// output is determined by the configuration of the Writer.
+//
+// This is intended for recompressing data at a higher level once it is rarely
+// accessed. Since only ReadAt is used, the current offset of the Reader is
+// unaffected and it may continue to be used for reading. The underlying
+// io.ReadSeeker must also implement io.ReaderAt (such as os.File or
+// bytes.Reader). If conf is nil, then default configuration values are used.
+func (xw *Writer) Recompress(xr *Reader, conf *RecompressConfig) (int64, error) {
+	if xw.err != nil {
+		return 0, xw.err
+	}
+	if xr.err != nil && xr.err != io.EOF {
+		return 0, xr.err
+	}
+	ra, ok := xr.rd.(io.ReaderAt)
+	if !ok {
+		return 0, errorf(errors.Invalid, "underlying reader is not an io.ReaderAt")
+	}
+	var conc int
+	var minSavings float64
+	if conf != nil {
+		conc, minSavings = conf.Concurrency, conf.MinSavings
+	}
+	if conc < 0 || !(0 <= minSavings && minSavings <= 1) {
+		return 0, errorf(errors.Invalid, "invalid configuration: %d, %v", conc, minSavings)
+	}
+	if conc == 0 {
+		conc = runtime.GOMAXPROCS(0)
+	}
+	keep := bytes.Equal(xw.dict, xr.dict)
+
+	// Chunks are processed in batches of conc chunks, where every batch is
+	// compressed concurrently and then written out in order.
+	jobs := make([]recompressJob, conc)
+	for i := range jobs {
+		job := &jobs[i]
+		job.cw.buf = make([]byte, 32<<10)
+		job.cw.zr, _ = newFlateReader(nil)
+		job.cw.zr.dict = xr.dict
+		zw, err := newFlateWriter(nil, xw.lvl, xw.dict)
+		if err != nil {
+			return 0, err
+		}
+		job.zw = zw
+	}
+	var cnt int64
+	var recs []int // Record numbers of the current batch
+	for ri := 0; ri <= xr.idx.Len(); ri++ {
+		if ri < xr.idx.Len() && xr.idx.Record(ri).Type == deflateType {
+			recs = append(recs, ri)
+		}
+		if len(recs) < conc && ri < xr.idx.Len() {
+			continue
+		}
+
+		var wg sync.WaitGroup
+		for i, ri := range recs {
+			wg.Add(1)
+			go func(job *recompressJob, ri int) {
+				defer wg.Done()
+				prev, curr := xr.idx.GetRecords(ri)
+				job.err = job.run(ra, prev, curr, keep, minSavings)
+			}(&jobs[i], ri)
+		}
+		wg.Wait()
+
+		for i, ri := range recs {
+			job := &jobs[i]
+			if job.err != nil {
+				return cnt, job.err
+			}
+			if err := xw.startChunk(); err != nil {
+				return cnt, err
+			}
+			n, err := xw.wr.Write(job.data)
+			xw.OutputOffset += int64(n)
+			if err != nil {
+				xw.err = err
+				return cnt, err
+			}
+			prev, curr := xr.idx.GetRecords(ri)
+			rsize := curr.RawOffset - prev.RawOffset
+			if err := xw.endChunk(int64(n), rsize); err != nil {
+				return cnt, err
+			}
+			cnt += rsize
+		}
+		recs = recs[:0]
+	}
+	return cnt, nil
+}
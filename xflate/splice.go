@@ -0,0 +1,165 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package xflate
+
+import (
+	"bytes"
+	"io"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// Append writes the entire uncompressed content of the stream read by xr,
+// as if by CopyRange over the whole stream. Calling Append for several
+// Readers concatenates (or merges) their streams into one, where every chunk
+// is copied without being decompressed.
+func (xw *Writer) Append(xr *Reader) (int64, error) {
+	if xr.err != nil && xr.err != io.EOF {
+		return 0, xr.err
+	}
+	return xw.CopyRange(xr, 0, xr.idx.LastRecord().RawOffset)
+}
+
+// CopyRange writes the uncompressed bytes in the range [start, end) of the
+// stream read by xr, as if by Write. It returns the number of uncompressed
+// bytes written.
+//
+// Chunks that lie entirely within the range are copied verbatim and only the
+// index records of those chunks are added to the Writer. Only the chunks that
+// straddle the boundaries of the range are decompressed and compressed again.
+// Since a verbatim chunk can only be decompressed with the shared dictionary it
+// was compressed with, every chunk is compressed again if the Writer and
+// Reader have different dictionaries.
+//
+// Any data previously written is first flushed as with FlushFull, such that
+// copied chunks start on a chunk boundary. Upon return, the read offset of xr
+// is at the end of the bytes copied.
+func (xw *Writer) CopyRange(xr *Reader, start, end int64) (cnt int64, err error) {
+	if xw.err != nil {
+		return 0, xw.err
+	}
+	if xr.err != nil && xr.err != io.EOF {
+		return 0, xr.err
+	}
+	if start < 0 || end < start || end > xr.idx.LastRecord().RawOffset {
+		return 0, errorf(errors.Invalid, "invalid range: [%d, %d)", start, end)
+	}
+	verbatim := bytes.Equal(xw.dict, xr.dict)
+	defer func() {
+		// Verbatim copies bypass the decompressor, so always seek again.
+		if _, serr := xr.Seek(start+cnt, io.SeekStart); err == nil {
+			err = serr
+		}
+	}()
+
+	var buf []byte
+	for ri := xr.idx.Search(start); ri < xr.idx.Len() && start+cnt < end; ri++ {
+		prev, curr := xr.idx.GetRecords(ri)
+		if curr.Type != deflateType || curr.RawOffset <= start+cnt {
+			continue
+		}
+
+		// Copy the whole chunk if possible.
+		pos := start + cnt
+		if verbatim && prev.RawOffset == pos && curr.RawOffset <= end {
+			if buf == nil {
+				buf = make([]byte, 32<<10)
+			}
+			if err := xw.copyChunk(xr, prev, curr, buf); err != nil {
+				return cnt, err
+			}
+			cnt += curr.RawOffset - prev.RawOffset
+			continue
+		}
+
+		// Otherwise, compress the part of the chunk within the range again.
+		n := curr.RawOffset - pos
+		if n > end-pos {
+			n = end - pos
+		}
+		if _, err := xr.Seek(pos, io.SeekStart); err != nil {
+			return cnt, err
+		}
+		m, err := io.CopyN(xw, xr, n)
+		cnt += m
+		if err == io.EOF {
+			err = errCorrupted // The index claimed that more data exists
+		}
+		if err != nil {
+			return cnt, err
+		}
+	}
+	return cnt, nil
+}
+
+// copyChunk copies the compressed chunk between the prev and curr records of
+// the Reader into the output stream without decompressing it. The chunk is
+// verified to end with a sync marker, but is otherwise trusted to match
+// the sizes recorded in the index.
+func (xw *Writer) copyChunk(xr *Reader, prev, curr record, buf []byte) error {
+	if err := xw.startChunk(); err != nil {
+		return err
+	}
+
+	csize, rsize := curr.CompOffset-prev.CompOffset, curr.RawOffset-prev.RawOffset
+	if _, err := xr.rd.Seek(prev.CompOffset, io.SeekStart); err != nil {
+		return err
+	}
+	xr.chk = chunk{}
+	xr.lr = io.LimitedReader{R: xr.rd, N: csize}
+	var sync uint32 // Last 4 bytes of the chunk
+	for xr.lr.N > 0 {
+		n, err := xr.lr.Read(buf)
+		i := n - 4
+		if i < 0 {
+			i = 0
+		}
+		for _, b := range buf[i:n] {
+			sync = sync<<8 | uint32(b)
+		}
+		if _, werr := xw.wr.Write(buf[:n]); werr != nil {
+			xw.err = werr
+			return xw.err
+		}
+		xw.OutputOffset += int64(n)
+		if err == io.EOF && xr.lr.N > 0 {
+			err = io.ErrUnexpectedEOF
+		}
+		if err != nil && err != io.EOF {
+			xw.err = err // The output stream now has a partial chunk
+			return xw.err
+		}
+	}
+	if sync != 0x0000ffff {
+		xw.err = errCorrupted
+		return xw.err
+	}
+	return xw.endChunk(csize, rsize)
+}
+
+// startChunk prepares for a compressed chunk to be written directly to the
+// underlying io.Writer by ending the chunk currently in progress (if any).
+func (xw *Writer) startChunk() error {
+	if !xw.wrDict {
+		if xw.err = xw.encodeDict(); xw.err != nil {
+			return xw.err
+		}
+	}
+	if xw.zw.InputOffset+xw.zw.OutputOffset > 0 {
+		return xw.Flush(FlushFull)
+	}
+	return nil
+}
+
+// endChunk records a chunk that was written directly to the underlying
+// io.Writer, where csize bytes were already added to xw.OutputOffset.
+func (xw *Writer) endChunk(csize, rsize int64) error {
+	xw.InputOffset += rsize
+	xw.idx.AppendRecord(csize, rsize, deflateType)
+	if int64(xw.idx.Len()) == xw.nidx {
+		xw.err = xw.Flush(FlushIndex)
+	}
+	return xw.err
+}
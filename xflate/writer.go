@@ -5,6 +5,8 @@
 package xflate
 
 import (
+	"bytes"
+	"compress/flate"
 	"encoding/binary"
 	"hash/crc32"
 	"io"
@@ -26,10 +28,15 @@ type Writer struct {
 	mw meta.Writer  // Meta encoder used to write the index and footer
 	zw *flateWriter // DEFLATE compressor
 
-	idx  index // Index table of seekable offsets
-	nidx int64 // Number of records per index
-	nchk int64 // Raw size of each independent chunk
-	err  error // Persistent error
+	lvl      int    // Compression level
+	idx      index  // Index table of seekable offsets
+	nidx     int64  // Number of records per index
+	nchk     int64  // Raw size of each independent chunk
+	dict     []byte // Shared dictionary for all chunks
+	dictEnc  []byte // Compressed dictionary followed by its checksum
+	dictSize int64  // Encoded size of the shared dictionary
+	wrDict   bool   // Has the shared dictionary been written?
+	err      error  // Persistent error
 
 	// The following fields are embedded here to reduce memory allocations.
 	scratch [64]byte
@@ -67,6 +74,17 @@ type WriterConfig struct {
 	// approximation for how much uncompressed data each index represents.
 	IndexSize int64
 
+	// Dictionary is a shared dictionary that every chunk is compressed with.
+	//
+	// The dictionary is stored once at the start of the stream and the Reader
+	// loads it when opening the stream. This recovers much of the compression
+	// ratio that is otherwise lost with small ChunkSizes. Only the last 32 KiB
+	// of the dictionary are used, since that is the size of the DEFLATE window.
+	//
+	// A stream written with a dictionary can only be decompressed by Reader
+	// and not by a regular DEFLATE decompressor.
+	Dictionary []byte
+
 	_ struct{} // Blank field to prevent unkeyed struct literals
 }
 
@@ -78,6 +96,7 @@ type WriterConfig struct {
 func NewWriter(wr io.Writer, conf *WriterConfig) (*Writer, error) {
 	var lvl int
 	var nchk, nidx int64
+	var dict []byte
 	if conf != nil {
 		lvl = conf.Level
 		switch {
@@ -92,13 +111,25 @@ func NewWriter(wr io.Writer, conf *WriterConfig) (*Writer, error) {
 		case conf.IndexSize > 0:
 			nidx = conf.IndexSize
 		}
+		if n := len(conf.Dictionary); n > 0 {
+			if n > maxDictSize {
+				n = maxDictSize
+			}
+			dict = append([]byte(nil), conf.Dictionary[len(conf.Dictionary)-n:]...)
+		}
 	}
 
-	zw, err := newFlateWriter(wr, lvl)
+	zw, err := newFlateWriter(wr, lvl, dict)
 	if err != nil {
 		return nil, err
 	}
-	xw := &Writer{wr: wr, zw: zw, nchk: nchk, nidx: nidx}
+	var dictEnc []byte
+	if dict != nil {
+		if dictEnc, err = compressDict(dict); err != nil {
+			return nil, err
+		}
+	}
+	xw := &Writer{wr: wr, zw: zw, lvl: lvl, nchk: nchk, nidx: nidx, dict: dict, dictEnc: dictEnc}
 	xw.Reset(wr)
 	return xw, nil
 }
@@ -110,15 +141,18 @@ func NewWriter(wr io.Writer, conf *WriterConfig) (*Writer, error) {
 // This is used to reduce memory allocations.
 func (xw *Writer) Reset(wr io.Writer) error {
 	*xw = Writer{
-		wr:   wr,
-		mw:   xw.mw,
-		zw:   xw.zw,
-		nchk: xw.nchk,
-		nidx: xw.nidx,
-		idx:  xw.idx,
+		wr:      wr,
+		mw:      xw.mw,
+		zw:      xw.zw,
+		lvl:     xw.lvl,
+		nchk:    xw.nchk,
+		nidx:    xw.nidx,
+		dict:    xw.dict,
+		dictEnc: xw.dictEnc,
+		idx:     xw.idx,
 	}
 	if xw.zw == nil {
-		xw.zw, _ = newFlateWriter(wr, DefaultCompression)
+		xw.zw, _ = newFlateWriter(wr, DefaultCompression, xw.dict)
 	} else {
 		xw.zw.Reset(wr)
 	}
@@ -139,6 +173,11 @@ func (xw *Writer) Write(buf []byte) (int, error) {
 	if xw.err != nil {
 		return 0, xw.err
 	}
+	if !xw.wrDict {
+		if xw.err = xw.encodeDict(); xw.err != nil {
+			return 0, xw.err
+		}
+	}
 
 	var n, cnt int
 	for len(buf) > 0 && xw.err == nil {
@@ -170,6 +209,11 @@ func (xw *Writer) Flush(mode FlushMode) error {
 	if xw.err != nil {
 		return xw.err
 	}
+	if !xw.wrDict {
+		if xw.err = xw.encodeDict(); xw.err != nil {
+			return xw.err
+		}
+	}
 
 	switch mode {
 	case FlushSync:
@@ -183,7 +227,7 @@ func (xw *Writer) Flush(mode FlushMode) error {
 		}
 		xw.idx.AppendRecord(xw.zw.OutputOffset, xw.zw.InputOffset, deflateType)
 		xw.zw.Reset(xw.wr)
-		if int64(len(xw.idx.Records)) == xw.nidx {
+		if int64(xw.idx.Len()) == xw.nidx {
 			xw.err = xw.Flush(FlushIndex)
 		}
 		return xw.err
@@ -213,9 +257,14 @@ func (xw *Writer) Close() error {
 	if xw.err != nil {
 		return xw.err
 	}
+	if !xw.wrDict {
+		if xw.err = xw.encodeDict(); xw.err != nil {
+			return xw.err
+		}
+	}
 
 	// Flush final index.
-	if xw.zw.OutputOffset+xw.zw.InputOffset > 0 || len(xw.idx.Records) > 0 {
+	if xw.zw.OutputOffset+xw.zw.InputOffset > 0 || xw.idx.Len() > 0 {
 		xw.err = xw.Flush(FlushIndex)
 		if xw.err != nil {
 			return xw.err
@@ -223,7 +272,7 @@ func (xw *Writer) Close() error {
 	}
 
 	// Encode the footer.
-	err := xw.encodeFooter(xw.idx.BackSize)
+	err := xw.encodeFooter(xw.idx.BackSize, xw.dictSize)
 	if err != nil {
 		xw.err = err
 	} else {
@@ -233,7 +282,7 @@ func (xw *Writer) Close() error {
 }
 
 // encodeIndex encodes the index into a meta encoded stream.
-// The index.Records and index.BackSize fields must be populated.
+// The index records and index.BackSize field must be populated.
 // The index.IndexSize field will be populated upon successful write.
 func (xw *Writer) encodeIndex(index *index) error {
 	// Helper function to write VLIs.
@@ -252,11 +301,12 @@ func (xw *Writer) encodeIndex(index *index) error {
 	defer func() { xw.OutputOffset += xw.mw.OutputOffset }()
 	xw.mw.FinalMode = meta.FinalMeta
 	writeVLI(index.BackSize)
-	writeVLI(int64(len(index.Records)))
+	writeVLI(int64(index.Len()))
 	writeVLI(index.LastRecord().CompOffset)
 	writeVLI(index.LastRecord().RawOffset)
 	var preRec record
-	for _, rec := range index.Records {
+	for i := 0; i < index.Len(); i++ {
+		rec := index.Record(i)
 		writeVLI(rec.CompOffset - preRec.CompOffset)
 		writeVLI(rec.RawOffset - preRec.RawOffset)
 		preRec = rec
@@ -276,11 +326,64 @@ func (xw *Writer) encodeIndex(index *index) error {
 	return nil
 }
 
-// encodeFooter writes the final footer, encoding the provided backSize into it.
-func (xw *Writer) encodeFooter(backSize int64) error {
+// compressDict compresses the shared dictionary as a single DEFLATE stream
+// and appends the CRC-32 checksum of the uncompressed dictionary.
+// Meta encoding roughly doubles the size of data, so it is worth compressing
+// the dictionary first.
+func compressDict(dict []byte) ([]byte, error) {
+	var bb bytes.Buffer
+	zw, err := flate.NewWriter(&bb, flate.BestCompression)
+	if err != nil {
+		return nil, errWrap(err)
+	}
+	if _, err := zw.Write(dict); err != nil {
+		return nil, errWrap(err)
+	}
+	if err := zw.Close(); err != nil {
+		return nil, errWrap(err)
+	}
+	var crc [4]byte
+	binary.LittleEndian.PutUint32(crc[:], crc32.ChecksumIEEE(dict))
+	return append(bb.Bytes(), crc[:]...), nil
+}
+
+// encodeDict writes the shared dictionary (if any) into a meta encoded
+// section, which must be at the start of the stream. The size of the encoded
+// section will be stored in xw.dictSize upon successful write.
+func (xw *Writer) encodeDict() error {
+	xw.wrDict = true
+	if xw.dict == nil {
+		return nil
+	}
+
+	xw.mw.Reset(xw.wr)
+	defer func() { xw.OutputOffset += xw.mw.OutputOffset }()
+	xw.mw.FinalMode = meta.FinalMeta
+	if _, err := xw.mw.Write(xw.dictEnc); err != nil {
+		return errWrap(err)
+	}
+	if err := xw.mw.Close(); err != nil {
+		return errWrap(err)
+	}
+	xw.dictSize = xw.mw.OutputOffset
+	return nil
+}
+
+// encodeFooter writes the final footer, encoding the provided backSize and
+// the size of the shared dictionary (if non-zero) into it.
+func (xw *Writer) encodeFooter(backSize, dictSize int64) error {
 	var n int
 	n += copy(xw.scratch[n:], magic[:])
+	if dictSize > 0 {
+		xw.scratch[n] = flagDict
+	} else {
+		xw.scratch[n] = 0
+	}
+	n++
 	n += binary.PutUvarint(xw.scratch[n:], uint64(backSize))
+	if dictSize > 0 {
+		n += binary.PutUvarint(xw.scratch[n:], uint64(dictSize))
+	}
 
 	xw.mw.Reset(xw.wr)
 	defer func() { xw.OutputOffset += xw.mw.OutputOffset }()
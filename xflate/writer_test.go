@@ -7,7 +7,13 @@ package xflate
 import (
 	"bytes"
 	"compress/flate"
+	"fmt"
+	"io"
 	"io/ioutil"
+	"math/rand"
+	"reflect"
+	"strings"
+	"sync"
 	"testing"
 
 	"github.com/dsnet/compress/internal/testutil"
@@ -190,6 +196,274 @@ func TestWriterReset(t *testing.T) {
 	}
 }
 
+func TestWriterCopyRange(t *testing.T) {
+	compress := func(input []byte, conf *WriterConfig) (*Reader, []byte) {
+		var bb bytes.Buffer
+		xw, _ := NewWriter(&bb, conf)
+		if _, err := xw.Write(input); err != nil {
+			t.Fatalf("unexpected error: Write() = %v", err)
+		}
+		if err := xw.Close(); err != nil {
+			t.Fatalf("unexpected error: Close() = %v", err)
+		}
+		xr, err := NewReader(bytes.NewReader(bb.Bytes()), nil)
+		if err != nil {
+			t.Fatalf("unexpected error: NewReader() = %v", err)
+		}
+		return xr, bb.Bytes()
+	}
+	decompress := func(output []byte) []byte {
+		xr, err := NewReader(bytes.NewReader(output), nil)
+		if err != nil {
+			t.Fatalf("unexpected error: NewReader() = %v", err)
+		}
+		got, err := ioutil.ReadAll(xr)
+		if err != nil {
+			t.Fatalf("unexpected error: ReadAll() = %v", err)
+		}
+		return got
+	}
+
+	twain, digits := testTwain, testDigits
+	xr1, stream1 := compress(twain, &WriterConfig{ChunkSize: 1 << 12, IndexSize: 1 << 4})
+	xr2, _ := compress(digits, &WriterConfig{ChunkSize: 1 << 13})
+	xr3, _ := compress(twain, &WriterConfig{ChunkSize: 1 << 12, Dictionary: digits})
+
+	// Concatenating streams copies all chunks verbatim.
+	var bb bytes.Buffer
+	xw, _ := NewWriter(&bb, &WriterConfig{IndexSize: 1 << 5})
+	for _, xr := range []*Reader{xr1, xr2, xr3} {
+		if _, err := xw.Append(xr); err != nil {
+			t.Fatalf("unexpected error: Append() = %v", err)
+		}
+	}
+	if err := xw.Close(); err != nil {
+		t.Fatalf("unexpected error: Close() = %v", err)
+	}
+	want := append(append(append([]byte(nil), twain...), digits...), twain...)
+	if got := decompress(bb.Bytes()); !bytes.Equal(got, want) {
+		t.Errorf("mismatching concatenated output")
+	}
+	for ri := 0; ri < xr1.idx.Len(); ri++ {
+		prev, curr := xr1.idx.GetRecords(ri)
+		if curr.Type == deflateType && !bytes.Contains(bb.Bytes(), stream1[prev.CompOffset:curr.CompOffset]) {
+			t.Fatalf("chunk %d was not copied verbatim", ri)
+		}
+	}
+
+	// Slicing only compresses the boundary chunks again.
+	rand := rand.New(rand.NewSource(0))
+	for i := 0; i < 20; i++ {
+		start := rand.Int63n(int64(len(twain)))
+		end := start + rand.Int63n(int64(len(twain))-start+1)
+		bb.Reset()
+		xw.Reset(&bb)
+		xw.Write([]byte("prefix"))
+		if n, err := xw.CopyRange(xr1, start, end); err != nil || n != end-start {
+			t.Fatalf("CopyRange(%d, %d) = (%d, %v), want (%d, nil)", start, end, n, err, end-start)
+		}
+		if pos, _ := xr1.Seek(0, io.SeekCurrent); pos != end {
+			t.Errorf("Reader offset mismatch: got %d, want %d", pos, end)
+		}
+		xw.Write([]byte("suffix"))
+		if err := xw.Close(); err != nil {
+			t.Fatalf("unexpected error: Close() = %v", err)
+		}
+		want := append(append([]byte("prefix"), twain[start:end]...), "suffix"...)
+		if got := decompress(bb.Bytes()); !bytes.Equal(got, want) {
+			t.Errorf("mismatching output for CopyRange(%d, %d)", start, end)
+		}
+	}
+	if _, err := xw.CopyRange(xr1, 10, 5); err == nil {
+		t.Errorf("unexpected success: CopyRange(10, 5)")
+	}
+}
+
+func TestWriterRecompress(t *testing.T) {
+	compress := func(input []byte, conf *WriterConfig) []byte {
+		var bb bytes.Buffer
+		xw, _ := NewWriter(&bb, conf)
+		if _, err := xw.Write(input); err != nil {
+			t.Fatalf("unexpected error: Write() = %v", err)
+		}
+		if err := xw.Close(); err != nil {
+			t.Fatalf("unexpected error: Close() = %v", err)
+		}
+		return bb.Bytes()
+	}
+	recompress := func(input []byte, wconf *WriterConfig, rconf *RecompressConfig) (*Reader, *Reader) {
+		xr1, err := NewReader(bytes.NewReader(input), nil)
+		if err != nil {
+			t.Fatalf("unexpected error: NewReader() = %v", err)
+		}
+		var bb bytes.Buffer
+		xw, _ := NewWriter(&bb, wconf)
+		if n, err := xw.Recompress(xr1, rconf); err != nil || n != xr1.idx.LastRecord().RawOffset {
+			t.Fatalf("Recompress() = (%d, %v), want (%d, nil)", n, err, xr1.idx.LastRecord().RawOffset)
+		}
+		if err := xw.Close(); err != nil {
+			t.Fatalf("unexpected error: Close() = %v", err)
+		}
+		xr2, err := NewReader(bytes.NewReader(bb.Bytes()), nil)
+		if err != nil {
+			t.Fatalf("unexpected error: NewReader() = %v", err)
+		}
+		return xr1, xr2
+	}
+	rawOffsets := func(xr *Reader) (offs []int64) {
+		for ri := 0; ri < xr.idx.Len(); ri++ {
+			if rec := xr.idx.Record(ri); rec.Type == deflateType {
+				offs = append(offs, rec.RawOffset)
+			}
+		}
+		return offs
+	}
+
+	twain, digits := testTwain, testDigits
+	stream := compress(twain, &WriterConfig{Level: BestSpeed, ChunkSize: 1 << 12})
+	dictStream := compress(twain, &WriterConfig{Level: BestSpeed, ChunkSize: 1 << 12, Dictionary: digits})
+	tests := []struct {
+		input []byte
+		wconf *WriterConfig
+		rconf *RecompressConfig
+		same  bool // Whether all chunks are expected to be kept as is
+	}{
+		{stream, &WriterConfig{Level: BestCompression}, nil, false},
+		{stream, &WriterConfig{Level: BestCompression, IndexSize: 1 << 3}, &RecompressConfig{Concurrency: 3}, false},
+		{stream, &WriterConfig{Level: BestCompression}, &RecompressConfig{MinSavings: 1}, true},
+		{stream, &WriterConfig{Level: BestSpeed, Dictionary: digits}, &RecompressConfig{MinSavings: 1}, false},
+		{dictStream, &WriterConfig{Level: BestCompression, Dictionary: digits}, &RecompressConfig{Concurrency: 1}, false},
+		{dictStream, &WriterConfig{Level: BestCompression}, nil, false},
+	}
+
+	for i, v := range tests {
+		xr1, xr2 := recompress(v.input, v.wconf, v.rconf)
+		got, err := ioutil.ReadAll(xr2)
+		if err != nil || !bytes.Equal(got, twain) {
+			t.Errorf("test %d, mismatching output: %v", i, err)
+		}
+		if got, want := rawOffsets(xr2), rawOffsets(xr1); !reflect.DeepEqual(got, want) {
+			t.Errorf("test %d, mismatching chunk boundaries:\ngot  %v\nwant %v", i, got, want)
+		}
+		var csize1, csize2 int64
+		for ri := 0; ri < xr1.idx.Len(); ri++ {
+			prev, curr := xr1.idx.GetRecords(ri)
+			if curr.Type == deflateType {
+				csize1 += curr.CompOffset - prev.CompOffset
+			}
+		}
+		for ri := 0; ri < xr2.idx.Len(); ri++ {
+			prev, curr := xr2.idx.GetRecords(ri)
+			if curr.Type == deflateType {
+				csize2 += curr.CompOffset - prev.CompOffset
+			}
+		}
+		if v.same && csize2 != csize1 {
+			t.Errorf("test %d, chunks were not kept: got %d bytes, want %d bytes", i, csize2, csize1)
+		}
+		if !v.same && v.wconf.Level == BestCompression && csize2 >= csize1 {
+			t.Errorf("test %d, chunks were not recompressed: got %d bytes, want < %d bytes", i, csize2, csize1)
+		}
+	}
+
+	// The underlying reader must support ReadAt.
+	xr, _ := NewReader(struct{ io.ReadSeeker }{bytes.NewReader(stream)}, nil)
+	xw, _ := NewWriter(ioutil.Discard, nil)
+	if _, err := xw.Recompress(xr, nil); err == nil {
+		t.Errorf("unexpected success: Recompress() without io.ReaderAt")
+	}
+}
+
+func TestConcurrentWriter(t *testing.T) {
+	const numProducers, numRecords = 8, 200
+	var bb bytes.Buffer
+	cw, err := NewConcurrentWriter(&bb, &WriterConfig{ChunkSize: 1 << 10, IndexSize: 1 << 4})
+	if err != nil {
+		t.Fatalf("unexpected error: NewConcurrentWriter() = %v", err)
+	}
+
+	// Every producer writes records of varying length, where the last record
+	// of each producer is larger than the chunk size.
+	record := func(i, j int) []byte {
+		n := (i*numRecords + j) % 97
+		if j == numRecords-1 {
+			n = 3000
+		}
+		return []byte(fmt.Sprintf("%d:%d:%s\n", i, j, strings.Repeat("x", n)))
+	}
+	var wg sync.WaitGroup
+	for i := 0; i < numProducers; i++ {
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			p, err := cw.NewProducer()
+			if err != nil {
+				t.Errorf("unexpected error: NewProducer() = %v", err)
+				return
+			}
+			for j := 0; j < numRecords; j++ {
+				if _, err := p.WriteRecord(record(i, j)); err != nil {
+					t.Errorf("unexpected error: WriteRecord() = %v", err)
+					return
+				}
+			}
+			if err := p.Close(); err != nil {
+				t.Errorf("unexpected error: Close() = %v", err)
+			}
+		}(i)
+	}
+	wg.Wait()
+
+	// A Producer that only uses Write may split data across chunks.
+	p, _ := cw.NewProducer()
+	if _, err := p.Write(testTwain); err != nil {
+		t.Fatalf("unexpected error: Write() = %v", err)
+	}
+	if err := p.Close(); err != nil {
+		t.Fatalf("unexpected error: Close() = %v", err)
+	}
+	if _, err := p.Write([]byte("x")); err == nil {
+		t.Errorf("unexpected success: Write() after Close()")
+	}
+	if err := cw.Close(); err != nil {
+		t.Fatalf("unexpected error: Close() = %v", err)
+	}
+
+	xr, err := NewReader(bytes.NewReader(bb.Bytes()), nil)
+	if err != nil {
+		t.Fatalf("unexpected error: NewReader() = %v", err)
+	}
+	got, err := ioutil.ReadAll(xr)
+	if err != nil {
+		t.Fatalf("unexpected error: ReadAll() = %v", err)
+	}
+	if !bytes.HasSuffix(got, testTwain) {
+		t.Fatalf("mismatching output of Write")
+	}
+	got = got[:len(got)-len(testTwain)]
+
+	// Every record must be intact and in order for each producer.
+	next := make([]int, numProducers)
+	for _, line := range strings.SplitAfter(string(got), "\n") {
+		if line == "" {
+			continue
+		}
+		var i, j int
+		if _, err := fmt.Sscanf(line, "%d:%d:", &i, &j); err != nil || i < 0 || i >= numProducers {
+			t.Fatalf("corrupted record: %q", line)
+		}
+		if j != next[i] || line != string(record(i, j)) {
+			t.Fatalf("record mismatch: got %q, want producer %d record %d", line, i, next[i])
+		}
+		next[i]++
+	}
+	for i, n := range next {
+		if n != numRecords {
+			t.Errorf("producer %d, got %d records, want %d", i, n, numRecords)
+		}
+	}
+}
+
 // BenchmarkWriter benchmarks the overhead of the XFLATE format over DEFLATE.
 // Thus, it intentionally uses a very small chunk size with no compression.
 func BenchmarkWriter(b *testing.B) {
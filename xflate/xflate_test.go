@@ -6,10 +6,14 @@ package xflate
 
 import (
 	"bytes"
+	"compress/flate"
 	"io"
+	"io/ioutil"
 	"testing"
 
+	"github.com/dsnet/compress/internal/errors"
 	"github.com/dsnet/compress/internal/testutil"
+	"github.com/dsnet/compress/xflate/internal/meta"
 )
 
 var (
@@ -81,3 +85,115 @@ func TestRoundTrip(t *testing.T) {
 		})
 	}
 }
+
+func TestDictionary(t *testing.T) {
+	compress := func(input []byte, conf *WriterConfig) []byte {
+		var bb bytes.Buffer
+		xw, err := NewWriter(&bb, conf)
+		if err != nil {
+			t.Fatalf("unexpected error: NewWriter() = %v", err)
+		}
+		if _, err := xw.Write(input); err != nil {
+			t.Fatalf("unexpected error: Write() = %v", err)
+		}
+		if err := xw.Close(); err != nil {
+			t.Fatalf("unexpected error: Close() = %v", err)
+		}
+		return bb.Bytes()
+	}
+
+	// Use the start of the input as a dictionary for the remainder.
+	dict, input := testTwain[:maxDictSize], testTwain[maxDictSize:]
+	plain := compress(input, &WriterConfig{ChunkSize: 1 << 10})
+	output := compress(input, &WriterConfig{ChunkSize: 1 << 10, Dictionary: dict})
+	if len(output) >= len(plain) {
+		t.Errorf("dictionary did not improve compression: got %d, want < %d", len(output), len(plain))
+	}
+	empty := compress(nil, &WriterConfig{Dictionary: dict})
+	if xr, err := NewReader(bytes.NewReader(empty), nil); err != nil {
+		t.Errorf("unexpected error: NewReader() = %v", err)
+	} else if got, err := ioutil.ReadAll(xr); err != nil || len(got) != 0 {
+		t.Errorf("mismatching output: ReadAll() = (%d, %v), want (0, nil)", len(got), err)
+	}
+
+	xr, err := NewReader(bytes.NewReader(output), nil)
+	if err != nil {
+		t.Fatalf("unexpected error: NewReader() = %v", err)
+	}
+	if got, err := ioutil.ReadAll(xr); err != nil || !bytes.Equal(got, input) {
+		t.Errorf("mismatching output: ReadAll() = %v", err)
+	}
+	pos := int64(len(input) / 3)
+	if _, err := xr.Seek(pos, io.SeekStart); err != nil {
+		t.Fatalf("unexpected error: Seek() = %v", err)
+	}
+	if got, err := ioutil.ReadAll(xr); err != nil || !bytes.Equal(got, input[pos:]) {
+		t.Errorf("mismatching output after Seek: ReadAll() = %v", err)
+	}
+	wa := new(writerAt)
+	if _, err := xr.WriteToAt(wa, 4); err != nil || !bytes.Equal(wa.buf, input) {
+		t.Errorf("mismatching output: WriteToAt() = %v", err)
+	}
+
+	// The dictionary must be loaded when using a persisted index.
+	idxData, err := xr.MarshalIndex()
+	if err != nil {
+		t.Fatalf("unexpected error: MarshalIndex() = %v", err)
+	}
+	xr2, err := NewReader(bytes.NewReader(output), &ReaderConfig{Index: idxData})
+	if err != nil {
+		t.Fatalf("unexpected error: NewReader() = %v", err)
+	}
+	if got, err := ioutil.ReadAll(xr2); err != nil || !bytes.Equal(got, input) {
+		t.Errorf("mismatching output with persisted index: ReadAll() = %v", err)
+	}
+
+	// A regular DEFLATE decompressor cannot read the stream.
+	got, err := ioutil.ReadAll(flate.NewReader(bytes.NewReader(output)))
+	if err == nil && bytes.Equal(got, input) {
+		t.Errorf("unexpected success decompressing with flate.Reader")
+	}
+
+	// Corrupting the dictionary must be detected.
+	bad := append([]byte(nil), output...)
+	bad[100] ^= 0x10
+	if _, err := NewReader(bytes.NewReader(bad), nil); err == nil {
+		t.Errorf("unexpected success with corrupted dictionary")
+	}
+
+	// An incompressible dictionary must still fit within maxDictEncSize.
+	dict = testRandom[:maxDictSize]
+	output = compress(testTwain[:1<<10], &WriterConfig{Dictionary: dict})
+	if xr, err := NewReader(bytes.NewReader(output), nil); err != nil {
+		t.Errorf("unexpected error with random dictionary: NewReader() = %v", err)
+	} else if n := xr.idx.Record(0).CompOffset; n > maxDictEncSize {
+		t.Errorf("dictionary section too large: got %d, want <= %d", n, maxDictEncSize)
+	}
+
+	// An oversized dictionary section must be rejected before it is read.
+	var bb bytes.Buffer
+	xw, _ := NewWriter(&bb, nil)
+	bb.Reset()
+	if err := xw.encodeFooter(0, maxDictEncSize+1); err != nil {
+		t.Fatalf("unexpected error: encodeFooter() = %v", err)
+	}
+	huge := append(make([]byte, maxDictEncSize+1), bb.Bytes()...)
+	rs := &countReadSeeker{ReadSeeker: bytes.NewReader(huge)}
+	if _, err := NewReader(rs, nil); !errors.IsCorrupted(err) {
+		t.Errorf("mismatching error: NewReader() = %v, want IsCorrupted(err) == true", err)
+	}
+	if rs.N > meta.MaxEncBytes {
+		t.Errorf("read too much of the stream: got %d bytes, want <= %d", rs.N, meta.MaxEncBytes)
+	}
+
+	var idx index
+	idx.AppendRecord(maxDictEncSize+1, 0, dictType)
+	idx.AppendRecord(int64(bb.Len()), 0, footerType)
+	rs = &countReadSeeker{ReadSeeker: bytes.NewReader(huge)}
+	if _, err := NewReader(rs, &ReaderConfig{Index: idx.appendBinary(nil)}); !errors.IsCorrupted(err) {
+		t.Errorf("mismatching error: NewReader() = %v, want IsCorrupted(err) == true", err)
+	}
+	if rs.N > 0 {
+		t.Errorf("read too much of the stream: got %d bytes, want 0", rs.N)
+	}
+}
@@ -0,0 +1,211 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package ziputil
+
+import (
+	"archive/zip"
+	"io"
+	"os"
+	"path/filepath"
+	"runtime"
+	"sort"
+	"strings"
+	"sync"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// Approximate amount of memory used to extract a single entry, which is
+// dominated by the state of the decompressor.
+const (
+	copyBufSize = 32 << 10
+	storeMemory = copyBufSize
+	flateMemory = copyBufSize + 64<<10  // Window, input buffer, and prefix tables
+	bzip2Memory = copyBufSize + 5<<20   // BWT state for a 900KiB block
+	otherMemory = copyBufSize + 256<<10 // Unknown decompressor registered by user
+)
+
+// ExtractConfig configures Extract and ExtractTo.
+// The zero value for any field uses the default value for that field type.
+type ExtractConfig struct {
+	// Concurrency is the maximum number of entries to extract in parallel.
+	// If zero, then runtime.GOMAXPROCS(0) is used.
+	Concurrency int
+
+	// MaxMemory is the approximate limit on the memory used by entries being
+	// extracted in parallel. Fewer entries are extracted at a time if their
+	// decompressors would otherwise exceed the limit, but an entry is always
+	// extracted if nothing else is in progress. If zero, there is no limit.
+	MaxMemory int64
+
+	_ struct{} // Blank field to prevent unkeyed struct literals
+}
+
+// Extract extracts all entries of zr into the directory dir, creating any
+// missing directories. Entries that are neither regular files nor directories
+// and entries with names that escape dir are rejected with an error.
+//
+// Extract calls Register on zr.
+func Extract(zr *zip.Reader, dir string, conf *ExtractConfig) error {
+	for _, f := range zr.File {
+		if !isDir(f) {
+			continue
+		}
+		path, err := joinPath(dir, f.Name)
+		if err != nil {
+			return err
+		}
+		if err := os.MkdirAll(path, 0777); err != nil {
+			return err
+		}
+	}
+	return ExtractTo(zr, func(f *zip.File) (io.WriteCloser, error) {
+		path, err := joinPath(dir, f.Name)
+		if err != nil {
+			return nil, err
+		}
+		if !f.Mode().IsRegular() {
+			return nil, errorf(errors.Invalid, "unsupported file type: %s", f.Name)
+		}
+		if err := os.MkdirAll(filepath.Dir(path), 0777); err != nil {
+			return nil, err
+		}
+		return os.OpenFile(path, os.O_WRONLY|os.O_CREATE|os.O_TRUNC, f.Mode().Perm())
+	}, conf)
+}
+
+// ExtractTo decompresses all entries of zr that are not directories, writing
+// each to the io.WriteCloser returned by create for that entry. The create
+// function is called concurrently and must be safe for concurrent use.
+// Entries are extracted largest first, and the first error encountered stops
+// all further extraction.
+//
+// ExtractTo calls Register on zr.
+func ExtractTo(zr *zip.Reader, create func(*zip.File) (io.WriteCloser, error), conf *ExtractConfig) error {
+	var conc int
+	var maxMem int64
+	if conf != nil {
+		conc, maxMem = conf.Concurrency, conf.MaxMemory
+	}
+	if conc < 0 || maxMem < 0 {
+		return errorf(errors.Invalid, "invalid configuration: %d, %d", conc, maxMem)
+	}
+	if conc == 0 {
+		conc = runtime.GOMAXPROCS(0)
+	}
+	Register(zr)
+
+	// Start with the largest entries, so that a single large entry at the end
+	// of the archive does not leave all other workers idle.
+	var files []*zip.File
+	for _, f := range zr.File {
+		if !isDir(f) {
+			files = append(files, f)
+		}
+	}
+	sort.SliceStable(files, func(i, j int) bool {
+		return files[i].UncompressedSize64 > files[j].UncompressedSize64
+	})
+	if conc > len(files) {
+		conc = len(files)
+	}
+
+	var (
+		mu       sync.Mutex
+		cond     = sync.NewCond(&mu)
+		next     int   // Index of the next entry in files
+		usedMem  int64 // Estimated memory of entries in progress
+		firstErr error
+	)
+	var wg sync.WaitGroup
+	for i := 0; i < conc; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			buf := make([]byte, copyBufSize)
+			for {
+				mu.Lock()
+				if next == len(files) || firstErr != nil {
+					mu.Unlock()
+					return
+				}
+				f := files[next]
+				next++
+				mem := entryMemory(f)
+				for maxMem > 0 && usedMem > 0 && usedMem+mem > maxMem && firstErr == nil {
+					cond.Wait()
+				}
+				usedMem += mem
+				mu.Unlock()
+
+				err := extractFile(f, create, buf)
+
+				mu.Lock()
+				usedMem -= mem
+				if err != nil && firstErr == nil {
+					firstErr = err
+				}
+				cond.Broadcast()
+				mu.Unlock()
+			}
+		}()
+	}
+	wg.Wait()
+	return firstErr
+}
+
+// extractFile decompresses a single entry using buf as the copy buffer.
+func extractFile(f *zip.File, create func(*zip.File) (io.WriteCloser, error), buf []byte) error {
+	rc, err := f.Open()
+	if err != nil {
+		return err
+	}
+	defer rc.Close()
+
+	wc, err := create(f)
+	if err != nil {
+		return err
+	}
+	if _, err := io.CopyBuffer(wc, rc, buf); err != nil {
+		wc.Close()
+		return err
+	}
+	if err := wc.Close(); err != nil {
+		return err
+	}
+	return rc.Close()
+}
+
+// entryMemory estimates the memory needed to extract f.
+func entryMemory(f *zip.File) int64 {
+	switch f.Method {
+	case Store:
+		return storeMemory
+	case Deflate:
+		return flateMemory
+	case BZip2:
+		return bzip2Memory
+	default:
+		return otherMemory
+	}
+}
+
+func isDir(f *zip.File) bool {
+	return strings.HasSuffix(f.Name, "/") || f.Mode().IsDir()
+}
+
+// joinPath joins dir and the slash-separated name of an entry, rejecting
+// names that would escape dir.
+func joinPath(dir, name string) (string, error) {
+	rel := filepath.FromSlash(name)
+	if filepath.IsAbs(rel) || filepath.VolumeName(rel) != "" {
+		return "", errorf(errors.Invalid, "absolute file name: %s", name)
+	}
+	rel = filepath.Clean(rel)
+	if rel == ".." || strings.HasPrefix(rel, ".."+string(filepath.Separator)) {
+		return "", errorf(errors.Invalid, "file name escapes directory: %s", name)
+	}
+	return filepath.Join(dir, rel), nil
+}
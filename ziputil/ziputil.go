@@ -0,0 +1,109 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+// Package ziputil integrates the decompressors of this repository with
+// archive/zip.
+//
+// Register installs the DEFLATE and BZip2 Readers from this repository as the
+// decompressors of an archive/zip Reader, reusing Readers across entries.
+// Extract and ExtractTo decompress many entries of an archive concurrently.
+package ziputil
+
+import (
+	"archive/zip"
+	"fmt"
+	"io"
+	"sync"
+
+	"github.com/dsnet/compress/bzip2"
+	"github.com/dsnet/compress/flate"
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// Compression methods as defined in the ZIP APPNOTE, section 4.4.5.
+const (
+	Store   = zip.Store
+	Deflate = zip.Deflate
+	BZip2   = 12
+)
+
+var (
+	flatePool sync.Pool // Of *flate.Reader
+	bzip2Pool sync.Pool // Of *bzip2.Reader
+)
+
+// resetReadCloser is the common interface of all pooled Readers.
+type resetReadCloser interface {
+	io.ReadCloser
+	Reset(io.Reader) error
+}
+
+// pooledReader returns its Reader to the pool upon Close.
+type pooledReader struct {
+	rd   resetReadCloser
+	pool *sync.Pool
+}
+
+func (pr *pooledReader) Read(buf []byte) (int, error) {
+	if pr.rd == nil {
+		return 0, errClosed
+	}
+	return pr.rd.Read(buf)
+}
+
+func (pr *pooledReader) Close() error {
+	if pr.rd == nil {
+		return nil
+	}
+	err := errWrap(pr.rd.Close())
+	pr.rd.Reset(nil) // Drop the reference to the entry
+	pr.pool.Put(pr.rd)
+	pr.rd = nil
+	return err
+}
+
+// newFlateReader is a zip.Decompressor for DEFLATE.
+func newFlateReader(r io.Reader) io.ReadCloser {
+	zr, _ := flatePool.Get().(*flate.Reader)
+	if zr == nil {
+		zr, _ = flate.NewReader(r, nil)
+	} else {
+		zr.Reset(r)
+	}
+	return &pooledReader{zr, &flatePool}
+}
+
+// newBZip2Reader is a zip.Decompressor for BZip2.
+func newBZip2Reader(r io.Reader) io.ReadCloser {
+	zr, _ := bzip2Pool.Get().(*bzip2.Reader)
+	if zr == nil {
+		zr, _ = bzip2.NewReader(r, nil)
+	} else {
+		zr.Reset(r)
+	}
+	return &pooledReader{zr, &bzip2Pool}
+}
+
+// Register installs the decompressors of this repository for the Deflate and
+// BZip2 methods on zr, replacing the compress/flate based decompressor that
+// archive/zip uses by default. Decompressors are pooled and shared by all
+// Readers that they are registered on, and are safe for concurrent use.
+func Register(zr *zip.Reader) {
+	zr.RegisterDecompressor(Deflate, newFlateReader)
+	zr.RegisterDecompressor(BZip2, newBZip2Reader)
+}
+
+func errorf(c int, f string, a ...interface{}) error {
+	return errors.Error{Code: c, Pkg: "ziputil", Msg: fmt.Sprintf(f, a...)}
+}
+
+// errWrap converts a lower-level errors.Error to be one from this package.
+func errWrap(err error) error {
+	if cerr, ok := err.(errors.Error); ok {
+		err = errorf(cerr.Code, "%s", cerr.Msg)
+	}
+	return err
+}
+
+var errClosed = errorf(errors.Closed, "")
@@ -0,0 +1,193 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package ziputil
+
+import (
+	"archive/zip"
+	"bytes"
+	"fmt"
+	"io"
+	"io/ioutil"
+	"os"
+	"path/filepath"
+	"sync"
+	"testing"
+
+	"github.com/dsnet/compress/bzip2"
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+type zipEntry struct {
+	name   string
+	method uint16
+	data   []byte
+}
+
+func mustArchive(t *testing.T, entries []zipEntry) *zip.Reader {
+	var bb bytes.Buffer
+	zw := zip.NewWriter(&bb)
+	zw.RegisterCompressor(BZip2, func(w io.Writer) (io.WriteCloser, error) {
+		return bzip2.NewWriter(w, nil)
+	})
+	for _, e := range entries {
+		w, err := zw.CreateHeader(&zip.FileHeader{Name: e.name, Method: e.method})
+		if err != nil {
+			t.Fatalf("unexpected CreateHeader error: %v", err)
+		}
+		if _, err := w.Write(e.data); err != nil {
+			t.Fatalf("unexpected Write error: %v", err)
+		}
+	}
+	if err := zw.Close(); err != nil {
+		t.Fatalf("unexpected Close error: %v", err)
+	}
+	zr, err := zip.NewReader(bytes.NewReader(bb.Bytes()), int64(bb.Len()))
+	if err != nil {
+		t.Fatalf("unexpected NewReader error: %v", err)
+	}
+	return zr
+}
+
+func testEntries() []zipEntry {
+	twain := testutil.MustLoadFile("../testdata/twain.txt")
+	digits := testutil.MustLoadFile("../testdata/digits.txt")
+	entries := []zipEntry{
+		{"dir/", Store, nil},
+		{"empty.txt", Deflate, nil},
+		{"twain.bz2.txt", BZip2, twain},
+		{"dir/sub/digits.txt", Deflate, digits},
+		{"stored.txt", Store, digits[:1000]},
+	}
+	for i := 0; i < 50; i++ {
+		n := (i * 7919) % len(twain)
+		entries = append(entries, zipEntry{fmt.Sprintf("many/%02d.txt", i), Deflate, twain[:n]})
+	}
+	return entries
+}
+
+type memFile struct {
+	bytes.Buffer
+	files map[string][]byte
+	mu    *sync.Mutex
+	name  string
+}
+
+func (f *memFile) Close() error {
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	f.files[f.name] = f.Bytes()
+	return nil
+}
+
+func TestExtractTo(t *testing.T) {
+	entries := testEntries()
+	configs := []*ExtractConfig{
+		nil,
+		{Concurrency: 1},
+		{Concurrency: 8},
+		{Concurrency: 8, MaxMemory: 1},
+		{Concurrency: 4, MaxMemory: 6 << 20},
+	}
+	for i, conf := range configs {
+		zr := mustArchive(t, entries)
+		var mu sync.Mutex
+		files := make(map[string][]byte)
+		err := ExtractTo(zr, func(f *zip.File) (io.WriteCloser, error) {
+			return &memFile{files: files, mu: &mu, name: f.Name}, nil
+		}, conf)
+		if err != nil {
+			t.Fatalf("test %d, unexpected ExtractTo error: %v", i, err)
+		}
+		if len(files) != len(entries)-1 {
+			t.Errorf("test %d, got %d files, want %d", i, len(files), len(entries)-1)
+		}
+		for _, e := range entries[1:] {
+			if got, ok := files[e.name]; !ok || !bytes.Equal(got, e.data) {
+				t.Errorf("test %d, mismatching data for %s", i, e.name)
+			}
+		}
+	}
+}
+
+func TestExtract(t *testing.T) {
+	dir, err := ioutil.TempDir("", "ziputil")
+	if err != nil {
+		t.Fatalf("unexpected TempDir error: %v", err)
+	}
+	defer os.RemoveAll(dir)
+
+	entries := testEntries()
+	if err := Extract(mustArchive(t, entries), dir, nil); err != nil {
+		t.Fatalf("unexpected Extract error: %v", err)
+	}
+	for _, e := range entries {
+		path := filepath.Join(dir, filepath.FromSlash(e.name))
+		if e.name[len(e.name)-1] == '/' {
+			if fi, err := os.Stat(path); err != nil || !fi.IsDir() {
+				t.Errorf("missing directory %s: %v", e.name, err)
+			}
+			continue
+		}
+		if got, err := ioutil.ReadFile(path); err != nil || !bytes.Equal(got, e.data) {
+			t.Errorf("mismatching data for %s: %v", e.name, err)
+		}
+	}
+
+	for _, name := range []string{"../evil.txt", "a/../../evil.txt", "/evil.txt"} {
+		zr := mustArchive(t, []zipEntry{{name, Deflate, []byte("evil")}})
+		if err := Extract(zr, dir, nil); err == nil {
+			t.Errorf("Extract(%q) = nil, want error", name)
+		}
+	}
+}
+
+func TestRegister(t *testing.T) {
+	entries := testEntries()
+	zr := mustArchive(t, entries)
+	Register(zr)
+
+	// Repeatedly open all entries concurrently to exercise the pools.
+	var wg sync.WaitGroup
+	for i := 0; i < 4; i++ {
+		for j, f := range zr.File {
+			wg.Add(1)
+			go func(f *zip.File, want []byte) {
+				defer wg.Done()
+				rc, err := f.Open()
+				if err != nil {
+					t.Errorf("unexpected Open error: %v", err)
+					return
+				}
+				got, err := ioutil.ReadAll(rc)
+				if err != nil || !bytes.Equal(got, want) {
+					t.Errorf("mismatching data for %s: %v", f.Name, err)
+				}
+				if err := rc.Close(); err != nil {
+					t.Errorf("unexpected Close error: %v", err)
+				}
+				if _, err := rc.Read(make([]byte, 1)); err == nil {
+					t.Errorf("Read after Close = nil, want error")
+				}
+			}(f, entries[j].data)
+		}
+	}
+	wg.Wait()
+
+	// Corrupt the compressed data of an entry.
+	var bb bytes.Buffer
+	zw := zip.NewWriter(&bb)
+	w, _ := zw.CreateHeader(&zip.FileHeader{Name: "bad.txt", Method: Deflate})
+	w.Write(testutil.MustLoadFile("../testdata/twain.txt"))
+	zw.Close()
+	b := bb.Bytes()
+	b[100] ^= 0xff
+	zr, _ = zip.NewReader(bytes.NewReader(b), int64(len(b)))
+	err := ExtractTo(zr, func(*zip.File) (io.WriteCloser, error) {
+		return &memFile{files: map[string][]byte{}, mu: new(sync.Mutex)}, nil
+	}, nil)
+	if err == nil {
+		t.Errorf("ExtractTo(corrupted) = nil, want error")
+	}
+}
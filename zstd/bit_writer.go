@@ -0,0 +1,49 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package zstd
+
+// The bitWriter appends bits in LSB-first order to a byte slice.
+//
+// Huffman and FSE bitstreams are read backwards by the decoder, starting from
+// the last bit written. Such streams are terminated by Close, which marks the
+// end of the stream with a single set bit (RFC section 4.1).
+type bitWriter struct {
+	buf     []byte // Output buffer
+	bufBits uint64 // Buffer to hold some bits
+	numBits uint   // Number of valid bits in bufBits
+}
+
+// Init starts a new bitstream that is appended to buf.
+func (bw *bitWriter) Init(buf []byte) {
+	*bw = bitWriter{buf: buf}
+}
+
+// WriteBits writes the lower nb bits of val, where nb must be no more than 32.
+func (bw *bitWriter) WriteBits(val uint64, nb uint) {
+	if bw.numBits >= 32 {
+		bw.buf = append(bw.buf, byte(bw.bufBits), byte(bw.bufBits>>8),
+			byte(bw.bufBits>>16), byte(bw.bufBits>>24))
+		bw.bufBits >>= 32
+		bw.numBits -= 32
+	}
+	bw.bufBits |= (val & (1<<nb - 1)) << bw.numBits
+	bw.numBits += nb
+}
+
+// Pad writes 0-7 zero bits to achieve byte-alignment and returns the output.
+func (bw *bitWriter) Pad() []byte {
+	for n := (bw.numBits + 7) / 8; n > 0; n-- {
+		bw.buf = append(bw.buf, byte(bw.bufBits))
+		bw.bufBits >>= 8
+	}
+	bw.numBits = 0
+	return bw.buf
+}
+
+// Close terminates a backwards bitstream and returns the output.
+func (bw *bitWriter) Close() []byte {
+	bw.WriteBits(1, 1)
+	return bw.Pad()
+}
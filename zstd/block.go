@@ -0,0 +1,165 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package zstd
+
+// blockEncoder encodes blocks of a single segment.
+type blockEncoder struct {
+	mf   matchFinder
+	se   seqEncoder
+	he   huffEncoder
+	seqs []seq
+	lits []byte
+}
+
+// Init prepares to encode a new segment at the given level. If first is set,
+// then the segment is the start of a frame.
+func (be *blockEncoder) Init(lvl int, first bool) {
+	be.mf.Init(lvl)
+	be.se.Init(first)
+}
+
+// Encode appends the block for buf[start:end] to out, where all preceding
+// data in buf may be referenced by matches. The block is never the last block
+// of the frame.
+func (be *blockEncoder) Encode(out []byte, buf []byte, start, end int) []byte {
+	src := buf[start:end]
+	if isRLE(src) {
+		out = appendBlockHeader(out, len(out), blockRLE, len(src))
+		return append(out, src[0])
+	}
+
+	be.seqs, be.lits = be.mf.Find(be.seqs[:0], be.lits[:0], buf, start, end)
+	reps := be.se.reps
+	pos := len(out)
+	out = append(out, 0, 0, 0)
+	out = be.encodeLiterals(out, be.lits)
+	out = be.se.Encode(out, be.seqs)
+	if size := len(out) - pos - 3; size < len(src) {
+		return appendBlockHeader(out, pos, blockCompressed, size)
+	}
+
+	// The compressed block is no smaller, so store the block raw instead.
+	// Since the decoder ignores the sequences, so do the repeated offsets.
+	be.se.reps = reps
+	out = append(out[:pos+3], src...)
+	return appendBlockHeader(out, pos, blockRaw, len(src))
+}
+
+// appendBlockHeader writes the header of a block that is not the last block
+// at out[pos:] (RFC section 3.1.1.2). The header is appended if pos is
+// len(out), otherwise the space for it must already be reserved.
+func appendBlockHeader(out []byte, pos int, typ, size int) []byte {
+	hdr := uint32(typ<<1 | size<<3)
+	if pos == len(out) {
+		out = append(out, 0, 0, 0)
+	}
+	out[pos+0] = byte(hdr)
+	out[pos+1] = byte(hdr >> 8)
+	out[pos+2] = byte(hdr >> 16)
+	return out
+}
+
+// encodeLiterals appends the literals section for lits to out
+// (RFC section 3.1.1.3.1).
+func (be *blockEncoder) encodeLiterals(out []byte, lits []byte) []byte {
+	if len(lits) == 0 {
+		return appendLiteralsHeader(out, litsRaw, 0)
+	}
+	if isRLE(lits) {
+		return append(appendLiteralsHeader(out, litsRLE, len(lits)), lits[0])
+	}
+	if len(lits) < minHuffLiterals {
+		return append(appendLiteralsHeader(out, litsRaw, len(lits)), lits...)
+	}
+
+	var cnts [256]uint32
+	for _, c := range lits {
+		cnts[c]++
+	}
+	he := &be.he
+	he.Init(&cnts)
+
+	// Estimate the size of the streams before doing the work of encoding them.
+	rawSize := len(lits) + 3
+	if he.Cost(&cnts) >= rawSize {
+		return append(appendLiteralsHeader(out, litsRaw, len(lits)), lits...)
+	}
+
+	// Size_Format of Compressed_Literals_Block, where a single stream is
+	// only used for small sections and the sizes use 10, 14, or 18 bits.
+	var sizeFormat, hdrSize, sizeBits uint
+	switch {
+	case len(lits) < 1<<10:
+		sizeFormat, hdrSize, sizeBits = 0, 3, 10
+	case len(lits) < 1<<14:
+		sizeFormat, hdrSize, sizeBits = 2, 4, 14
+	default:
+		sizeFormat, hdrSize, sizeBits = 3, 5, 18
+	}
+	pos := len(out)
+	out = append(out, make([]byte, hdrSize)...)
+	out, ok := he.WriteTable(out)
+	if !ok {
+		return append(appendLiteralsHeader(out[:pos], litsRaw, len(lits)), lits...)
+	}
+	if sizeFormat == 0 {
+		out = he.Encode(out, lits)
+	} else {
+		// Encode four streams, preceded by a jump table of the sizes of the
+		// first three streams.
+		jump := len(out)
+		out = append(out, 0, 0, 0, 0, 0, 0)
+		n := (len(lits) + 3) / 4
+		for i := 0; i < 4; i++ {
+			beg := len(out)
+			if i < 3 {
+				out = he.Encode(out, lits[i*n:(i+1)*n])
+				size := len(out) - beg
+				out[jump+2*i+0] = byte(size)
+				out[jump+2*i+1] = byte(size >> 8)
+			} else {
+				out = he.Encode(out, lits[3*n:])
+			}
+		}
+	}
+
+	compSize := len(out) - pos - int(hdrSize)
+	if compSize+int(hdrSize) >= rawSize {
+		return append(appendLiteralsHeader(out[:pos], litsRaw, len(lits)), lits...)
+	}
+	hdr := uint64(litsCompressed) | uint64(sizeFormat)<<2 |
+		uint64(len(lits))<<4 | uint64(compSize)<<(4+sizeBits)
+	for i := uint(0); i < hdrSize; i++ {
+		out[pos+int(i)] = byte(hdr >> (8 * i))
+	}
+	return out
+}
+
+// appendLiteralsHeader appends the header of a raw or RLE literals section.
+func appendLiteralsHeader(out []byte, typ, size int) []byte {
+	switch {
+	case size < 1<<5:
+		return append(out, byte(typ|size<<3))
+	case size < 1<<12:
+		hdr := typ | 1<<2 | size<<4
+		return append(out, byte(hdr), byte(hdr>>8))
+	default:
+		hdr := typ | 3<<2 | size<<4
+		return append(out, byte(hdr), byte(hdr>>8), byte(hdr>>16))
+	}
+}
+
+// isRLE reports whether buf consists of a single repeated byte.
+func isRLE(buf []byte) bool {
+	if len(buf) == 0 {
+		return false
+	}
+	for _, c := range buf[1:] {
+		if c != buf[0] {
+			return false
+		}
+	}
+	return true
+}
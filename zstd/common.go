@@ -0,0 +1,74 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+// Package zstd implements the Zstandard compressed data format,
+// described in RFC 8878.
+//
+// Only compression is currently supported.
+package zstd
+
+import (
+	"fmt"
+	"math/bits"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+func errorf(c int, f string, a ...interface{}) error {
+	return errors.Error{Code: c, Pkg: "zstd", Msg: fmt.Sprintf(f, a...)}
+}
+
+func panicf(c int, f string, a ...interface{}) {
+	errors.Panic(errorf(c, f, a...))
+}
+
+// errWrap converts a lower-level errors.Error to be one from this package.
+// The replaceCode passed in will be used to replace the code for any errors
+// with the errors.Invalid code.
+//
+// For the Writer, set this to errors.Internal.
+func errWrap(err error, replaceCode int) error {
+	if cerr, ok := err.(errors.Error); ok {
+		if errors.IsInvalid(cerr) {
+			cerr.Code = replaceCode
+		}
+		err = errorf(cerr.Code, "%s", cerr.Msg)
+	}
+	return err
+}
+
+const (
+	BestSpeed          = 1
+	BestCompression    = 9
+	DefaultCompression = 3
+)
+
+var errClosed = errorf(errors.Closed, "")
+
+const (
+	frameMagic   = 0xfd2fb528 // Magic number of a Zstandard frame
+	maxBlockSize = 128 << 10  // Maximum uncompressed size of a block
+	minMatch     = 3          // Shortest match length that can be encoded
+
+	// Block types (RFC section 3.1.1.2.2).
+	blockRaw        = 0
+	blockRLE        = 1
+	blockCompressed = 2
+
+	// Literals block types (RFC section 3.1.1.3.1.1).
+	litsRaw        = 0
+	litsRLE        = 1
+	litsCompressed = 2
+
+	// Symbol compression modes (RFC section 3.1.1.3.2.1).
+	modePredefined = 0
+	modeRLE        = 1
+	modeFSE        = 2
+)
+
+// highBit returns the index of the most significant set bit of v,
+// which must be non-zero.
+func highBit(v uint32) uint {
+	return uint(bits.Len32(v) - 1)
+}
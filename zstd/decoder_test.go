@@ -0,0 +1,574 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package zstd
+
+import (
+	"encoding/binary"
+	"fmt"
+)
+
+// This file implements a simple Zstandard decoder (RFC 8878) that is only
+// used to verify the output of the Writer. It favors clarity over speed and
+// supports every block and table type, but neither dictionaries nor
+// skippable frames. It is checked against frames produced by the C library.
+
+// decodeFrames decodes all of the concatenated frames in input.
+func decodeFrames(input []byte) (output []byte, err error) {
+	defer func() {
+		if ex := recover(); ex != nil {
+			err = fmt.Errorf("%v", ex) // Includes out of bounds accesses
+		}
+	}()
+	if len(input) == 0 {
+		failf("no frames")
+	}
+	for len(input) > 0 {
+		var d frameDecoder
+		input = d.decodeFrame(input)
+		output = append(output, d.out...)
+	}
+	return output, nil
+}
+
+func failf(f string, a ...interface{}) { panic(fmt.Sprintf(f, a...)) }
+
+// fwdBitReader reads bits in LSB-first order from the start of a buffer.
+type fwdBitReader struct {
+	buf []byte
+	pos uint // Number of bits read
+}
+
+func (br *fwdBitReader) peek(nb uint) uint32 {
+	var v uint32
+	for i := uint(0); i < nb; i++ {
+		if p := br.pos + i; p/8 < uint(len(br.buf)) {
+			v |= uint32(br.buf[p/8]>>(p%8)&1) << i
+		}
+	}
+	return v
+}
+
+// revBitReader reads a backwards bitstream, starting from the bit preceding
+// the final set bit of the buffer (RFC section 4.1).
+type revBitReader struct {
+	buf []byte
+	pos int // Number of unread bits; negative once the stream is overread
+}
+
+func newRevBitReader(buf []byte) *revBitReader {
+	if len(buf) == 0 || buf[len(buf)-1] == 0 {
+		failf("missing end of bitstream marker")
+	}
+	return &revBitReader{buf: buf, pos: 8*(len(buf)-1) + int(highBit(uint32(buf[len(buf)-1])))}
+}
+
+func (br *revBitReader) read(nb uint) uint32 {
+	var v uint32
+	for i := uint(0); i < nb; i++ {
+		br.pos--
+		var bit uint32
+		if br.pos >= 0 {
+			bit = uint32(br.buf[br.pos/8] >> uint(br.pos%8) & 1)
+		}
+		v = v<<1 | bit
+	}
+	return v
+}
+
+// fseTable is an FSE decoding table.
+type fseTable struct {
+	log  uint
+	syms []uint8
+	nbs  []uint8
+	base []uint16
+}
+
+// newFSETable builds the decoding table for a normalized distribution.
+func newFSETable(norm []int16, log uint) *fseTable {
+	size := 1 << log
+	t := &fseTable{log: log, syms: make([]uint8, size), nbs: make([]uint8, size), base: make([]uint16, size)}
+	high := size - 1
+	next := make([]int, len(norm))
+	for s, n := range norm {
+		if n == -1 {
+			t.syms[high] = uint8(s)
+			high--
+			next[s] = 1
+		} else {
+			next[s] = int(n)
+		}
+	}
+	step := (size >> 1) + (size >> 3) + 3
+	var pos int
+	for s, n := range norm {
+		for i := 0; i < int(n); i++ {
+			t.syms[pos] = uint8(s)
+			pos = (pos + step) & (size - 1)
+			for pos > high {
+				pos = (pos + step) & (size - 1)
+			}
+		}
+	}
+	if pos != 0 {
+		failf("invalid FSE distribution")
+	}
+	for u := range t.syms {
+		x := next[t.syms[u]]
+		next[t.syms[u]]++
+		nb := log - highBit(uint32(x))
+		t.nbs[u] = uint8(nb)
+		t.base[u] = uint16(x<<nb - size)
+	}
+	return t
+}
+
+// newRLETable returns a table that always decodes sym.
+func newRLETable(sym uint8) *fseTable {
+	return &fseTable{syms: []uint8{sym}, nbs: []uint8{0}, base: []uint16{0}}
+}
+
+// readNCount reads an FSE table description (RFC section 4.1.1) from the
+// start of buf and returns the table and the number of bytes read.
+func readNCount(buf []byte, maxSyms int, maxLog uint) (*fseTable, int) {
+	br := fwdBitReader{buf: buf}
+	log := uint(br.peek(4)) + minFSETableLog
+	br.pos += 4
+	if log > maxLog {
+		failf("FSE accuracy log too large: %d", log)
+	}
+	remaining := 1<<log + 1
+	threshold := 1 << log
+	nbBits := log + 1
+	var norm []int16
+	for remaining > 1 {
+		if len(norm) >= maxSyms {
+			failf("too many FSE symbols")
+		}
+		max := 2*threshold - 1 - remaining
+		var v int
+		if small := int(br.peek(nbBits - 1)); small < max {
+			v = small
+			br.pos += nbBits - 1
+		} else {
+			v = int(br.peek(nbBits))
+			if v >= threshold {
+				v -= max
+			}
+			br.pos += nbBits
+		}
+		n := v - 1
+		norm = append(norm, int16(n))
+		if n < 0 {
+			remaining += n
+		} else {
+			remaining -= n
+		}
+		if n == 0 {
+			for {
+				r := int(br.peek(2))
+				br.pos += 2
+				norm = append(norm, make([]int16, r)...)
+				if r < 3 {
+					break
+				}
+			}
+		}
+		for remaining < threshold {
+			nbBits--
+			threshold >>= 1
+		}
+	}
+	if remaining != 1 || int(br.pos+7)/8 > len(buf) {
+		failf("invalid FSE table description")
+	}
+	return newFSETable(norm, log), int(br.pos+7) / 8
+}
+
+var (
+	predefLLTable = newFSETable(predefLLNorm, 6)
+	predefMLTable = newFSETable(predefMLNorm, 6)
+	predefOFTable = newFSETable(predefOFNorm, 5)
+)
+
+// fseDecState is the state of a single FSE decoder.
+type fseDecState struct {
+	t     *fseTable
+	state uint32
+}
+
+func (s *fseDecState) init(br *revBitReader, t *fseTable) {
+	s.t, s.state = t, br.read(t.log)
+}
+
+func (s *fseDecState) symbol() uint8 { return s.t.syms[s.state] }
+
+func (s *fseDecState) update(br *revBitReader) {
+	s.state = uint32(s.t.base[s.state]) + br.read(uint(s.t.nbs[s.state]))
+}
+
+// frameDecoder holds the state of a single frame, which includes the tables
+// and repeated offsets that carry across blocks.
+type frameDecoder struct {
+	out     []byte
+	winSize int
+	reps    [3]int
+
+	huffLens      []uint8 // Bit-length of each entry of the last Huffman table
+	huffSyms      []uint8 // Symbol of each entry of the last Huffman table
+	huffMax       uint    // Maximum bit-length of the last Huffman table
+	llT, ofT, mlT *fseTable
+}
+
+func (d *frameDecoder) decodeFrame(in []byte) []byte {
+	if len(in) < 5 || binary.LittleEndian.Uint32(in) != frameMagic {
+		failf("invalid frame magic")
+	}
+	fhd := in[4]
+	in = in[5:]
+	fcsFlag, single, checksum, dictFlag := fhd>>6, fhd>>5&1 == 1, fhd>>2&1 == 1, fhd&3
+	if fhd&(1<<3) != 0 {
+		failf("reserved frame header bit set")
+	}
+	if !single {
+		exp, mant := uint(in[0]>>3), int(in[0]&7)
+		base := 1 << (10 + exp)
+		d.winSize = base + base/8*mant
+		in = in[1:]
+	}
+	if dictFlag != 0 {
+		failf("dictionaries are not supported")
+	}
+	fcsSize := [4]int{0, 2, 4, 8}[fcsFlag]
+	if single && fcsFlag == 0 {
+		fcsSize = 1
+	}
+	var fcs uint64
+	for i := fcsSize - 1; i >= 0; i-- {
+		fcs = fcs<<8 | uint64(in[i])
+	}
+	if fcsSize == 2 {
+		fcs += 256
+	}
+	in = in[fcsSize:]
+	if single {
+		d.winSize = int(fcs)
+	}
+
+	d.reps = [3]int{1, 4, 8}
+	for last := false; !last; {
+		if len(in) < 3 {
+			failf("truncated block header")
+		}
+		hdr := int(in[0]) | int(in[1])<<8 | int(in[2])<<16
+		in = in[3:]
+		last = hdr&1 == 1
+		typ, size := hdr>>1&3, hdr>>3
+		switch typ {
+		case blockRaw:
+			d.out = append(d.out, in[:size]...)
+			in = in[size:]
+		case blockRLE:
+			for i := 0; i < size; i++ {
+				d.out = append(d.out, in[0])
+			}
+			in = in[1:]
+		case blockCompressed:
+			if size > maxBlockSize {
+				failf("block too large: %d", size)
+			}
+			start := len(d.out)
+			d.decodeBlock(in[:size])
+			if len(d.out)-start > maxBlockSize {
+				failf("block output too large: %d", len(d.out)-start)
+			}
+			in = in[size:]
+		default:
+			failf("reserved block type")
+		}
+	}
+	if fcsSize > 0 && fcs != uint64(len(d.out)) {
+		failf("content size mismatch: %d != %d", fcs, len(d.out))
+	}
+	if checksum {
+		var xxh xxHash64
+		xxh.Reset()
+		xxh.Write(d.out)
+		if binary.LittleEndian.Uint32(in) != uint32(xxh.Sum64()) {
+			failf("content checksum mismatch")
+		}
+		in = in[4:]
+	}
+	return in
+}
+
+func (d *frameDecoder) decodeBlock(in []byte) {
+	lits, n := d.decodeLiterals(in)
+	in = in[n:]
+
+	// Read the number of sequences and the compression modes.
+	var nseq int
+	switch {
+	case in[0] < 128:
+		nseq, in = int(in[0]), in[1:]
+	case in[0] < 255:
+		nseq, in = int(in[0]-128)<<8+int(in[1]), in[2:]
+	default:
+		nseq, in = int(in[1])+int(in[2])<<8+0x7f00, in[3:]
+	}
+	if nseq == 0 {
+		if len(in) != 0 {
+			failf("trailing data after sequences")
+		}
+		d.out = append(d.out, lits...)
+		return
+	}
+	modes := in[0]
+	in = in[1:]
+	if modes&3 != 0 {
+		failf("reserved compression modes bits set")
+	}
+	d.llT, in = d.readTable(in, modes>>6, d.llT, predefLLTable, numLLCodes, maxLLTableLog)
+	d.ofT, in = d.readTable(in, modes>>4&3, d.ofT, predefOFTable, numOFCodes, maxOFTableLog)
+	d.mlT, in = d.readTable(in, modes>>2&3, d.mlT, predefMLTable, numMLCodes, maxMLTableLog)
+
+	// Decode and execute the sequences.
+	br := newRevBitReader(in)
+	var llS, ofS, mlS fseDecState
+	llS.init(br, d.llT)
+	ofS.init(br, d.ofT)
+	mlS.init(br, d.mlT)
+	for i := 0; i < nseq; i++ {
+		llc, ofc, mlc := llS.symbol(), ofS.symbol(), mlS.symbol()
+		if int(llc) >= numLLCodes || int(mlc) >= numMLCodes || ofc > 31 {
+			failf("invalid sequence code")
+		}
+		ofVal := int(1)<<ofc + int(br.read(uint(ofc)))
+		ml := int(mlBases[mlc]) + minMatch + int(br.read(uint(mlBits[mlc])))
+		ll := int(llBases[llc]) + int(br.read(uint(llBits[llc])))
+		if i < nseq-1 {
+			llS.update(br)
+			mlS.update(br)
+			ofS.update(br)
+		}
+
+		var off int
+		if ofVal > 3 {
+			off = ofVal - 3
+			d.reps = [3]int{off, d.reps[0], d.reps[1]}
+		} else {
+			rep := ofVal
+			if ll == 0 {
+				rep++
+			}
+			switch rep {
+			case 1:
+				off = d.reps[0]
+			case 2:
+				off = d.reps[1]
+				d.reps = [3]int{off, d.reps[0], d.reps[2]}
+			case 3:
+				off = d.reps[2]
+				d.reps = [3]int{off, d.reps[0], d.reps[1]}
+			case 4:
+				off = d.reps[0] - 1
+				d.reps = [3]int{off, d.reps[0], d.reps[1]}
+			}
+		}
+
+		if ll > len(lits) {
+			failf("literal length exceeds literals")
+		}
+		d.out = append(d.out, lits[:ll]...)
+		lits = lits[ll:]
+		if off <= 0 || off > len(d.out) || off > d.winSize {
+			failf("invalid offset: %d", off)
+		}
+		for j := 0; j < ml; j++ {
+			d.out = append(d.out, d.out[len(d.out)-off])
+		}
+	}
+	if br.pos != 0 {
+		failf("sequences bitstream not fully consumed: %d", br.pos)
+	}
+	d.out = append(d.out, lits...)
+}
+
+// readTable reads the FSE table for the given compression mode.
+func (d *frameDecoder) readTable(in []byte, mode uint8, prev, predef *fseTable, maxSyms int, maxLog uint) (*fseTable, []byte) {
+	switch mode {
+	case modePredefined:
+		return predef, in
+	case modeRLE:
+		return newRLETable(in[0]), in[1:]
+	case modeFSE:
+		t, n := readNCount(in, maxSyms, maxLog)
+		return t, in[n:]
+	default:
+		if prev == nil {
+			failf("repeated table without a previous table")
+		}
+		return prev, in
+	}
+}
+
+// decodeLiterals decodes the literals section at the start of in and
+// returns the literals and the size of the section.
+func (d *frameDecoder) decodeLiterals(in []byte) ([]byte, int) {
+	typ, sizeFormat := int(in[0]&3), int(in[0]>>2&3)
+	if typ == litsRaw || typ == litsRLE {
+		var size, n int
+		switch sizeFormat {
+		case 0, 2:
+			size, n = int(in[0]>>3), 1
+		case 1:
+			size, n = int(in[0]>>4)+int(in[1])<<4, 2
+		case 3:
+			size, n = int(in[0]>>4)+int(in[1])<<4+int(in[2])<<12, 3
+		}
+		if typ == litsRLE {
+			lits := make([]byte, size)
+			for i := range lits {
+				lits[i] = in[n]
+			}
+			return lits, n + 1
+		}
+		return append([]byte(nil), in[n:n+size]...), n + size
+	}
+
+	hdrSize, sizeBits, numStreams := [4]int{3, 3, 4, 5}[sizeFormat], [4]uint{10, 10, 14, 18}[sizeFormat], 4
+	if sizeFormat == 0 {
+		numStreams = 1
+	}
+	var hdr uint64
+	for i := hdrSize - 1; i >= 0; i-- {
+		hdr = hdr<<8 | uint64(in[i])
+	}
+	regenSize := int(hdr>>4) & (1<<sizeBits - 1)
+	compSize := int(hdr>>(4+sizeBits)) & (1<<sizeBits - 1)
+	src := in[hdrSize : hdrSize+compSize]
+	if typ == litsCompressed {
+		n := d.readHuffmanTable(src)
+		src = src[n:]
+	} else if d.huffSyms == nil {
+		failf("treeless literals without a previous table")
+	}
+
+	lits := make([]byte, 0, regenSize)
+	if numStreams == 1 {
+		lits = d.decodeHuffman(lits, src, regenSize)
+	} else {
+		segSize := (regenSize + 3) / 4
+		sizes := [4]int{
+			int(binary.LittleEndian.Uint16(src[0:])),
+			int(binary.LittleEndian.Uint16(src[2:])),
+			int(binary.LittleEndian.Uint16(src[4:])),
+		}
+		src = src[6:]
+		sizes[3] = len(src) - sizes[0] - sizes[1] - sizes[2]
+		for i, size := range sizes {
+			n := segSize
+			if i == 3 {
+				n = regenSize - 3*segSize
+			}
+			if size < 0 || size > len(src) {
+				failf("invalid jump table")
+			}
+			lits = d.decodeHuffman(lits, src[:size], n)
+			src = src[size:]
+		}
+	}
+	return lits, hdrSize + compSize
+}
+
+// readHuffmanTable reads the Huffman tree description (RFC section 4.2.1)
+// and returns its size.
+func (d *frameDecoder) readHuffmanTable(in []byte) int {
+	var weights []uint8
+	var n int
+	if h := int(in[0]); h < 128 {
+		t, m := readNCount(in[1:1+h], maxHuffBits+1, maxWeightsTableLog)
+		br := newRevBitReader(in[1+m : 1+h])
+		var s1, s2 fseDecState
+		s1.init(br, t)
+		s2.init(br, t)
+		for len(weights) < 255 {
+			weights = append(weights, s1.symbol())
+			s1.update(br)
+			if br.pos < 0 {
+				weights = append(weights, s2.symbol())
+				break
+			}
+			weights = append(weights, s2.symbol())
+			s2.update(br)
+			if br.pos < 0 {
+				weights = append(weights, s1.symbol())
+				break
+			}
+		}
+		n = 1 + h
+	} else {
+		num := h - 127
+		for i := 0; i < num; i++ {
+			b := in[1+i/2]
+			if i%2 == 0 {
+				weights = append(weights, b>>4)
+			} else {
+				weights = append(weights, b&15)
+			}
+		}
+		n = 1 + (num+1)/2
+	}
+
+	// Derive the weight of the last symbol, which completes the code.
+	var total int
+	for _, w := range weights {
+		if w > 0 {
+			total += 1 << (w - 1)
+		}
+	}
+	if total == 0 {
+		failf("empty Huffman table")
+	}
+	maxBits := highBit(uint32(total)) + 1
+	rest := 1<<maxBits - total
+	if rest&(rest-1) != 0 || maxBits > maxHuffBits {
+		failf("invalid Huffman weights")
+	}
+	weights = append(weights, uint8(highBit(uint32(rest))+1))
+
+	// Assign table entries in order of increasing weight and then symbol.
+	d.huffMax = maxBits
+	d.huffLens = make([]uint8, 1<<maxBits)
+	d.huffSyms = make([]uint8, 1<<maxBits)
+	var pos int
+	for w := uint8(1); w <= uint8(maxBits); w++ {
+		for sym, sw := range weights {
+			if sw != w {
+				continue
+			}
+			for i := 0; i < 1<<(w-1); i++ {
+				d.huffLens[pos] = uint8(maxBits) + 1 - w
+				d.huffSyms[pos] = uint8(sym)
+				pos++
+			}
+		}
+	}
+	return n
+}
+
+// decodeHuffman decodes n literals from a single Huffman stream.
+func (d *frameDecoder) decodeHuffman(lits, src []byte, n int) []byte {
+	br := newRevBitReader(src)
+	for i := 0; i < n; i++ {
+		save := br.pos
+		v := br.read(d.huffMax)
+		br.pos = save - int(d.huffLens[v])
+		lits = append(lits, d.huffSyms[v])
+	}
+	if br.pos != 0 {
+		failf("Huffman bitstream not fully consumed: %d", br.pos)
+	}
+	return lits
+}
@@ -0,0 +1,315 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package zstd
+
+import (
+	"math"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+const (
+	maxFSESyms     = 64 // Largest alphabet encoded with FSE (match lengths)
+	maxFSETableLog = 9  // Largest accuracy log used by any FSE table
+	minFSETableLog = 5  // Smallest accuracy log of an FSE table
+)
+
+// Predefined distributions for the sequence codes (RFC section 3.1.1.3.2.2).
+var (
+	predefLLNorm = []int16{
+		4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+		2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+		-1, -1, -1, -1,
+	}
+	predefMLNorm = []int16{
+		1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+		-1, -1, -1, -1, -1,
+	}
+	predefOFNorm = []int16{
+		1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+		1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1,
+	}
+
+	predefLLEnc fseEncoder
+	predefMLEnc fseEncoder
+	predefOFEnc fseEncoder
+)
+
+func init() {
+	predefLLEnc.Init(predefLLNorm, 6)
+	predefMLEnc.Init(predefMLNorm, 6)
+	predefOFEnc.Init(predefOFNorm, 5)
+}
+
+// fseSymbolTransform holds the parameters used to encode a single symbol,
+// as used by the reference implementation. The number of bits emitted for a
+// symbol is (state+deltaNbBits)>>16, such that it is determined by a single
+// addition and shift.
+type fseSymbolTransform struct {
+	deltaNbBits    uint32
+	deltaFindState int32
+}
+
+// fseEncoder is an FSE encoding table for a normalized distribution.
+type fseEncoder struct {
+	tableLog   uint
+	norm       []int16                        // Normalized distribution
+	symbols    [1 << maxFSETableLog]uint8     // Symbol of each decoder state
+	stateTable [1 << maxFSETableLog]uint16    // Next state, ordered by symbol
+	symTT      [maxFSESyms]fseSymbolTransform // Transform for each symbol
+	normBuf    [maxFSESyms]int16
+}
+
+// Init builds the encoding table for the distribution norm, which must sum up
+// to 1<<tableLog, where a probability of -1 denotes a "less than 1" symbol.
+// Symbols are spread across the table exactly as the decoder does
+// (RFC section 4.1.1).
+func (fe *fseEncoder) Init(norm []int16, tableLog uint) {
+	fe.tableLog = tableLog
+	fe.norm = fe.normBuf[:copy(fe.normBuf[:], norm)]
+	size := 1 << tableLog
+	mask := size - 1
+	high := size - 1
+
+	// Compute the starting position of each symbol in the state table,
+	// placing all "less than 1" symbols at the end of the table.
+	var cumul [maxFSESyms + 1]int
+	for s, n := range norm {
+		if n == -1 {
+			cumul[s+1] = cumul[s] + 1
+			fe.symbols[high] = uint8(s)
+			high--
+		} else {
+			cumul[s+1] = cumul[s] + int(n)
+		}
+	}
+
+	// Spread the symbols across the table.
+	step := (size >> 1) + (size >> 3) + 3
+	var pos int
+	for s, n := range norm {
+		for i := 0; i < int(n); i++ {
+			fe.symbols[pos] = uint8(s)
+			pos = (pos + step) & mask
+			for pos > high {
+				pos = (pos + step) & mask
+			}
+		}
+	}
+	if pos != 0 {
+		panicf(errors.Internal, "invalid FSE distribution")
+	}
+
+	// Build the state table, where the states of each symbol are ordered.
+	for u := 0; u < size; u++ {
+		s := fe.symbols[u]
+		fe.stateTable[cumul[s]] = uint16(size + u)
+		cumul[s]++
+	}
+
+	// Build the symbol transformations.
+	var total int32
+	for s, n := range norm {
+		switch n {
+		case 0:
+			fe.symTT[s] = fseSymbolTransform{deltaNbBits: uint32(tableLog+1)<<16 - uint32(size)}
+		case -1, 1:
+			fe.symTT[s] = fseSymbolTransform{
+				deltaNbBits:    uint32(tableLog)<<16 - uint32(size),
+				deltaFindState: total - 1,
+			}
+			total++
+		default:
+			maxBitsOut := tableLog - highBit(uint32(n-1))
+			minStatePlus := uint32(n) << maxBitsOut
+			fe.symTT[s] = fseSymbolTransform{
+				deltaNbBits:    uint32(maxBitsOut)<<16 - minStatePlus,
+				deltaFindState: total - int32(n),
+			}
+			total += int32(n)
+		}
+	}
+}
+
+// decodeBits reports the number of bits the decoder reads to leave the state
+// with the given initial encoder state.
+func (fe *fseEncoder) decodeBits(state uint32) uint {
+	u := int(state) - 1<<fe.tableLog
+	s := fe.symbols[u]
+	next := uint32(fe.norm[s])
+	if fe.norm[s] == -1 {
+		next = 1
+	}
+	for _, t := range fe.symbols[:u] {
+		if t == s {
+			next++
+		}
+	}
+	return fe.tableLog - highBit(next)
+}
+
+// Cost estimates the number of bits needed to encode the symbols with the
+// given counts. It returns +Inf if some symbol cannot be encoded.
+func (fe *fseEncoder) Cost(cnts []uint32) float64 {
+	var bits float64
+	for s, c := range cnts {
+		if c == 0 {
+			continue
+		}
+		if s >= len(fe.norm) || fe.norm[s] == 0 {
+			return math.Inf(+1)
+		}
+		p := float64(fe.norm[s])
+		if p < 0 {
+			p = 1
+		}
+		bits += float64(c) * (float64(fe.tableLog) - math.Log2(p))
+	}
+	return bits
+}
+
+// fseState is the state of an FSE encoder. Symbols are encoded in the
+// reverse order that they are decoded in.
+type fseState struct {
+	enc   *fseEncoder
+	state uint32
+}
+
+// Init initializes the state with the last symbol to be decoded,
+// which requires no bits to be written.
+func (fs *fseState) Init(enc *fseEncoder, sym uint8) {
+	tt := enc.symTT[sym]
+	nbBits := (tt.deltaNbBits + 1<<15) >> 16
+	val := nbBits<<16 - tt.deltaNbBits
+	*fs = fseState{enc: enc}
+	fs.state = uint32(enc.stateTable[int32(val>>nbBits)+tt.deltaFindState])
+}
+
+// Encode writes the bits needed to transition to the state for sym.
+func (fs *fseState) Encode(bw *bitWriter, sym uint8) {
+	tt := fs.enc.symTT[sym]
+	nbBits := (fs.state + tt.deltaNbBits) >> 16
+	bw.WriteBits(uint64(fs.state), uint(nbBits))
+	fs.state = uint32(fs.enc.stateTable[int32(fs.state>>nbBits)+tt.deltaFindState])
+}
+
+// Flush writes the final state, which is the first to be read by the decoder.
+func (fs *fseState) Flush(bw *bitWriter) {
+	bw.WriteBits(uint64(fs.state), fs.enc.tableLog)
+}
+
+// fseTableLog chooses the accuracy log for total symbols spread over an
+// alphabet of numSyms symbols, in the same way as the reference library.
+func fseTableLog(total, numSyms int, maxLog uint) uint {
+	tableLog := int(maxLog)
+	if b := int(highBit(uint32(total-1))) - 2; b < tableLog {
+		tableLog = b // Avoid tables that are larger than the input
+	}
+	minLog := int(highBit(uint32(total-1))) + 1
+	if b := int(highBit(uint32(numSyms-1))) + 2; b < minLog {
+		minLog = b
+	}
+	if tableLog < minLog {
+		tableLog = minLog
+	}
+	if tableLog < minFSETableLog {
+		tableLog = minFSETableLog
+	}
+	if tableLog > int(maxLog) {
+		tableLog = int(maxLog)
+	}
+	return uint(tableLog)
+}
+
+// normalizeCounts computes a distribution of cnts that sums up to 1<<tableLog,
+// where every present symbol has a probability of at least one.
+// The total of cnts must be non-zero.
+func normalizeCounts(norm []int16, cnts []uint32, tableLog uint) []int16 {
+	var total uint64
+	for _, c := range cnts {
+		total += uint64(c)
+	}
+	size := 1 << tableLog
+	var sum, largest int
+	for s, c := range cnts {
+		n := int((uint64(c)<<tableLog + total/2) / total)
+		if n == 0 && c > 0 {
+			n = 1
+		}
+		norm = append(norm, int16(n))
+		sum += n
+		if n > int(norm[largest]) {
+			largest = s
+		}
+	}
+
+	// Correct any rounding errors using the symbols with the largest
+	// probabilities, where the relative cost of the change is the least.
+	for sum > size {
+		for s, n := range norm {
+			if n > norm[largest] {
+				largest = s
+			}
+		}
+		norm[largest]--
+		sum--
+	}
+	norm[largest] += int16(size - sum)
+	return norm
+}
+
+// writeNCount writes the FSE table description for the distribution norm
+// (RFC section 4.1.1), where norm may omit trailing zero probabilities.
+func writeNCount(bw *bitWriter, norm []int16, tableLog uint) {
+	bw.WriteBits(uint64(tableLog-minFSETableLog), 4)
+	size := 1 << tableLog
+	remaining := size + 1
+	threshold := size
+	nbBits := tableLog + 1
+	prev0 := false
+	for sym := 0; sym < len(norm) && remaining > 1; {
+		if prev0 {
+			// Encode the run of zero probabilities.
+			start := sym
+			for norm[sym] == 0 {
+				sym++
+			}
+			for sym >= start+24 {
+				start += 24
+				bw.WriteBits(0xffff, 16)
+			}
+			for sym >= start+3 {
+				start += 3
+				bw.WriteBits(3, 2)
+			}
+			bw.WriteBits(uint64(sym-start), 2)
+		}
+
+		count := int(norm[sym])
+		sym++
+		max := 2*threshold - 1 - remaining
+		if count < 0 {
+			remaining += count
+		} else {
+			remaining -= count
+		}
+		count++ // Probabilities are stored with an offset of one
+		if count >= threshold {
+			count += max
+		}
+		nb := nbBits
+		if count < max {
+			nb--
+		}
+		bw.WriteBits(uint64(count), nb)
+		prev0 = count == 1
+		for remaining < threshold {
+			nbBits--
+			threshold >>= 1
+		}
+	}
+}
@@ -0,0 +1,177 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package zstd
+
+import (
+	"github.com/dsnet/compress/internal/errors"
+	"github.com/dsnet/compress/internal/prefix"
+)
+
+const (
+	maxHuffBits        = 11 // Maximum bit-length of a Huffman code
+	maxWeightsTableLog = 6  // Maximum accuracy log for compressed weights
+	minHuffLiterals    = 32 // Fewer literals than this are stored raw
+)
+
+// huffEncoder encodes literals using a Huffman code (RFC section 4.2).
+type huffEncoder struct {
+	codes   [256]uint16 // Prefix code of each symbol
+	lens    [256]uint8  // Bit-length of each symbol; zero if absent
+	weights []uint8     // Weights of all but the last present symbol
+
+	pcs  prefix.PrefixCodes
+	fe   fseEncoder
+	norm []int16
+	bw   bitWriter
+}
+
+// Init builds the Huffman code for the given symbol counts,
+// which must have at least two present symbols.
+func (he *huffEncoder) Init(cnts *[256]uint32) {
+	he.pcs = he.pcs[:0]
+	for sym, cnt := range cnts {
+		if cnt > 0 {
+			he.pcs = append(he.pcs, prefix.PrefixCode{Sym: uint32(sym), Cnt: cnt})
+		}
+	}
+	he.pcs.SortByCount()
+	if err := prefix.GenerateLengths(he.pcs, maxHuffBits); err != nil {
+		errors.Panic(err)
+	}
+	he.lens = [256]uint8{}
+	var maxBits uint8
+	var lastSym uint32
+	for _, c := range he.pcs {
+		he.lens[c.Sym] = uint8(c.Len)
+		if uint8(c.Len) > maxBits {
+			maxBits = uint8(c.Len)
+		}
+		if c.Sym > lastSym {
+			lastSym = c.Sym
+		}
+	}
+
+	// Convert the bit-lengths to weights, where the weight of the last symbol
+	// is implied by the others (RFC section 4.2.1).
+	var rankStart [maxHuffBits + 2]uint32
+	he.weights = he.weights[:0]
+	for sym, n := range he.lens[:lastSym+1] {
+		var w uint8
+		if n > 0 {
+			w = maxBits + 1 - n
+			rankStart[w+1] += 1 << (w - 1)
+		}
+		if uint32(sym) < lastSym {
+			he.weights = append(he.weights, w)
+		}
+	}
+
+	// Assign the codes in the same order as the decoder, where symbols with
+	// lower weights come first and ties are ordered by symbol.
+	for w := 1; w < len(rankStart)-1; w++ {
+		rankStart[w+1] += rankStart[w]
+	}
+	for sym, n := range he.lens[:lastSym+1] {
+		if n > 0 {
+			w := maxBits + 1 - n
+			he.codes[sym] = uint16(rankStart[w] >> (w - 1))
+			rankStart[w] += 1 << (w - 1)
+		}
+	}
+}
+
+// Cost returns the number of bytes needed to encode the given counts.
+func (he *huffEncoder) Cost(cnts *[256]uint32) int {
+	var bits int
+	for sym, cnt := range cnts {
+		bits += int(cnt) * int(he.lens[sym])
+	}
+	return (bits + 7) / 8
+}
+
+// WriteTable appends the Huffman tree description to out. It reports false
+// if the weights cannot be described, in which case out is unmodified.
+func (he *huffEncoder) WriteTable(out []byte) ([]byte, bool) {
+	pos := len(out)
+	if fseOut, ok := he.writeFSEWeights(out); ok {
+		if len(he.weights) > 128 || len(fseOut)-pos <= 1+(len(he.weights)+1)/2 {
+			return fseOut, true
+		}
+	}
+	if len(he.weights) > 128 {
+		return out[:pos], false
+	}
+
+	// Write the weights directly, as 4 bits each.
+	out = append(out[:pos], byte(127+len(he.weights)))
+	for i := 0; i < len(he.weights); i += 2 {
+		b := he.weights[i] << 4
+		if i+1 < len(he.weights) {
+			b |= he.weights[i+1]
+		}
+		out = append(out, b)
+	}
+	return out, true
+}
+
+// writeFSEWeights appends the weights compressed with FSE, using two
+// interleaved states that share a single table.
+func (he *huffEncoder) writeFSEWeights(out []byte) ([]byte, bool) {
+	ws := he.weights
+	if len(ws) < 2 {
+		return out, false
+	}
+	var cnts [maxHuffBits + 1]uint32
+	var maxW int
+	for _, w := range ws {
+		cnts[w]++
+		if int(w) > maxW {
+			maxW = int(w)
+		}
+	}
+	tableLog := fseTableLog(len(ws), maxW+1, maxWeightsTableLog)
+	he.norm = normalizeCounts(he.norm[:0], cnts[:maxW+1], tableLog)
+	he.fe.Init(he.norm, tableLog)
+
+	pos := len(out)
+	bw := &he.bw
+	bw.Init(append(out, 0))
+	writeNCount(bw, he.norm, tableLog)
+	out = bw.Pad()
+
+	// The decoder stops once the state of the second to last weight has no
+	// bits left to read. Thus, that state must need at least one bit.
+	n := len(ws)
+	var states [2]fseState
+	states[(n-2)%2].Init(&he.fe, ws[n-2])
+	states[(n-1)%2].Init(&he.fe, ws[n-1])
+	if he.fe.decodeBits(states[(n-2)%2].state) == 0 {
+		return out[:pos], false
+	}
+	bw.Init(out)
+	for i := n - 3; i >= 0; i-- {
+		states[i%2].Encode(bw, ws[i])
+	}
+	states[1].Flush(bw)
+	states[0].Flush(bw)
+	out = bw.Close()
+
+	if len(out)-pos-1 >= 128 {
+		return out[:pos], false
+	}
+	out[pos] = byte(len(out) - pos - 1)
+	return out, true
+}
+
+// Encode appends the Huffman coded stream of lits to out.
+func (he *huffEncoder) Encode(out []byte, lits []byte) []byte {
+	bw := &he.bw
+	bw.Init(out)
+	for i := len(lits) - 1; i >= 0; i-- {
+		c := lits[i]
+		bw.WriteBits(uint64(he.codes[c]), uint(he.lens[c]))
+	}
+	return bw.Close()
+}
@@ -0,0 +1,200 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package zstd
+
+import (
+	"encoding/binary"
+	"math/bits"
+)
+
+// levelParams contains the match finder parameters for each level.
+//
+// Every level uses the double-fast strategy of the reference library, which
+// looks up each position in a table of long (8-byte) matches and a table of
+// short (5-byte) matches. Higher levels only use larger tables and skip ahead
+// less eagerly over incompressible data.
+var levelParams = [...]struct {
+	longLog  uint // Log2 of the number of entries in the long match table
+	shortLog uint // Log2 of the number of entries in the short match table
+	strength uint // Larger values skip ahead more slowly on misses
+}{
+	BestSpeed:          {16, 14, 6},
+	2:                  {17, 15, 7},
+	DefaultCompression: {17, 16, 8},
+	4:                  {18, 16, 8},
+	5:                  {18, 17, 8},
+	6:                  {19, 17, 9},
+	7:                  {19, 18, 9},
+	8:                  {20, 18, 10},
+	BestCompression:    {20, 19, 10},
+}
+
+const (
+	prime5bytes = 889523592379
+	prime8bytes = 0xcf1bbcdcb7a56463
+)
+
+func load32(b []byte, i int) uint32 { return binary.LittleEndian.Uint32(b[i:]) }
+func load64(b []byte, i int) uint64 { return binary.LittleEndian.Uint64(b[i:]) }
+
+// matchFinder is a double-fast match finder. Positions are stored as offsets
+// into the buffer of the current segment, which is at most the size of the
+// window, such that every match found is within the window.
+type matchFinder struct {
+	longTable  []uint32
+	shortTable []uint32
+	longLog    uint
+	shortLog   uint
+	strength   uint
+	rep0, rep1 int // Last two offsets used, where zero is unknown
+}
+
+// Init clears the match finder for a new segment encoded at the given level.
+func (mf *matchFinder) Init(lvl int) {
+	p := levelParams[lvl]
+	mf.longTable = resetTable(mf.longTable, 1<<p.longLog)
+	mf.shortTable = resetTable(mf.shortTable, 1<<p.shortLog)
+	mf.longLog, mf.shortLog, mf.strength = p.longLog, p.shortLog, p.strength
+	mf.rep0, mf.rep1 = 0, 0
+}
+
+func resetTable(t []uint32, n int) []uint32 {
+	if cap(t) < n {
+		return make([]uint32, n)
+	}
+	t = t[:n]
+	for i := range t {
+		t[i] = 0
+	}
+	return t
+}
+
+// hash8 hashes all 8 bytes of v into a value with 64-shift bits.
+func hash8(v uint64, shift uint) uint32 {
+	return uint32((v * prime8bytes) >> shift)
+}
+
+// hash5 hashes the lower 5 bytes of v into a value with 64-shift bits.
+func hash5(v uint64, shift uint) uint32 {
+	return uint32(((v << 24) * prime5bytes) >> shift)
+}
+
+// Prime inserts the recent history of buf[:start] into the tables.
+// Older history is skipped since it would mostly be overwritten.
+func (mf *matchFinder) Prime(buf []byte, start int) {
+	i := start - 2<<mf.longLog
+	if i < 0 {
+		i = 0
+	}
+	for ; i < start && i+8 <= len(buf); i++ {
+		v := load64(buf, i)
+		mf.longTable[hash8(v, 64-mf.longLog)] = uint32(i)
+		mf.shortTable[hash5(v, 64-mf.shortLog)] = uint32(i)
+	}
+}
+
+// Find finds the sequences for buf[start:end], where matches may refer to any
+// data in buf[:end]. It appends the sequences to seqs and all literals,
+// including those after the last sequence, to lits.
+func (mf *matchFinder) Find(seqs []seq, lits []byte, buf []byte, start, end int) ([]seq, []byte) {
+	// Keep the state in local variables, otherwise the compiler reloads
+	// the fields after every store to the tables.
+	longTable, shortTable := mf.longTable, mf.shortTable
+	longShift, shortShift := 64-mf.longLog, 64-mf.shortLog
+	strength := mf.strength
+	rep0, rep1 := mf.rep0, mf.rep1
+
+	anchor, ip := start, start
+	if ip == 0 {
+		ip = 1 // The first byte can never be a match
+	}
+	limit := end - 8 // Allow 8-byte loads at ip+1
+	for ip < limit {
+		cur := load64(buf, ip)
+		hl, hs := hash8(cur, longShift), hash5(cur, shortShift)
+		mLong, mShort := int(longTable[hl]), int(shortTable[hs])
+		longTable[hl], shortTable[hs] = uint32(ip), uint32(ip)
+
+		var m, mLen int
+		switch {
+		case rep0 > 0 && ip+1 > rep0 && load32(buf, ip+1-rep0) == uint32(cur>>8):
+			// Check the last offset at the next position.
+			ip++
+			m = ip - rep0
+			mLen = 4 + matchLen(buf, ip+4, m+4, end)
+		case load64(buf, mLong) == cur:
+			m = mLong
+			mLen = 8 + matchLen(buf, ip+8, m+8, end)
+		case load32(buf, mShort) == uint32(cur):
+			// Prefer a long match at the next position, if any.
+			next := load64(buf, ip+1)
+			hl1 := hash8(next, longShift)
+			mNext := int(longTable[hl1])
+			longTable[hl1] = uint32(ip + 1)
+			if load64(buf, mNext) == next {
+				ip++
+				m = mNext
+				mLen = 8 + matchLen(buf, ip+8, m+8, end)
+			} else {
+				m = mShort
+				mLen = 4 + matchLen(buf, ip+4, m+4, end)
+			}
+		default:
+			ip += (ip-anchor)>>strength + 1
+			continue
+		}
+
+		// Extend the match backwards.
+		for ip > anchor && m > 0 && buf[ip-1] == buf[m-1] {
+			ip, m, mLen = ip-1, m-1, mLen+1
+		}
+		if off := ip - m; off != rep0 {
+			rep0, rep1 = off, rep0
+		}
+		seqs = append(seqs, seq{litLen: uint32(ip - anchor), matchLen: uint32(mLen), offset: uint32(rep0)})
+		lits = append(lits, buf[anchor:ip]...)
+		mStart := ip
+		ip += mLen
+		anchor = ip
+		if ip >= limit {
+			break
+		}
+
+		// Insert some positions covered by the match.
+		longTable[hash8(load64(buf, mStart+2), longShift)] = uint32(mStart + 2)
+		longTable[hash8(load64(buf, ip-2), longShift)] = uint32(ip - 2)
+		shortTable[hash5(load64(buf, ip-1), shortShift)] = uint32(ip - 1)
+
+		// Check for an immediate match using the second to last offset.
+		for ip < limit && rep1 > 0 && ip >= rep1 && load32(buf, ip-rep1) == load32(buf, ip) {
+			mLen := 4 + matchLen(buf, ip+4, ip-rep1+4, end)
+			rep0, rep1 = rep1, rep0
+			seqs = append(seqs, seq{litLen: 0, matchLen: uint32(mLen), offset: uint32(rep0)})
+			cur := load64(buf, ip)
+			longTable[hash8(cur, longShift)] = uint32(ip)
+			shortTable[hash5(cur, shortShift)] = uint32(ip)
+			ip += mLen
+			anchor = ip
+		}
+	}
+	mf.rep0, mf.rep1 = rep0, rep1
+	return seqs, append(lits, buf[anchor:end]...)
+}
+
+// matchLen returns the length of the common prefix of buf[i:end] and buf[j:],
+// where j must be less than i.
+func matchLen(buf []byte, i, j, end int) int {
+	var n int
+	for i+8 <= end {
+		if x := load64(buf, i) ^ load64(buf, j); x != 0 {
+			return n + bits.TrailingZeros64(x)/8
+		}
+		i, j, n = i+8, j+8, n+8
+	}
+	for i < end && buf[i] == buf[j] {
+		i, j, n = i+1, j+1, n+1
+	}
+	return n
+}
@@ -0,0 +1,256 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package zstd
+
+import "math"
+
+// seq is a single sequence (RFC section 3.1.1.3.2), which copies litLen bytes
+// from the literals section followed by a match of matchLen bytes located
+// offset bytes back in the output.
+type seq struct {
+	litLen   uint32
+	matchLen uint32
+	offset   uint32
+}
+
+const (
+	numLLCodes = 36
+	numMLCodes = 53
+	numOFCodes = 32
+
+	maxLLTableLog = 9
+	maxMLTableLog = 9
+	maxOFTableLog = 8
+)
+
+// Baselines and extra bits of the literal length and match length codes
+// (RFC section 3.1.1.3.2.1.1). Match lengths are stored minus minMatch.
+var (
+	llBases = [numLLCodes]uint32{
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048, 4096,
+		8192, 16384, 32768, 65536,
+	}
+	llBits = [numLLCodes]uint8{
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+		13, 14, 15, 16,
+	}
+	mlBases = [numMLCodes]uint32{
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 34, 36, 38, 40, 44, 48, 56, 64, 80, 96, 128, 256, 512, 1024, 2048,
+		4096, 8192, 16384, 32768, 65536,
+	}
+	mlBits = [numMLCodes]uint8{
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+		12, 13, 14, 15, 16,
+	}
+
+	llCodeLUT [64]uint8
+	mlCodeLUT [128]uint8
+)
+
+func init() {
+	for c := len(llBases) - 1; c >= 0; c-- {
+		for v := llBases[c]; v < uint32(len(llCodeLUT)) && llCodeLUT[v] == 0; v++ {
+			llCodeLUT[v] = uint8(c)
+		}
+	}
+	for c := len(mlBases) - 1; c >= 0; c-- {
+		for v := mlBases[c]; v < uint32(len(mlCodeLUT)) && mlCodeLUT[v] == 0; v++ {
+			mlCodeLUT[v] = uint8(c)
+		}
+	}
+}
+
+// llCode returns the literal length code for n.
+func llCode(n uint32) uint8 {
+	if n < uint32(len(llCodeLUT)) {
+		return llCodeLUT[n]
+	}
+	return uint8(highBit(n)) + 19
+}
+
+// mlCode returns the match length code for n, which excludes minMatch.
+func mlCode(n uint32) uint8 {
+	if n < uint32(len(mlCodeLUT)) {
+		return mlCodeLUT[n]
+	}
+	return uint8(highBit(n)) + 36
+}
+
+// seqEncoder encodes the sequences section of a compressed block.
+type seqEncoder struct {
+	reps [3]uint32 // Repeated offsets, where zero is an unknown offset
+
+	llCodes []uint8
+	mlCodes []uint8
+	ofCodes []uint8
+	ofVals  []uint32 // Offset value of each sequence
+
+	llEnc, mlEnc, ofEnc fseEncoder
+	norm                []int16
+	bw                  bitWriter
+}
+
+// Init resets the repeated offsets. If known is set, then the repeated
+// offsets take on their initial value at the start of a frame. Otherwise,
+// they are unknown, such that they only get used once established by
+// sequences encoded by this seqEncoder.
+func (se *seqEncoder) Init(known bool) {
+	se.reps = [3]uint32{}
+	if known {
+		se.reps = [3]uint32{1, 4, 8}
+	}
+}
+
+// offsetValue computes the Offset_Value that encodes offset for a sequence
+// with litLen literals and updates the repeated offsets accordingly
+// (RFC section 3.1.1.5).
+func (se *seqEncoder) offsetValue(offset, litLen uint32) uint32 {
+	r := &se.reps
+	if litLen > 0 {
+		switch offset {
+		case r[0]:
+			return 1
+		case r[1]:
+			r[0], r[1] = r[1], r[0]
+			return 2
+		case r[2]:
+			r[0], r[1], r[2] = r[2], r[0], r[1]
+			return 3
+		}
+	} else {
+		switch {
+		case offset == r[1]:
+			r[0], r[1] = r[1], r[0]
+			return 1
+		case offset == r[2]:
+			r[0], r[1], r[2] = r[2], r[0], r[1]
+			return 2
+		case offset == r[0]-1 && r[0] > 1:
+			r[0], r[1], r[2] = offset, r[0], r[1]
+			return 3
+		}
+	}
+	r[0], r[1], r[2] = offset, r[0], r[1]
+	return offset + 3
+}
+
+// Encode appends the sequences section for seqs to out.
+func (se *seqEncoder) Encode(out []byte, seqs []seq) []byte {
+	// Write the number of sequences.
+	switch n := len(seqs); {
+	case n < 128:
+		out = append(out, byte(n))
+	case n < 0x7f00:
+		out = append(out, byte(n>>8)+0x80, byte(n))
+	default:
+		n -= 0x7f00
+		out = append(out, 0xff, byte(n), byte(n>>8))
+	}
+	if len(seqs) == 0 {
+		return out
+	}
+
+	// Compute the codes of all sequences.
+	var llCnts [numLLCodes]uint32
+	var mlCnts [numMLCodes]uint32
+	var ofCnts [numOFCodes]uint32
+	se.llCodes, se.mlCodes = se.llCodes[:0], se.mlCodes[:0]
+	se.ofCodes, se.ofVals = se.ofCodes[:0], se.ofVals[:0]
+	for _, s := range seqs {
+		llc := llCode(s.litLen)
+		mlc := mlCode(s.matchLen - minMatch)
+		ov := se.offsetValue(s.offset, s.litLen)
+		ofc := uint8(highBit(ov))
+		llCnts[llc]++
+		mlCnts[mlc]++
+		ofCnts[ofc]++
+		se.llCodes = append(se.llCodes, llc)
+		se.mlCodes = append(se.mlCodes, mlc)
+		se.ofCodes = append(se.ofCodes, ofc)
+		se.ofVals = append(se.ofVals, ov)
+	}
+
+	// Write the compression modes and table descriptions.
+	pos := len(out)
+	out = append(out, 0)
+	var llMode, ofMode, mlMode int
+	var llEnc, ofEnc, mlEnc *fseEncoder
+	out, llMode, llEnc = se.chooseTable(out, llCnts[:], &se.llEnc, &predefLLEnc, maxLLTableLog)
+	out, ofMode, ofEnc = se.chooseTable(out, ofCnts[:], &se.ofEnc, &predefOFEnc, maxOFTableLog)
+	out, mlMode, mlEnc = se.chooseTable(out, mlCnts[:], &se.mlEnc, &predefMLEnc, maxMLTableLog)
+	out[pos] = byte(llMode<<6 | ofMode<<4 | mlMode<<2)
+
+	// Write the bitstream, where sequences are encoded in reverse order
+	// (RFC section 3.1.1.3.2.2).
+	bw := &se.bw
+	bw.Init(out)
+	last := len(seqs) - 1
+	var llState, mlState, ofState fseState
+	mlState.Init(mlEnc, se.mlCodes[last])
+	ofState.Init(ofEnc, se.ofCodes[last])
+	llState.Init(llEnc, se.llCodes[last])
+	se.writeExtraBits(seqs, last)
+	for i := last - 1; i >= 0; i-- {
+		ofState.Encode(bw, se.ofCodes[i])
+		mlState.Encode(bw, se.mlCodes[i])
+		llState.Encode(bw, se.llCodes[i])
+		se.writeExtraBits(seqs, i)
+	}
+	mlState.Flush(bw)
+	ofState.Flush(bw)
+	llState.Flush(bw)
+	return bw.Close()
+}
+
+// writeExtraBits writes the extra bits of the i-th sequence.
+func (se *seqEncoder) writeExtraBits(seqs []seq, i int) {
+	llc, mlc, ofc := se.llCodes[i], se.mlCodes[i], se.ofCodes[i]
+	se.bw.WriteBits(uint64(seqs[i].litLen-llBases[llc]), uint(llBits[llc]))
+	se.bw.WriteBits(uint64(seqs[i].matchLen-minMatch-mlBases[mlc]), uint(mlBits[mlc]))
+	se.bw.WriteBits(uint64(se.ofVals[i]), uint(ofc))
+}
+
+// chooseTable selects the compression mode for codes with the given counts,
+// using whichever of the RLE, predefined, or a newly built FSE table is
+// estimated to be the smallest. It returns the table to encode with and
+// appends any table description to out.
+func (se *seqEncoder) chooseTable(out []byte, cnts []uint32, enc, predef *fseEncoder, maxLog uint) ([]byte, int, *fseEncoder) {
+	var total, distinct, maxSym int
+	for s, c := range cnts {
+		if c > 0 {
+			total += int(c)
+			distinct++
+			maxSym = s
+		}
+	}
+	if distinct == 1 {
+		se.norm = append(se.norm[:0], make([]int16, maxSym+1)...)
+		se.norm[maxSym] = 1
+		enc.Init(se.norm, 0)
+		return append(out, byte(maxSym)), modeRLE, enc
+	}
+
+	predefCost := predef.Cost(cnts)
+	if total < 16 && !math.IsInf(predefCost, +1) {
+		return out, modePredefined, predef // Not worth building a table
+	}
+	tableLog := fseTableLog(total, maxSym+1, maxLog)
+	se.norm = normalizeCounts(se.norm[:0], cnts[:maxSym+1], tableLog)
+	enc.Init(se.norm, tableLog)
+	se.bw.Init(out)
+	writeNCount(&se.bw, se.norm, tableLog)
+	fseOut := se.bw.Pad()
+	fseCost := enc.Cost(cnts) + float64(8*(len(fseOut)-len(out)))
+	if predefCost <= fseCost {
+		return out, modePredefined, predef
+	}
+	return fseOut, modeFSE, enc
+}
@@ -0,0 +1,284 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package zstd
+
+import (
+	"encoding/binary"
+	"io"
+	"runtime"
+	"sync"
+
+	"github.com/dsnet/compress/internal/errors"
+)
+
+// The Writer produces a single frame, where the input is split into
+// fixed-size segments that are each encoded as a series of blocks. Segments
+// only depend on prior output through the window and the repeated offsets.
+// Each segment is primed with the data that precedes it, such that matches
+// may reach back into the previous segment, while repeated offsets are only
+// used once they have been established within the segment. Thus, segments
+// can be encoded concurrently and simply concatenated.
+//
+// Neither treeless literals nor repeated FSE tables are used, since they
+// would depend on the prior segment as well.
+//
+// Since segment boundaries only depend on the input, the output is identical
+// regardless of the concurrency used.
+
+const (
+	// The window must be at least primeSize+segmentSize so that every
+	// match found within a segment is a valid backward reference.
+	winLog      = 21                 // Window size used in the frame header
+	segmentSize = 1 << 20            // Uncompressed size of each segment
+	primeSize   = 1 << 20            // History available to each segment
+	maxBufSize  = primeSize + 64<<20 // Upper bound on buffered input
+)
+
+// encoderPool holds segment encoders, which are shared by all Writers since
+// their match tables are large. A Writer only holds encoders while encoding.
+var encoderPool = sync.Pool{New: func() interface{} { return new(segmentEncoder) }}
+
+type Writer struct {
+	InputOffset  int64 // Total number of bytes issued to Write
+	OutputOffset int64 // Total number of bytes written to underlying io.Writer
+
+	wr    io.Writer // Output destination
+	err   error     // Persistent error
+	level int       // The current compression level
+	conc  int       // Number of segments to encode concurrently
+	wrHdr bool      // Have we written the frame header?
+
+	buf  []byte            // History followed by pending input
+	hist int               // Number of bytes of history in buf
+	encs []*segmentEncoder // Encoders of the segments being encoded
+	xxh  xxHash64          // Checksum of the content
+}
+
+type WriterConfig struct {
+	Level int
+
+	// Concurrency is the maximum number of segments to encode in parallel.
+	// If zero, then runtime.GOMAXPROCS(0) is used.
+	Concurrency int
+
+	_ struct{} // Blank field to prevent unkeyed struct literals
+}
+
+// NewWriter creates a new Writer that compresses to w.
+//
+// Writers may be kept in a sync.Pool and reused with Reset.
+// Only the input buffer is retained between uses, since the match tables
+// are pooled and shared by all Writers.
+func NewWriter(w io.Writer, conf *WriterConfig) (*Writer, error) {
+	var lvl, conc int
+	if conf != nil {
+		lvl = conf.Level
+		conc = conf.Concurrency
+	}
+	if lvl == 0 {
+		lvl = DefaultCompression
+	}
+	if lvl < BestSpeed || lvl > BestCompression {
+		return nil, errorf(errors.Invalid, "compression level: %d", lvl)
+	}
+	if conc == 0 {
+		conc = runtime.GOMAXPROCS(0)
+	}
+	if conc < 0 {
+		return nil, errorf(errors.Invalid, "concurrency: %d", conc)
+	}
+	if primeSize+conc*segmentSize > maxBufSize {
+		conc = (maxBufSize - primeSize) / segmentSize
+	}
+	zw := new(Writer)
+	zw.level = lvl
+	zw.conc = conc
+	zw.Reset(w)
+	return zw, nil
+}
+
+func (zw *Writer) Write(buf []byte) (int, error) {
+	if zw.err != nil {
+		return 0, zw.err
+	}
+
+	cnt := len(buf)
+	zw.xxh.Write(buf)
+	for len(buf) > 0 {
+		bufSize := zw.hist + zw.conc*segmentSize
+		n := bufSize - len(zw.buf)
+		if n > len(buf) {
+			n = len(buf)
+		}
+		zw.buf = append(zw.buf, buf[:n]...)
+		buf = buf[n:]
+		if len(zw.buf) == bufSize {
+			if zw.err = zw.flush(false); zw.err != nil {
+				return 0, zw.err
+			}
+		}
+	}
+	zw.InputOffset += int64(cnt)
+	return cnt, nil
+}
+
+// flush encodes all complete segments in the buffer. If final is set, then
+// any trailing partial segment is encoded as well.
+func (zw *Writer) flush(final bool) error {
+	if !zw.wrHdr {
+		// Write the frame header (RFC section 3.1.1.1), which only specifies
+		// the window size and the presence of the content checksum.
+		var hdr [6]byte
+		binary.LittleEndian.PutUint32(hdr[:4], frameMagic)
+		hdr[4] = 1 << 2             // Frame_Header_Descriptor with Content_Checksum_flag
+		hdr[5] = (winLog - 10) << 3 // Window_Descriptor
+		if err := zw.write(hdr[:]); err != nil {
+			return err
+		}
+		zw.wrHdr = true
+	}
+
+	pending := len(zw.buf) - zw.hist
+	numSegs := pending / segmentSize
+	if final && pending%segmentSize > 0 {
+		numSegs++
+	}
+	if numSegs == 0 {
+		return nil
+	}
+
+	var wg sync.WaitGroup
+	zw.encs = zw.encs[:0]
+	for i := 0; i < numSegs; i++ {
+		segStart := zw.hist + i*segmentSize
+		segEnd := segStart + segmentSize
+		if segEnd > len(zw.buf) {
+			segEnd = len(zw.buf)
+		}
+		base := segStart - primeSize
+		if base < 0 {
+			base = 0
+		}
+		se := encoderPool.Get().(*segmentEncoder)
+		zw.encs = append(zw.encs, se)
+		buf, first := zw.buf[base:segEnd], i == 0 && zw.hist == 0
+		if numSegs == 1 {
+			se.Encode(buf, segStart-base, first, zw.level)
+			break
+		}
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			se.Encode(buf, segStart-base, first, zw.level)
+		}()
+	}
+	wg.Wait()
+
+	// Write out all segments in order.
+	var err error
+	for _, se := range zw.encs {
+		if err == nil {
+			if err = se.err; err != nil {
+				err = errWrap(err, errors.Internal)
+			} else {
+				err = zw.write(se.out)
+			}
+		}
+		encoderPool.Put(se)
+	}
+	zw.encs = zw.encs[:0]
+	if err != nil {
+		return err
+	}
+
+	// Retain the tail of the input as history for the next segment.
+	keep := primeSize
+	if keep > len(zw.buf) {
+		keep = len(zw.buf)
+	}
+	zw.buf = zw.buf[:copy(zw.buf, zw.buf[len(zw.buf)-keep:])]
+	zw.hist = keep
+	return nil
+}
+
+func (zw *Writer) write(buf []byte) error {
+	n, err := zw.wr.Write(buf)
+	zw.OutputOffset += int64(n)
+	if err != nil {
+		return errWrap(err, errors.Internal)
+	}
+	return nil
+}
+
+func (zw *Writer) Close() error {
+	if zw.err == errClosed {
+		return nil
+	}
+	if zw.err != nil {
+		return zw.err
+	}
+
+	// Encode any left-over data.
+	if zw.err = zw.flush(true); zw.err != nil {
+		return zw.err
+	}
+
+	// Write an empty last block followed by the content checksum.
+	sum := uint32(zw.xxh.Sum64())
+	trailer := [...]byte{
+		1 | blockRaw<<1, 0, 0, // Last_Block with a Block_Size of zero
+		byte(sum), byte(sum >> 8), byte(sum >> 16), byte(sum >> 24),
+	}
+	if zw.err = zw.write(trailer[:]); zw.err != nil {
+		return zw.err
+	}
+
+	zw.err = errClosed
+	return nil
+}
+
+func (zw *Writer) Reset(w io.Writer) error {
+	*zw = Writer{
+		wr:    w,
+		level: zw.level,
+		conc:  zw.conc,
+
+		buf:  zw.buf[:0],
+		encs: zw.encs[:0],
+	}
+	if zw.level == 0 {
+		zw.level = DefaultCompression
+	}
+	if zw.conc == 0 {
+		zw.conc = 1
+	}
+	zw.xxh.Reset()
+	return nil
+}
+
+// segmentEncoder encodes a single segment of the input as a series of blocks.
+type segmentEncoder struct {
+	be  blockEncoder
+	out []byte
+	err error
+}
+
+// Encode encodes buf[start:] using buf[:start] as history, where first
+// indicates that the segment starts the frame.
+func (se *segmentEncoder) Encode(buf []byte, start int, first bool, lvl int) {
+	se.err = nil
+	se.out = se.out[:0]
+	defer errors.Recover(&se.err)
+
+	se.be.Init(lvl, first)
+	se.be.mf.Prime(buf, start)
+	for pos := start; pos < len(buf); pos += maxBlockSize {
+		end := pos + maxBlockSize
+		if end > len(buf) {
+			end = len(buf)
+		}
+		se.out = se.be.Encode(se.out, buf, pos, end)
+	}
+}
@@ -0,0 +1,307 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package zstd
+
+import (
+	"bytes"
+	"io"
+	"io/ioutil"
+	"testing"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+func TestMatchFinder(t *testing.T) {
+	lf := testutil.MustLoadFile
+	rand := testutil.NewRand(0)
+	vectors := []struct {
+		desc  string
+		input []byte
+	}{
+		{"short", []byte("abcabcabcabcabcabcabc")},
+		{"zeros", lf("../testdata/zeros.bin")},
+		{"random", rand.Bytes(1 << 16)},
+		{"repeats", lf("../testdata/repeats.bin")},
+		{"twain", lf("../testdata/twain.txt")},
+		{"periodic", bytes.Repeat([]byte("abcdefghijklmnopqrstuvwxyz"), 1e4)},
+	}
+
+	for _, v := range vectors {
+		for _, lvl := range []int{BestSpeed, DefaultCompression, BestCompression} {
+			// Find the sequences for the latter half, primed with the former,
+			// and verify that they reproduce the input.
+			var mf matchFinder
+			mf.Init(lvl)
+			start := len(v.input) / 2
+			mf.Prime(v.input, start)
+			seqs, lits := mf.Find(nil, nil, v.input, start, len(v.input))
+
+			output := append([]byte(nil), v.input[:start]...)
+			for _, s := range seqs {
+				output = append(output, lits[:s.litLen]...)
+				lits = lits[s.litLen:]
+				if s.matchLen < minMatch || int(s.offset) > len(output) || s.offset == 0 {
+					t.Fatalf("test %s, level %d, invalid sequence: %+v", v.desc, lvl, s)
+				}
+				for i := 0; i < int(s.matchLen); i++ {
+					output = append(output, output[len(output)-int(s.offset)])
+				}
+			}
+			output = append(output, lits...)
+			if got, want, ok := testutil.BytesCompare(output, v.input); !ok {
+				t.Errorf("test %s, level %d, output mismatch:\ngot  %s\nwant %s", v.desc, lvl, got, want)
+			}
+		}
+	}
+}
+
+func TestDecoder(t *testing.T) {
+	// The test decoder is checked against frames produced by the C library,
+	// which use features that the Writer does not, such as content sizes,
+	// treeless literals, and repeated tables.
+	lf := testutil.MustLoadFile
+	vectors := []struct {
+		file string
+		want []byte
+	}{
+		{"testdata/binary-l19.zst", lf("../testdata/binary.bin")},
+		{"testdata/digits-l3-1e4.zst", lf("../testdata/digits.txt")[:1e4]},
+		{"testdata/random-l3-1e3.zst", lf("../testdata/random.bin")[:1e3]},
+		{"testdata/twain-l1-1e4.zst", lf("../testdata/twain.txt")[:1e4]},
+		{"testdata/twain-l19-14e4.zst", lf("../testdata/twain.txt")[:14e4]},
+		{"testdata/zeros-l3.zst", lf("../testdata/zeros.bin")},
+	}
+
+	for _, v := range vectors {
+		output, err := decodeFrames(lf(v.file))
+		if err != nil {
+			t.Errorf("test %s, unexpected decodeFrames error: %v", v.file, err)
+		}
+		if got, want, ok := testutil.BytesCompare(output, v.want); !ok {
+			t.Errorf("test %s, output mismatch:\ngot  %s\nwant %s", v.file, got, want)
+		}
+
+		// Corrupting the frame must not go unnoticed.
+		input := lf(v.file)
+		input[len(input)/2] ^= 0x55
+		if output, err := decodeFrames(input); err == nil && bytes.Equal(output, v.want) {
+			t.Errorf("test %s, corrupted frame decoded successfully", v.file)
+		}
+	}
+}
+
+func TestWriterGolden(t *testing.T) {
+	// The golden frames were verified to decode correctly with the C library.
+	// If the Writer changes its output, then the frames must be regenerated
+	// and verified again using the -zcheck flag.
+	lf := testutil.MustLoadFile
+	vectors := []struct {
+		file  string
+		input []byte
+		level int
+	}{
+		{"testdata/twain-speed-1e4.zst", lf("../testdata/twain.txt")[:1e4], BestSpeed},
+		{"testdata/digits-default-1e4.zst", lf("../testdata/digits.txt")[:1e4], DefaultCompression},
+		{"testdata/huffman-best-1e4.zst", lf("../testdata/huffman.txt")[:1e4], BestCompression},
+	}
+
+	for _, v := range vectors {
+		want := lf(v.file)
+		output := compressData(t, v.input, &WriterConfig{Level: v.level})
+		if got, want, ok := testutil.BytesCompare(output, want); !ok {
+			t.Errorf("test %s, output mismatch:\ngot  %s\nwant %s", v.file, got, want)
+		}
+		if *zcheck {
+			zd, err := cmdDecompress(want)
+			if err != nil {
+				t.Errorf("test %s, unexpected cmdDecompress error: %v", v.file, err)
+			}
+			if got, want, ok := testutil.BytesCompare(zd, v.input); !ok {
+				t.Errorf("test %s, output data mismatch:\ngot  %s\nwant %s", v.file, got, want)
+			}
+		}
+	}
+}
+
+func TestHuffmanEncoder(t *testing.T) {
+	lits := testutil.MustLoadFile("../testdata/huffman.txt")
+	var cnts [256]uint32
+	for _, c := range lits {
+		cnts[c]++
+	}
+	var he huffEncoder
+	he.Init(&cnts)
+
+	// Decode the backwards bitstream one bit at a time, where codes are read
+	// starting from their most significant bit.
+	type code struct{ val, len uint32 }
+	syms := make(map[code]byte)
+	for sym, n := range he.lens {
+		if n > 0 {
+			syms[code{uint32(he.codes[sym]), uint32(n)}] = byte(sym)
+		}
+	}
+	stream := he.Encode(nil, lits)
+	pos := 8*len(stream) - 1
+	for stream[pos/8]>>uint(pos%8) == 0 {
+		pos--
+	}
+	var output []byte
+	var c code
+	for pos--; pos >= 0; pos-- {
+		c.val = c.val<<1 | uint32(stream[pos/8]>>uint(pos%8)&1)
+		c.len++
+		if sym, ok := syms[c]; ok {
+			output = append(output, sym)
+			c = code{}
+		}
+	}
+	if c.len > 0 {
+		t.Errorf("trailing bits: %+v", c)
+	}
+	if got, want, ok := testutil.BytesCompare(output, lits); !ok {
+		t.Errorf("output mismatch:\ngot  %s\nwant %s", got, want)
+	}
+	if got, want := len(stream), he.Cost(&cnts); got < want || got > want+1 {
+		t.Errorf("stream size = %d, want %d", got, want)
+	}
+}
+
+func TestXXHash64(t *testing.T) {
+	// The expected values are the content checksums from the C library.
+	vectors := []struct {
+		input []byte
+		want  uint32
+	}{
+		{nil, 0x51d8e999},
+		{[]byte("a"), 0xa98c6e5b},
+		{[]byte("abc"), 0xad770999},
+		{[]byte("0123456789abcdef0123456789abcdef0123456789"), 0xacf08a1c},
+		{testutil.MustLoadFile("../testdata/twain.txt"), 0x1961fc1e},
+	}
+
+	for i, v := range vectors {
+		// Hash the input in uneven pieces to exercise the partial stripes.
+		var xxh xxHash64
+		xxh.Reset()
+		for b := v.input; len(b) > 0; {
+			n := 1 + len(b)%37
+			if n > len(b) {
+				n = len(b)
+			}
+			xxh.Write(b[:n])
+			b = b[n:]
+		}
+		if got := uint32(xxh.Sum64()); got != v.want {
+			t.Errorf("test %d, Sum64() = %08x, want %08x", i, got, v.want)
+		}
+	}
+}
+
+func TestWriter(t *testing.T) {
+	lf := testutil.MustLoadFile
+	rand := testutil.NewRand(0)
+	large := append(lf("../testdata/twain.txt"), rand.Bytes(1<<20)...)
+	large = append(large, bytes.Repeat(lf("../testdata/digits.txt"), 24)...)
+
+	vectors := []struct {
+		desc  string
+		input []byte
+	}{
+		{"empty", nil},
+		{"single byte", []byte("a")},
+		{"short", []byte("hello, world")},
+		{"random", lf("../testdata/random.bin")},
+		{"twain", lf("../testdata/twain.txt")},
+		{"large", large},
+	}
+
+	// The output must not depend on the concurrency or on the way that the
+	// input is written, since segment boundaries only depend on the input.
+	wr, err := NewWriter(nil, &WriterConfig{Level: BestSpeed, Concurrency: 1})
+	if err != nil {
+		t.Fatalf("unexpected NewWriter error: %v", err)
+	}
+	for _, v := range vectors {
+		want := compressData(t, v.input, &WriterConfig{Level: BestSpeed, Concurrency: 3})
+		output, err := decodeFrames(want)
+		if err != nil {
+			t.Errorf("test %s, unexpected decodeFrames error: %v", v.desc, err)
+		}
+		if got, want, ok := testutil.BytesCompare(output, v.input); !ok {
+			t.Errorf("test %s, output mismatch:\ngot  %s\nwant %s", v.desc, got, want)
+		}
+
+		var bb bytes.Buffer
+		wr.Reset(&bb)
+		for b := v.input; len(b) > 0; {
+			n := 1 + len(b)%(3<<20)
+			if n > len(b) {
+				n = len(b)
+			}
+			if _, err := wr.Write(b[:n]); err != nil {
+				t.Fatalf("test %s, unexpected Write error: %v", v.desc, err)
+			}
+			b = b[n:]
+		}
+		if err := wr.Close(); err != nil {
+			t.Fatalf("test %s, unexpected Close error: %v", v.desc, err)
+		}
+		if !bytes.Equal(bb.Bytes(), want) {
+			t.Errorf("test %s, output differs from concurrent encoding", v.desc)
+		}
+		if _, err := wr.Write([]byte("a")); err == nil {
+			t.Errorf("test %s, Write() after Close = nil, want error", v.desc)
+		}
+	}
+
+	for _, conf := range []WriterConfig{{Level: -1}, {Level: BestCompression + 1}, {Concurrency: -1}} {
+		if _, err := NewWriter(nil, &conf); err == nil {
+			t.Errorf("NewWriter(%+v) = nil, want error", conf)
+		}
+	}
+}
+
+func TestWriterZero(t *testing.T) {
+	// A zero-value Writer uses the default level without concurrency.
+	twain := testutil.MustLoadFile("../testdata/twain.txt")
+	want := compressData(t, twain, &WriterConfig{Concurrency: 1})
+	var bb bytes.Buffer
+	var zw Writer
+	zw.Reset(&bb)
+	if _, err := zw.Write(twain); err != nil {
+		t.Fatalf("unexpected Write error: %v", err)
+	}
+	if err := zw.Close(); err != nil {
+		t.Fatalf("unexpected Close error: %v", err)
+	}
+	if !bytes.Equal(bb.Bytes(), want) {
+		t.Errorf("output mismatch: got %d bytes, want %d bytes", bb.Len(), len(want))
+	}
+}
+
+func BenchmarkEncode(b *testing.B) { runBenchmarks(b, benchmarkEncode) }
+
+func benchmarkEncode(b *testing.B, data []byte, lvl int) {
+	b.StopTimer()
+	b.ReportAllocs()
+
+	br := new(bytes.Reader)
+	wr, _ := NewWriter(nil, &WriterConfig{Level: lvl})
+
+	b.SetBytes(int64(len(data)))
+	b.StartTimer()
+	for i := 0; i < b.N; i++ {
+		br.Reset(data)
+		wr.Reset(ioutil.Discard)
+		n, err := io.Copy(wr, br)
+		if n != int64(len(data)) || err != nil {
+			b.Fatalf("Copy() = (%d, %v), want (%d, nil)", n, err, len(data))
+		}
+		if err := wr.Close(); err != nil {
+			b.Fatalf("Close() = %v, want nil", err)
+		}
+	}
+}
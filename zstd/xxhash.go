@@ -0,0 +1,97 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package zstd
+
+import (
+	"encoding/binary"
+	"math/bits"
+)
+
+const (
+	xxPrime1 uint64 = 11400714785074694791
+	xxPrime2 uint64 = 14029467366897019727
+	xxPrime3 uint64 = 1609587929392839161
+	xxPrime4 uint64 = 9650029242287828579
+	xxPrime5 uint64 = 2870177450012600261
+)
+
+// xxHash64 computes the XXH64 checksum with a seed of zero, which is used
+// for the content checksum of a frame (RFC section 3.1.1).
+type xxHash64 struct {
+	v     [4]uint64 // Accumulators
+	total uint64    // Total number of bytes hashed
+	mem   [32]byte  // Partial stripe
+	n     int       // Number of bytes in mem
+}
+
+func (xh *xxHash64) Reset() {
+	p1, p2 := xxPrime1, xxPrime2 // Variables to allow overflow
+	*xh = xxHash64{v: [4]uint64{p1 + p2, p2, 0, -p1}}
+}
+
+func xxRound(acc, v uint64) uint64 {
+	return bits.RotateLeft64(acc+v*xxPrime2, 31) * xxPrime1
+}
+
+func (xh *xxHash64) stripe(b []byte) {
+	xh.v[0] = xxRound(xh.v[0], binary.LittleEndian.Uint64(b[0:]))
+	xh.v[1] = xxRound(xh.v[1], binary.LittleEndian.Uint64(b[8:]))
+	xh.v[2] = xxRound(xh.v[2], binary.LittleEndian.Uint64(b[16:]))
+	xh.v[3] = xxRound(xh.v[3], binary.LittleEndian.Uint64(b[24:]))
+}
+
+func (xh *xxHash64) Write(b []byte) {
+	xh.total += uint64(len(b))
+	if xh.n > 0 {
+		k := copy(xh.mem[xh.n:], b)
+		xh.n += k
+		b = b[k:]
+		if xh.n < len(xh.mem) {
+			return
+		}
+		xh.stripe(xh.mem[:])
+		xh.n = 0
+	}
+	for ; len(b) >= 32; b = b[32:] {
+		xh.stripe(b)
+	}
+	xh.n = copy(xh.mem[:], b)
+}
+
+func (xh *xxHash64) Sum64() uint64 {
+	var h uint64
+	if xh.total >= 32 {
+		h = bits.RotateLeft64(xh.v[0], 1) + bits.RotateLeft64(xh.v[1], 7) +
+			bits.RotateLeft64(xh.v[2], 12) + bits.RotateLeft64(xh.v[3], 18)
+		for _, v := range xh.v {
+			h = (h^xxRound(0, v))*xxPrime1 + xxPrime4
+		}
+	} else {
+		h = xh.v[2] + xxPrime5
+	}
+	h += xh.total
+
+	b := xh.mem[:xh.n]
+	for ; len(b) >= 8; b = b[8:] {
+		h ^= xxRound(0, binary.LittleEndian.Uint64(b))
+		h = bits.RotateLeft64(h, 27)*xxPrime1 + xxPrime4
+	}
+	if len(b) >= 4 {
+		h ^= uint64(binary.LittleEndian.Uint32(b)) * xxPrime1
+		h = bits.RotateLeft64(h, 23)*xxPrime2 + xxPrime3
+		b = b[4:]
+	}
+	for _, c := range b {
+		h ^= uint64(c) * xxPrime5
+		h = bits.RotateLeft64(h, 11) * xxPrime1
+	}
+
+	h ^= h >> 33
+	h *= xxPrime2
+	h ^= h >> 29
+	h *= xxPrime3
+	h ^= h >> 32
+	return h
+}
@@ -0,0 +1,160 @@
+// Copyright 2026, Joe Tsai. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE.md file.
+
+package zstd
+
+import (
+	"bytes"
+	"errors"
+	"flag"
+	"io"
+	"os/exec"
+	"strings"
+	"testing"
+
+	"github.com/dsnet/compress/internal/testutil"
+)
+
+var zcheck = flag.Bool("zcheck", false, "verify test vectors with C zstd library")
+
+func cmdDecompress(input []byte) ([]byte, error) { return cmdExec(input, "-d", "-c") }
+
+// cmdExec executes the zstd tool, passing the input in as stdin.
+// It returns the stdout and an error.
+func cmdExec(input []byte, args ...string) ([]byte, error) {
+	var bo, be bytes.Buffer
+	cmd := exec.Command("zstd", args...)
+	cmd.Stdin = bytes.NewReader(input)
+	cmd.Stdout = &bo
+	cmd.Stderr = &be
+	err := cmd.Run()
+	ss := strings.Split(strings.TrimSpace(be.String()), "\n")
+	if len(ss) > 0 && ss[len(ss)-1] != "" {
+		// Assume any stderr indicates an error and last line is the message.
+		return nil, errors.New(ss[len(ss)-1])
+	}
+	return bo.Bytes(), err
+}
+
+var testdata = []struct {
+	name  string
+	data  []byte
+	ratio float64 // The minimum expected ratio (uncompressed / compressed)
+}{
+	{"Nil", nil, 0},
+	{"Binary", testutil.MustLoadFile("../testdata/binary.bin"), 5.50},
+	{"Digits", testutil.MustLoadFile("../testdata/digits.txt"), 2.10},
+	{"Huffman", testutil.MustLoadFile("../testdata/huffman.txt"), 1.08},
+	{"Random", testutil.MustLoadFile("../testdata/random.bin"), 0.99},
+	{"Repeats", testutil.MustLoadFile("../testdata/repeats.bin"), 5.00},
+	{"Twain", testutil.MustLoadFile("../testdata/twain.txt"), 2.50},
+	{"Zeros", testutil.MustLoadFile("../testdata/zeros.bin"), 12000.0},
+}
+
+var levels = []struct {
+	name  string
+	level int
+}{
+	{"Speed", BestSpeed},
+	{"Default", DefaultCompression},
+	{"Compression", BestCompression},
+}
+
+var sizes = []struct {
+	name string
+	size int
+}{
+	{"1e4", 1e4},
+	{"1e5", 1e5},
+	{"1e6", 1e6},
+}
+
+func compressData(t testing.TB, input []byte, conf *WriterConfig) []byte {
+	var bb bytes.Buffer
+	wr, err := NewWriter(&bb, conf)
+	if err != nil {
+		t.Fatalf("NewWriter() = (_, %v), want (_, nil)", err)
+	}
+	n, err := io.Copy(wr, bytes.NewReader(input))
+	if n != int64(len(input)) || err != nil {
+		t.Errorf("Copy() = (%d, %v), want (%d, nil)", n, err, len(input))
+	}
+	if err := wr.Close(); err != nil {
+		t.Errorf("Close() = %v, want nil", err)
+	}
+	if wr.InputOffset != int64(len(input)) || wr.OutputOffset != int64(bb.Len()) {
+		t.Errorf("offsets = (%d, %d), want (%d, %d)", wr.InputOffset, wr.OutputOffset, len(input), bb.Len())
+	}
+	return bb.Bytes()
+}
+
+func TestRoundTrip(t *testing.T) {
+	for _, v := range testdata {
+		v := v
+		t.Run(v.name, func(t *testing.T) {
+			t.Parallel()
+
+			for _, lv := range levels {
+				output := compressData(t, v.data, &WriterConfig{Level: lv.level})
+
+				// Verify that the compression ratio is within expected bounds.
+				ratio := float64(len(v.data)) / float64(len(output))
+				if lv.level == DefaultCompression && ratio < v.ratio {
+					t.Errorf("%s, poor compression ratio: %0.2f < %0.2f", lv.name, ratio, v.ratio)
+				}
+
+				// Verify the frame header and the content checksum.
+				if !bytes.HasPrefix(output, []byte{0x28, 0xb5, 0x2f, 0xfd}) {
+					t.Errorf("%s, missing frame magic", lv.name)
+				}
+				var xxh xxHash64
+				xxh.Reset()
+				xxh.Write(v.data)
+				sum := uint32(xxh.Sum64())
+				if got := output[len(output)-4:]; !bytes.Equal(got, []byte{byte(sum), byte(sum >> 8), byte(sum >> 16), byte(sum >> 24)}) {
+					t.Errorf("%s, checksum mismatch: got %x, want %08x", lv.name, got, sum)
+				}
+
+				// Verify the output with the test decoder.
+				got, err := decodeFrames(output)
+				if err != nil {
+					t.Errorf("%s, unexpected decodeFrames error: %v", lv.name, err)
+				}
+				if got, want, ok := testutil.BytesCompare(got, v.data); !ok {
+					t.Errorf("%s, output data mismatch:\ngot  %s\nwant %s", lv.name, got, want)
+				}
+
+				// Verify that the C library can decompress the output of Writer.
+				if *zcheck {
+					zd, err := cmdDecompress(output)
+					if err != nil {
+						t.Errorf("%s, unexpected cmdDecompress error: %v", lv.name, err)
+					}
+					if got, want, ok := testutil.BytesCompare(zd, v.data); !ok {
+						t.Errorf("%s, output data mismatch:\ngot  %s\nwant %s", lv.name, got, want)
+					}
+				}
+			}
+		})
+	}
+}
+
+func runBenchmarks(b *testing.B, f func(b *testing.B, buf []byte, lvl int)) {
+	for _, td := range testdata {
+		if len(td.data) == 0 {
+			continue
+		}
+		if testing.Short() && !(td.name == "Twain" || td.name == "Digits") {
+			continue
+		}
+		for _, tl := range levels {
+			for _, ts := range sizes {
+				buf := testutil.ResizeData(td.data, ts.size)
+				b.Run(td.name+"/"+tl.name+"/"+ts.name, func(b *testing.B) {
+					f(b, buf, tl.level)
+				})
+			}
+		}
+	}
+}
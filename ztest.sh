@@ -19,6 +19,10 @@ echo -e "${BOLD}test${RESET}"
 RET_TEST=$(go test -race ./... | egrep -v "^(ok|[?])\s+")
 if [[ ! -z "$RET_TEST" ]]; then echo "$RET_TEST"; echo; fi
 
+echo -e "${BOLD}test (compress_unsafe)${RESET}"
+RET_UNSAFE=$(go test -race -tags compress_unsafe ./... | egrep -v "^(ok|[?])\s+")
+if [[ ! -z "$RET_UNSAFE" ]]; then echo "$RET_UNSAFE"; echo; fi
+
 echo -e "${BOLD}staticcheck${RESET}"
 RET_SCHK=$(staticcheck \
 	-ignore "
@@ -47,7 +51,7 @@ RET_LINT=$(golint ./... 2>&1 |
 	egrep -v "^exit status")
 if [[ ! -z "$RET_LINT" ]]; then echo "$RET_LINT"; echo; fi
 
-if [[ ! -z "$RET_FMT" ]] || [ ! -z "$RET_TEST" ] || [[ ! -z "$RET_SCHK" ]] || [[ ! -z "$RET_LINT" ]]; then
+if [[ ! -z "$RET_FMT" ]] || [ ! -z "$RET_TEST" ] || [ ! -z "$RET_UNSAFE" ] || [[ ! -z "$RET_SCHK" ]] || [[ ! -z "$RET_LINT" ]]; then
 	echo -e "${FAIL}${RESET}"; exit 1
 else
 	echo -e "${PASS}${RESET}"; exit 0